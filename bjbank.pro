@@ -0,0 +1,65 @@
+QT -= core gui
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = bjbank
+TEMPLATE = app
+
+INCLUDEPATH += src/cards \
+               src/game \
+               src/players \
+               src/stats \
+               src/strategies \
+               src/sim
+
+SOURCES += src/cards/card.cpp \
+           src/cards/deck.cpp \
+           src/cards/hand.cpp \
+           src/cards/MappedFile.cpp \
+           src/cards/ShoeFile.cpp \
+           src/players/counting.cpp \
+           src/players/Dealer.cpp \
+           src/players/MultiCount.cpp \
+           src/players/player.cpp \
+           src/players/PlayerActionHandler.cpp \
+           src/players/PlayerRegistry.cpp \
+           src/stats/HandHistory.cpp \
+           src/stats/LogHistogram.cpp \
+           src/stats/ShardedStats.cpp \
+           src/stats/Stats.cpp \
+           src/strategies/basicStrag.cpp \
+           src/strategies/DealerProbabilities.cpp \
+           src/strategies/EVAnalyzer.cpp \
+           src/strategies/IndexPlays.cpp \
+           src/strategies/StrategyTables.cpp \
+           src/sim/BankrollSim.cpp \
+           src/sim/RuleOptions.cpp \
+           src/sim/Simulator.cpp \
+           src/sim/bjbank.cpp
+
+HEADERS += src/cards/card.h \
+           src/cards/deck.h \
+           src/cards/hand.h \
+           src/cards/MappedFile.h \
+           src/cards/rng.h \
+           src/cards/ShoeFile.h \
+           src/game/TableRules.h \
+           src/players/counting.h \
+           src/players/Dealer.h \
+           src/players/MultiCount.h \
+           src/players/player.h \
+           src/players/PlayerActionHandler.h \
+           src/players/PlayerRegistry.h \
+           src/stats/HandHistory.h \
+           src/stats/LogHistogram.h \
+           src/stats/RunningStats.h \
+           src/stats/ShardedStats.h \
+           src/stats/Stats.h \
+           src/strategies/basicStrag.h \
+           src/strategies/DealerProbabilities.h \
+           src/strategies/EVAnalyzer.h \
+           src/strategies/IndexPlays.h \
+           src/strategies/StrategyTables.h \
+           src/sim/BankrollSim.h \
+           src/sim/RuleOptions.h \
+           src/sim/Simulator.h
@@ -0,0 +1,22 @@
+QT -= core gui
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = bjhist
+TEMPLATE = app
+
+INCLUDEPATH += src/cards \
+               src/game \
+               src/stats \
+               src/strategies \
+               src/sim
+
+SOURCES += src/cards/MappedFile.cpp \
+           src/stats/HandHistory.cpp \
+           src/sim/bjhist.cpp
+
+HEADERS += src/cards/card.h \
+           src/cards/MappedFile.h \
+           src/game/TableRules.h \
+           src/stats/HandHistory.h \
+           src/strategies/StrategyTables.h
@@ -0,0 +1,23 @@
+QT -= core gui
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = bjshoe
+TEMPLATE = app
+
+INCLUDEPATH += src/cards \
+               src/game \
+               src/sim
+
+SOURCES += src/cards/card.cpp \
+           src/cards/MappedFile.cpp \
+           src/cards/ShoeFile.cpp \
+           src/sim/RuleOptions.cpp \
+           src/sim/bjshoe.cpp
+
+HEADERS += src/cards/card.h \
+           src/cards/MappedFile.h \
+           src/cards/rng.h \
+           src/cards/ShoeFile.h \
+           src/game/TableRules.h \
+           src/sim/RuleOptions.h
@@ -0,0 +1,40 @@
+QT -= core gui
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = bjstrat
+TEMPLATE = app
+
+INCLUDEPATH += src/cards \
+               src/game \
+               src/players \
+               src/strategies \
+               src/sim
+
+SOURCES += src/cards/card.cpp \
+           src/cards/deck.cpp \
+           src/cards/hand.cpp \
+           src/cards/MappedFile.cpp \
+           src/cards/ShoeFile.cpp \
+           src/players/player.cpp \
+           src/strategies/DealerProbabilities.cpp \
+           src/strategies/EVAnalyzer.cpp \
+           src/strategies/StrategyTables.cpp \
+           src/sim/RuleOptions.cpp \
+           src/sim/StrategyGenerator.cpp \
+           src/sim/bjstrat.cpp
+
+HEADERS += src/cards/card.h \
+           src/cards/deck.h \
+           src/cards/hand.h \
+           src/cards/MappedFile.h \
+           src/cards/rng.h \
+           src/cards/ShoeFile.h \
+           src/game/TableRules.h \
+           src/players/player.h \
+           src/players/PlayerRegistry.h \
+           src/strategies/DealerProbabilities.h \
+           src/strategies/EVAnalyzer.h \
+           src/strategies/StrategyTables.h \
+           src/sim/RuleOptions.h \
+           src/sim/StrategyGenerator.h
@@ -11,13 +11,24 @@ SOURCES += basicStrag.cpp \
            cardImg.cpp \
            counting.cpp \
            Dealer.cpp \
+           DealerProbabilities.cpp \
            deck.cpp \
+           EVAnalyzer.cpp \
            GameEngine.cpp \
            hand.cpp \
+           HandHistory.cpp \
+           IndexPlays.cpp \
+           LogHistogram.cpp \
            main_qt.cpp \
+           MappedFile.cpp \
+           MultiCount.cpp \
            player.cpp \
+           PlayerActionHandler.cpp \
+           PlayerRegistry.cpp \
+           ShoeFile.cpp \
            SplitHand.cpp \
-           Stats.cpp
+           Stats.cpp \
+           StrategyTables.cpp
 
 HEADERS += basicStrag.h \
            blackjackGUI.h \
@@ -25,9 +36,23 @@ HEADERS += basicStrag.h \
            cardImg.h \
            counting.h \
            Dealer.h \
+           DealerProbabilities.h \
            deck.h \
+           EVAnalyzer.h \
            GameEngine.h \
            hand.h \
+           HandHistory.h \
+           IndexPlays.h \
+           LogHistogram.h \
+           MappedFile.h \
+           MultiCount.h \
            player.h \
+           PlayerActionHandler.h \
+           PlayerRegistry.h \
+           rng.h \
+           RunningStats.h \
+           ShoeFile.h \
            SplitHand.h \
-           Stats.h
\ No newline at end of file
+           Stats.h \
+           StrategyTables.h \
+           TableRules.h
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+// A whole file mapped read-only into memory. Readers take pointers straight
+// into the mapping, so a file larger than RAM is paged in as it is scanned
+// and several readers of one MappedFile share the same pages.
+class MappedFile {
+private:
+    std::string path;
+    const unsigned char* data;
+    size_t size;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+
+    void unmap();
+
+public:
+    // `kind` names the file in error messages ("shoe file"). Throws
+    // std::runtime_error if the file cannot be opened or mapped. An empty
+    // file maps to no data and a size of zero.
+    MappedFile(const std::string& filePath, const std::string& kind);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const std::string& getPath() const { return path; }
+    const unsigned char* getData() const { return data; }
+    size_t getSize() const { return size; }
+};
+
+#endif
@@ -0,0 +1,136 @@
+#include "ShoeFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include "rng.h"
+
+namespace {
+
+const char shoe_file_magic[4] = {'B', 'J', 'S', 'H'};
+const uint32_t shoe_file_version = 1;
+
+struct ShoeFileHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t numDecks;
+    int32_t cardsPerShoe;
+    int32_t cutCardMin;
+    int32_t cutCardMax;
+    uint64_t shoeCount;
+    uint64_t seed;
+};
+
+static_assert(sizeof(PackedCard) == 1, "shoe files store one byte per card");
+
+const size_t cut_point_bytes = sizeof(uint32_t);
+
+}
+
+ShoeFile::ShoeFile(const std::string& filePath)
+    : file(filePath, "shoe file"), numDecks(0), cardsPerShoe(0), cutCardMin(0), cutCardMax(0),
+      shoeCount(0), seed(0) {
+    const std::string& path = file.getPath();
+    size_t size = file.getSize();
+    if (size < sizeof(ShoeFileHeader)) {
+        throw std::runtime_error("Not a shoe file: " + path);
+    }
+
+    ShoeFileHeader header;
+    std::memcpy(&header, file.getData(), sizeof(header));
+
+    std::string problem;
+    if (std::memcmp(header.magic, shoe_file_magic, sizeof(header.magic)) != 0 ||
+        header.version != shoe_file_version) {
+        problem = "Not a shoe file: ";
+    } else if (header.numDecks < 1 || header.numDecks > TableRules::max_decks ||
+               header.cardsPerShoe != header.numDecks * 52 ||
+               header.cutCardMin < 0 || header.cutCardMax < header.cutCardMin ||
+               header.cutCardMax >= header.cardsPerShoe) {
+        problem = "Shoe file is damaged: ";
+    } else {
+        size_t recordSize = cut_point_bytes + static_cast<size_t>(header.cardsPerShoe);
+        if ((size - sizeof(header)) / recordSize < header.shoeCount) {
+            problem = "Shoe file is truncated: ";
+        }
+    }
+
+    if (!problem.empty()) {
+        throw std::runtime_error(problem + path);
+    }
+
+    numDecks = header.numDecks;
+    cardsPerShoe = header.cardsPerShoe;
+    cutCardMin = header.cutCardMin;
+    cutCardMax = header.cutCardMax;
+    shoeCount = header.shoeCount;
+    seed = header.seed;
+}
+
+const unsigned char* ShoeFile::record(uint64_t index) const {
+    if (index >= shoeCount) {
+        throw std::out_of_range("Shoe " + std::to_string(index) + " is past the end of " + file.getPath());
+    }
+    return file.getData() + sizeof(ShoeFileHeader) + index * (cut_point_bytes + static_cast<size_t>(cardsPerShoe));
+}
+
+const PackedCard* ShoeFile::getShoe(uint64_t index) const {
+    return reinterpret_cast<const PackedCard*>(record(index) + cut_point_bytes);
+}
+
+int ShoeFile::getCutPoint(uint64_t index) const {
+    uint32_t cutPoint;
+    std::memcpy(&cutPoint, record(index), sizeof(cutPoint));
+    return static_cast<int>(std::min<uint32_t>(cutPoint, static_cast<uint32_t>(cardsPerShoe - 1)));
+}
+
+void writeShoeFile(const std::string& path, const TableRules& rules, uint64_t shoes, uint64_t seed) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot write shoe file: " + path);
+    }
+
+    ShoeFileHeader header;
+    std::memcpy(header.magic, shoe_file_magic, sizeof(header.magic));
+    header.version = shoe_file_version;
+    header.numDecks = rules.numDecks;
+    header.cardsPerShoe = rules.totalCards();
+    header.cutCardMin = rules.cutCardMin;
+    header.cutCardMax = rules.cutCardMax;
+    header.shoeCount = shoes;
+    header.seed = seed;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // Same card order and shuffle as Deck: each shoe reshuffles the last
+    std::vector<unsigned char> shoeRecord(cut_point_bytes + static_cast<size_t>(rules.totalCards()));
+    unsigned char* cards = shoeRecord.data() + cut_point_bytes;
+    int position = 0;
+    for (int deck = 0; deck < rules.numDecks; ++deck) {
+        for (int suit = Hearts; suit <= Spades; ++suit) {
+            for (int value = 1; value <= 13; ++value) {
+                cards[position++] = PackedCard(value, static_cast<Suit>(suit)).getBits();
+            }
+        }
+    }
+
+    Rng rng(seed);
+    int cutRange = std::max(0, rules.cutCardMax - rules.cutCardMin);
+    for (uint64_t shoe = 0; shoe < shoes; ++shoe) {
+        for (int i = rules.totalCards(); i > 1; --i) {
+            int j = static_cast<int>(rng.bounded(static_cast<uint32_t>(i)));
+            std::swap(cards[i - 1], cards[j]);
+        }
+        uint32_t cutPoint = static_cast<uint32_t>(rules.cutCardMin) + rng.bounded(cutRange + 1);
+        std::memcpy(shoeRecord.data(), &cutPoint, sizeof(cutPoint));
+
+        file.write(reinterpret_cast<const char*>(shoeRecord.data()),
+                   static_cast<std::streamsize>(shoeRecord.size()));
+        if (!file) break;
+    }
+
+    if (!file) {
+        throw std::runtime_error("Failed writing shoe file: " + path);
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef SHOEFILE_H
+#define SHOEFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "card.h"
+#include "MappedFile.h"
+#include "TableRules.h"
+
+// Shoes shuffled ahead of time, so several runs can play exactly the same
+// cards. The file is a header, then for each shoe a uint32 cut point
+// (cards from the end) followed by one PackedCard byte per card.
+//
+// A ShoeFile maps the file read-only and hands out pointers straight into
+// the mapping; share one through std::shared_ptr<const ShoeFile> and every
+// Deck reading it deals from the same pages.
+class ShoeFile {
+private:
+    MappedFile file;
+    int numDecks;
+    int cardsPerShoe;
+    int cutCardMin;
+    int cutCardMax;
+    uint64_t shoeCount;
+    uint64_t seed;
+
+    const unsigned char* record(uint64_t index) const;
+
+public:
+    // Throws std::runtime_error if the file is missing, damaged or truncated
+    explicit ShoeFile(const std::string& filePath);
+
+    ShoeFile(const ShoeFile&) = delete;
+    ShoeFile& operator=(const ShoeFile&) = delete;
+
+    const std::string& getPath() const { return file.getPath(); }
+    int getNumDecks() const { return numDecks; }
+    int getCardsPerShoe() const { return cardsPerShoe; }
+    int getCutCardMin() const { return cutCardMin; }
+    int getCutCardMax() const { return cutCardMax; }
+    uint64_t getShoeCount() const { return shoeCount; }
+    uint64_t getSeed() const { return seed; }
+
+    // Shoe `index` in deal order; the pointer is valid while this ShoeFile is
+    const PackedCard* getShoe(uint64_t index) const;
+    int getCutPoint(uint64_t index) const;
+};
+
+// Shuffles `shoes` shoes for the deck count and cut card range of `rules`
+// with an Rng seeded from `seed` and writes them to `path`. Throws
+// std::runtime_error on I/O failure.
+void writeShoeFile(const std::string& path, const TableRules& rules, uint64_t shoes, uint64_t seed);
+
+#endif
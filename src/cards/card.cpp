@@ -2,18 +2,24 @@
 
 #include <iostream>
 
-Card::Card(int v, Suit s) : value(v), suit(s) {}
+Card::Card(int v, Suit s) : packed(v, s) {}
+
+Card::Card(PackedCard p) : packed(p) {}
 
 int Card::getValue() const {
-    return value;
+    return packed.getValue();
 }
 
 std::string Card::toString() const {
     static const std::string suitNames[] = { "Hearts", "Diamonds", "Clubs", "Spades" };
     static const std::string valueNames[] = { "", "A", "2", "3", "4", "5", "6", "7", "8", "9", "10", "J", "Q", "K" };
-    return valueNames[value] + " of " + suitNames[suit];
+    return valueNames[getValue()] + " of " + suitNames[getSuit()];
 }
 
 Suit Card::getSuit() const {
-    return suit;
+    return packed.getSuit();
+}
+
+PackedCard Card::getPacked() const {
+    return packed;
 }
@@ -2,17 +2,37 @@
 #define CARD_H
 
 #include <iostream>
+#include <cstdint>
 
 enum Suit {Hearts, Diamonds, Clubs, Spades};
 
+// Rank and suit packed into one byte: value (1-13) in the low four bits,
+// suit in bits 4-5. Used by the shoe and the simulation hot paths.
+class PackedCard {
+    private:
+        uint8_t bits;
+    public:
+        static const int rank_count = 10; // A, 2-9, and all ten-valued cards
+
+        constexpr PackedCard() : bits(0) {}
+        constexpr PackedCard(int v, Suit s) : bits(static_cast<uint8_t>(v | (s << 4))) {}
+
+        constexpr int getValue() const { return bits & 0x0F; }
+        constexpr Suit getSuit() const { return static_cast<Suit>(bits >> 4); }
+        // Blackjack rank: 0 = Ace, 1-8 = 2-9, 9 = 10/J/Q/K
+        constexpr int getRankIndex() const { return (getValue() > 10 ? 10 : getValue()) - 1; }
+        constexpr uint8_t getBits() const { return bits; }
+};
+
 class Card{
     private:
-        int value;
-        Suit suit;
+        PackedCard packed;
     public:
         Card(int v, Suit s);
+        Card(PackedCard p);
         int getValue() const;
         Suit getSuit() const;
+        PackedCard getPacked() const;
         std :: string toString() const;
 
 };
@@ -3,33 +3,70 @@
 #include <iostream>
 #include <algorithm>
 #include <random>
-#include <ctime>
+#include <stdexcept>
 
-Deck::Deck(){
+Deck::Deck(const TableRules& tableRules)
+    : Deck(tableRules, (static_cast<uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}()) {}
+
+Deck::Deck(uint64_t seed) : Deck(TableRules(), seed) {}
+
+Deck::Deck(const TableRules& tableRules, uint64_t seed)
+    : cursor(0), cutPoint(0), shoesBegun(0), rng(seed), listener(nullptr), notifyCardDealt(false),
+      rules(tableRules), fileCards(nullptr), nextShoe(0), shoeStep(1) {
+    buildShoe();
     resetDeck();
 }
 
+void Deck::buildShoe(){
+    shoe.clear();
+    shoe.reserve(rules.totalCards());
+    for(int deck = 0; deck < rules.numDecks; ++deck){
+        for(int suit = Hearts; suit <= Spades; ++suit){
+            for(int value = 1; value <= 13; ++value){
+                shoe.emplace_back(value, static_cast<Suit>(suit));
+            }
+        }
+    }
+}
+
 void Deck::shuffle(){
-    static std::mt19937 rng(static_cast<unsigned int>(std::time(0)));
-    std::shuffle(cards.begin(), cards.end(), rng);
+    // A file's shoes are dealt in the order they were written
+    if (fileCards) return;
+
+    // Fisher-Yates over the undealt part of the shoe
+    for (size_t i = shoe.size(); i > cursor + 1; --i) {
+        size_t j = cursor + rng.bounded(static_cast<uint32_t>(i - cursor));
+        std::swap(shoe[i - 1], shoe[j]);
+    }
 }
 
-Card Deck::dealCard(){
-    if(cards.empty()){
+PackedCard Deck::dealPacked(){
+    if(cursor >= shoe.size()){
         throw std::out_of_range("No cards left in the deck");
     }
 
-    Card dealtCard = cards.back();
-    cards.pop_back();
+    PackedCard dealtCard = fileCards ? fileCards[cursor++] : shoe[cursor++];
+    rankCounts[dealtCard.getRankIndex()]--;
+
+    if(notifyCardDealt){
+        listener->onCardDealt(Card(dealtCard), getCardsRemaining());
+    }
 
     if(isThresholdReached()){
+        if(listener){
+            listener->onCutCardReached(getCardsRemaining());
+        }
         cutDeck();
     }
     return dealtCard;
 }
 
+Card Deck::dealCard(){
+    return Card(dealPacked());
+}
+
 bool Deck::isThresholdReached() const {
-    return cards.size() <= static_cast<size_t>(cutPoint);
+    return shoe.size() - cursor <= static_cast<size_t>(cutPoint);
 }
 
 void Deck::cutDeck(){
@@ -37,23 +74,103 @@ void Deck::cutDeck(){
 }
 
 void Deck::resetDeck(){
-    cards.clear();
-    for(int deck = 0; deck < num_decks; ++deck){
-        for(int suit = Hearts; suit <= Spades; ++suit){
-            for(int value = 1; value <= 13; ++value){
-                cards.emplace_back(value, static_cast<Suit>(suit));
-            }
+    // Every card goes back in the shoe, so the composition is the full shoe again
+    cursor = 0;
+    shoesBegun++;
+    if (shoeFile) {
+        loadFileShoe();
+    } else {
+        for (int rank = 0; rank < 9; ++rank) {
+            rankCounts[rank] = 4 * rules.numDecks;
+        }
+        rankCounts[9] = 16 * rules.numDecks;
+
+        shuffle();
+        int cutRange = std::max(0, rules.cutCardMax - rules.cutCardMin);
+        cutPoint = rules.cutCardMin + static_cast<int>(rng.bounded(cutRange + 1));
+    }
+
+    if(listener){
+        listener->onShoeCreated(rules.numDecks, static_cast<int>(shoe.size()), cutPoint);
+    }
+}
+
+void Deck::loadFileShoe() {
+    const PackedCard* cards = shoeFile->getShoe(nextShoe);
+
+    // Counting the shoe checks it too; a bad byte would index past rankCounts
+    rankCounts.fill(0);
+    for (size_t i = 0; i < shoe.size(); ++i) {
+        if (cards[i].getValue() < 1 || cards[i].getValue() > 13 || cards[i].getBits() > 0x3F) {
+            throw std::runtime_error("Shoe file is damaged: " + shoeFile->getPath());
         }
+        rankCounts[cards[i].getRankIndex()]++;
+    }
+
+    fileCards = cards;
+    cutPoint = shoeFile->getCutPoint(nextShoe);
+    nextShoe = (nextShoe + shoeStep) % shoeFile->getShoeCount();
+}
+
+void Deck::useShoeFile(std::shared_ptr<const ShoeFile> file, uint64_t firstShoe, uint64_t step) {
+    if (!file || file->getShoeCount() == 0) {
+        throw std::invalid_argument("Shoe file holds no shoes");
     }
-    shuffle();
-    static std::mt19937 rng(static_cast<unsigned int>(std::time(nullptr)));
-    std::uniform_int_distribution<size_t> dist(60, 80);
-    cutPoint = dist(rng);
+    if (file->getNumDecks() != rules.numDecks) {
+        throw std::invalid_argument("Shoe file " + file->getPath() + " holds " +
+                                    std::to_string(file->getNumDecks()) + "-deck shoes, not " +
+                                    std::to_string(rules.numDecks));
+    }
+
+    uint64_t shoeCount = file->getShoeCount();
+    step = std::max<uint64_t>(1, step);
+    if (shoeCount > 1 && step % shoeCount == 0) {
+        throw std::invalid_argument("Shoe file " + file->getPath() + " holds " + std::to_string(shoeCount) +
+                                    " shoes; stepping " + std::to_string(step) +
+                                    " at a time would replay a single shoe");
+    }
+
+    shoeFile = std::move(file);
+    nextShoe = firstShoe % shoeCount;
+    shoeStep = step % shoeCount;
+    resetDeck();
+}
 
-    std::cout << "New " << num_decks << "-deck shoe created (" << total_cards << " cards). Cut point at " 
-              << cutPoint << " cards remaining.\n";
+void Deck::useGeneratedShoes() {
+    shoeFile.reset();
+    fileCards = nullptr;
+    resetDeck();
+}
+
+void Deck::matchShoe(const Deck& other) {
+    if (other.shoe.size() != shoe.size() || other.shoeFile != shoeFile) {
+        throw std::invalid_argument("Decks with different shoes cannot be matched");
+    }
+    std::copy(other.shoe.begin(), other.shoe.end(), shoe.begin());
+    cursor = other.cursor;
+    rankCounts = other.rankCounts;
+    cutPoint = other.cutPoint;
+    shoesBegun = other.shoesBegun;
+    rng = other.rng;
+    fileCards = other.fileCards;
+    nextShoe = other.nextShoe;
 }
 
 int Deck::getCardsRemaining() const {
-    return static_cast<int>(cards.size());
-}
\ No newline at end of file
+    return static_cast<int>(shoe.size() - cursor);
+}
+
+void Deck::setListener(ShoeListener* shoeListener) {
+    listener = shoeListener;
+    notifyCardDealt = listener && listener->wantsCardEvents();
+}
+
+void Deck::seed(uint64_t seed) {
+    rng.seed(seed);
+    resetDeck();
+}
+
+void Deck::setRng(const Rng& generator) {
+    rng = generator;
+    resetDeck();
+}
@@ -2,26 +2,98 @@
 #define DECK_H
 
 #include <vector>
+#include <array>
 #include <iostream>
+#include <cstdint>
+#include <memory>
 #include "card.h"
+#include "rng.h"
+#include "ShoeFile.h"
+#include "TableRules.h"
+
+// Receives shoe lifecycle events. Override only what you need. A Deck with
+// no listener skips every notification, and per-card events are only sent
+// to listeners that ask for them through wantsCardEvents().
+class ShoeListener {
+public:
+    virtual ~ShoeListener() = default;
+    virtual bool wantsCardEvents() const { return false; }
+    virtual void onShoeCreated(int /*numDecks*/, int /*totalCards*/, int /*cutPoint*/) {}
+    virtual void onCutCardReached(int /*cardsRemaining*/) {}
+    virtual void onCardDealt(const Card& /*card*/, int /*cardsRemaining*/) {}
+};
 
 class Deck {
 private:
-    std::vector<Card> cards;
+    // The shoe is built once; a reshuffle only permutes these bytes and
+    // rewinds the cursor. Cards before the cursor have been dealt.
+    std::vector<PackedCard> shoe;
+    size_t cursor;
+    std::array<int, PackedCard::rank_count> rankCounts; // undealt cards per rank
     int cutPoint; 
-    static const int num_decks = 8;
+    uint64_t shoesBegun;    // resetDeck calls, counting the first deal
+    Rng rng;
+    ShoeListener* listener;
+    bool notifyCardDealt;
+    TableRules rules;
     static const int cards_per_deck = 52;
-    static const int total_cards = num_decks * cards_per_deck;
+
+    // File mode: cards come straight from a mapped ShoeFile instead of `shoe`
+    std::shared_ptr<const ShoeFile> shoeFile;
+    const PackedCard* fileCards;
+    uint64_t nextShoe;
+    uint64_t shoeStep;
+
+    void buildShoe();
+    void loadFileShoe();
 
 public:
-    Deck();
+    // Seeded from std::random_device unless a seed is given
+    explicit Deck(const TableRules& tableRules = TableRules());
+    explicit Deck(uint64_t seed);
+    Deck(const TableRules& tableRules, uint64_t seed);
     //Deck actions below
     void shuffle();
     Card dealCard();
+    PackedCard dealPacked();         // same as dealCard without the wrapper
     bool isThresholdReached() const; 
     void cutDeck();                  
     void resetDeck();                
     int getCardsRemaining() const;
+    int getCardsDealt() const { return static_cast<int>(cursor); }
+    // Goes up by one at every reshuffle, so logs can tell shoes apart
+    uint64_t getShoeNumber() const { return shoesBegun; }
+    const TableRules& getRules() const { return rules; }
+
+    // Remaining shoe composition, indexed by PackedCard::getRankIndex()
+    const std::array<int, PackedCard::rank_count>& getRankCounts() const { return rankCounts; }
+    int getRankCount(int rankIndex) const { return rankCounts[rankIndex]; }
+
+    // Events; pass nullptr to unsubscribe. The listener must outlive the Deck
+    // or be removed first.
+    void setListener(ShoeListener* shoeListener);
+
+    // Deals shoes firstShoe, firstShoe + step, ... from `file`, wrapping
+    // at its end, with each shoe's stored cut point; the RNG is not used and
+    // shuffle() does nothing. The file's deck count must match the rules,
+    // and a step that is a multiple of a file's several shoes is refused
+    // (std::invalid_argument for both), since it would deal one shoe over
+    // and over. A shoe that does not hold real cards throws
+    // std::runtime_error when it comes up.
+    void useShoeFile(std::shared_ptr<const ShoeFile> file, uint64_t firstShoe = 0, uint64_t step = 1);
+    void useGeneratedShoes();
+    bool isFileBacked() const { return fileCards != nullptr; }
+
+    // Puts this deck at the same point of the same shoe as `other`, RNG
+    // included, so both deal the same cards from here on. Both decks must
+    // have the same rules and shoe file; the listener is left alone. For
+    // paired simulations, where copying the whole Deck would reallocate.
+    void matchShoe(const Deck& other);
+
+    // RNG control, for reproducible runs and per-thread streams
+    void seed(uint64_t seed);
+    void setRng(const Rng& generator);
+    Rng& getRng() { return rng; }
 };
 
 #endif
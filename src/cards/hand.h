@@ -1,23 +1,42 @@
 #ifndef HAND_H
 #define HAND_H
 
-#include <vector>
+#include <cstdint>
 #include "card.h"
 
+// Cards are stored inline and the totals are kept up to date as cards are
+// added, so a hand never allocates and every total query is O(1).
 class Hand {
+public:
+    // Twenty-one aces is the longest hand that has not busted (a shoe of six
+    // or more decks has that many), plus room for the card that busts it.
+    static const int max_cards = 22;
+
 private:
-    std::vector<Card> cards;
+    PackedCard cards[max_cards];
+    uint8_t cardCount;
+    uint8_t hardTotal;   // every ace counted as 1
+    bool hasAce;
+
+    void recalculateTotals();
 
 public:
     Hand();
     
     void addCard(const Card& card);
     void clearHand();
-    int getTotalValue() const;
-    bool isBlackjack() const;
-    bool isBusted() const;
+    int getTotalValue() const {
+        // One ace is worth 11 whenever that does not bust the hand
+        return hardTotal + 10 * (hasAce & (hardTotal <= 11));
+    }
+    int getHardTotal() const { return hardTotal; }
+    bool isBlackjack() const { return cardCount == 2 && getTotalValue() == 21; }
+    bool isBusted() const { return hardTotal > 21; }
+    bool isSoft() const { return hasAce && hardTotal <= 11; }
     Card getCard(int index) const;
-    size_t getCardCount() const;
+    // Unchecked, for hot paths that already know the index is valid
+    PackedCard getPackedCard(int index) const { return cards[index]; }
+    size_t getCardCount() const { return cardCount; }
     void removeCard(size_t index);
 };
 
@@ -0,0 +1,109 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+#include <limits>
+
+// xoshiro256** by Blackman and Vigna. Small, fast and seedable, with a
+// jump() that skips 2^128 draws so every simulation thread can take its own
+// non-overlapping stream from one master seed. Satisfies the standard
+// UniformRandomBitGenerator requirements, so it works with <random>.
+class Rng {
+private:
+    uint64_t state[4];
+
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    void jumpBy(const uint64_t (&polynomial)[4]) {
+        uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        for (uint64_t word : polynomial) {
+            for (int bit = 0; bit < 64; ++bit) {
+                if (word & (uint64_t(1) << bit)) {
+                    s0 ^= state[0];
+                    s1 ^= state[1];
+                    s2 ^= state[2];
+                    s3 ^= state[3];
+                }
+                next();
+            }
+        }
+        state[0] = s0;
+        state[1] = s1;
+        state[2] = s2;
+        state[3] = s3;
+    }
+
+public:
+    using result_type = uint64_t;
+
+    explicit Rng(uint64_t seedValue = 0x9E3779B97F4A7C15ULL) {
+        seed(seedValue);
+    }
+
+    // Expand a single 64-bit seed with splitmix64 so nearby seeds still give
+    // unrelated streams
+    void seed(uint64_t seedValue) {
+        for (uint64_t& word : state) {
+            seedValue += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = seedValue;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next() {
+        const uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const uint64_t t = state[1] << 17;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+
+        return result;
+    }
+
+    uint64_t operator()() { return next(); }
+
+    // Uniform value in [0, bound) without modulo bias (Lemire's method)
+    uint32_t bounded(uint32_t bound) {
+        uint64_t product = (next() >> 32) * bound;
+        uint32_t low = static_cast<uint32_t>(product);
+        if (low < bound) {
+            uint32_t threshold = static_cast<uint32_t>(-bound) % bound;
+            while (low < threshold) {
+                product = (next() >> 32) * bound;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return static_cast<uint32_t>(product >> 32);
+    }
+
+    // Equivalent to 2^128 calls to next(); use one jump per thread
+    void jump() {
+        static const uint64_t polynomial[4] = {
+            0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+            0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+        };
+        jumpBy(polynomial);
+    }
+
+    // Equivalent to 2^192 calls to next(); use to separate whole runs
+    void longJump() {
+        static const uint64_t polynomial[4] = {
+            0x76E15D3EFEFDCBBFULL, 0xC5004E441C522FB3ULL,
+            0x77710069854EE241ULL, 0x39109BB02ACBE635ULL
+        };
+        jumpBy(polynomial);
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+};
+
+#endif
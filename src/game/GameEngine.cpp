@@ -1,27 +1,36 @@
 #include "GameEngine.h"
 #include <iostream>
 #include <iomanip>
-#include <cctype>
 
 GameEngine::GameEngine(Deck& gameDeck) 
-    : deck(gameDeck), dealer(), currentState(GameState::SETUP), 
-      currentPlayerIndex(0), actionHandler(nullptr), display(nullptr) {
+    : deck(gameDeck), rules(gameDeck.getRules()), dealer(rules), currentState(GameState::SETUP), 
+      currentPlayerIndex(0), roundTrueCount(0.0), roundCounted(false), actionHandler(nullptr),
+      display(nullptr), playerRegistry(std::make_shared<PlayerRegistry>()), handHistory(nullptr),
+      historyRounds(0) {
     
-    // Initialize split manager with smart pointer
-    splitManager = std::make_unique<SplitHand>(players, deck, 4);
+    // Initialize split manager with smart pointer; the table plays by the shoe's rules
+    splitManager = std::make_unique<SplitHand>(players, deck, rules);
 
     countingSystem = std::make_unique<Counting>(&deck);
-    basicStrategy = std::make_unique<BasicStrat>();
+    splitManager->setCounting(countingSystem.get());
+    splitManager->setListener(this);
+    basicStrategy = std::make_unique<BasicStrat>(rules);
+
+    gameStats.usePlayerRegistry(playerRegistry);
+    countingSystem->usePlayerRegistry(playerRegistry);
+    basicStrategy->usePlayerRegistry(playerRegistry);
 }
 
 void GameEngine::addPlayer(const std::string& playerName) {
     players.emplace_back(playerName);
+    players.back().setId(playerRegistry->intern(playerName));
     std::cout << "Added player: " << playerName << std::endl;
 }
 
 void GameEngine::startNewGame() {
     // Clear previous game state
     playerHasSurrendered.clear();
+    playerHasDoubled.clear();
     currentState = GameState::SETUP;
     currentPlayerIndex = 0;
     
@@ -31,6 +40,7 @@ void GameEngine::startNewGame() {
     }
     dealer.clearHand();
     dealer.resetForNewGame();
+    splitManager->clearSplitHands();
     
     if (deck.isThresholdReached()) {
         std::cout << "Note: Cut card has been reached. This will be the last hand before reshuffle." << std::endl;
@@ -42,6 +52,13 @@ void GameEngine::startNewGame() {
 
 void GameEngine::dealInitialCards() {
     currentState = GameState::DEALING;
+
+    // Results are bucketed by the count the round was bet at
+    roundCounted = countingSystem && countingSystem->isCountingEnabled();
+    roundTrueCount = roundCounted ? countingSystem->getTrueCount() : 0.0;
+    if (handHistory) {
+        beginHistoryRound();
+    }
     
     // Deal two cards to each player and update count
     for (auto& player : players) {
@@ -83,60 +100,46 @@ void GameEngine::playPlayerTurn(int playerIndex) {
         return;
     }
 
+    PlayerActionHandler& handler = actionHandler ? *actionHandler : consoleHandler;
     bool playerTurnActive = true;
     bool firstTurn = true;
     
     while (!player.isBusted() && playerTurnActive) {
         bool canDouble = (firstTurn && player.getCardCount() == 2);
-        bool canSurrender = (firstTurn && player.getCardCount() == 2);
+        bool canSurrender = (rules.lateSurrender && firstTurn && player.getCardCount() == 2);
         bool canSplit = (firstTurn && canPlayerSplit(playerIndex));
 
-        std::cout << "\nChoose action: (h)it, (s)tand";
-        if(canDouble) std::cout << ", (d)ouble down";
-        if(canSurrender) std::cout << ", s(u)rrender";
-        if(canSplit) std::cout << ", s(p)lit";
-        std::cout << ": ";
+        Action action = handler.decide(player, dealer, canDouble, canSplit, canSurrender);
 
-        char choice;
-        std::cin >> choice;
-        choice = std::tolower(choice);
-
-        if (choice == 'h') {
-            if (!playerHit(playerIndex)) {
+        switch (legalAction(action, canDouble, canSplit, canSurrender)) {
+            case Action::HIT:
+                playerHit(playerIndex);
                 displayPlayerHand(player);
-                playerTurnActive = false;
-            }else{
+                firstTurn = false;
+                break;
+                
+            case Action::DOUBLE:
+                playerDoublesDown(playerIndex);
                 displayPlayerHand(player);
-            }
-            firstTurn = false;
-            
-        } else if (choice == 's') {
-            playerStand(playerIndex);
-            playerTurnActive = false;
-            
-        } else if (choice == 'd' && canDouble) {
-            if (!playerDoublesDown(playerIndex)) {
-                // Player busted after doubling
-            }
-            displayPlayerHand(player);
-            playerTurnActive = false;
-            
-        } else if (choice == 'u' && canSurrender) {
-            if (playerSurrenders(playerIndex)) {
                 playerTurnActive = false;
-            }
-            
-        } else if (choice == 'p' && canSplit) {
-            if (playerSplits(playerIndex)) {
-                playerTurnActive = false;  // Split hands are handled in playerSplits()
-            }
-            
-        } else {
-            std::cout << "Invalid choice. Available options: h, s";
-            if (canDouble) std::cout << ", d";
-            if (canSurrender) std::cout << ", u";
-            if (canSplit) std::cout << ", p";
-            std::cout << std::endl;
+                break;
+                
+            case Action::SURRENDER:
+                playerSurrenders(playerIndex);
+                playerTurnActive = false;
+                break;
+                
+            case Action::SPLIT:
+                if (playerSplits(playerIndex)) {
+                    splitManager->playSplitHands(playerIndex, handler, dealer);
+                }
+                playerTurnActive = false;
+                break;
+                
+            default:
+                playerStand(playerIndex);
+                playerTurnActive = false;
+                break;
         }
     }
 }
@@ -164,7 +167,7 @@ void GameEngine::playDealerTurn() {
     std::cout << "\nDealer reveals hole card:" << std::endl;
     displayDealerHand(true);
     
-    // Dealer hits until 17 or higher
+    // Dealer hits until 17 or higher (and on soft 17 under H17)
     while (dealer.shouldHit()) {
         std::cout << "\nDealer hits..." << std::endl;
         Card newCard = deck.dealCard();
@@ -213,11 +216,9 @@ bool GameEngine::playerSplits(int playerIndex) {
     Player& player = players[playerIndex];
     
     // Record the strategy decision
-    if (basicStrategy) {
-        Action takenAction = Action::SPLIT;
-        basicStrategy->recordPlayerAction(player.getName(), player, dealer, 
-                                        takenAction, true, true);
-    }
+    bool firstDecision = player.getCardCount() == 2;
+    recordStrategyDecision(playerIndex, Action::SPLIT, firstDecision, rules.lateSurrender && firstDecision,
+                           canPlayerSplit(playerIndex));
     
     return splitManager->playerSplits(playerIndex);
 }
@@ -226,12 +227,10 @@ bool GameEngine::playerHit(int playerIndex) {
     if (playerIndex >= 0 && playerIndex < static_cast<int>(players.size())) {
         Player& player = players[playerIndex];
         
-        // Record the strategy decision if basic strategy is enabled
-        if (basicStrategy) {
-            Action takenAction = Action::HIT;
-            basicStrategy->recordPlayerAction(player.getName(), player, dealer, 
-                                            takenAction, true, true);
-        }
+        // Record the strategy decision
+        bool firstDecision = player.getCardCount() == 2;
+        recordStrategyDecision(playerIndex, Action::HIT, firstDecision, rules.lateSurrender && firstDecision,
+                               canPlayerSplit(playerIndex));
         
         Card newCard = deck.dealCard();
         player.addCard(newCard);
@@ -252,11 +251,9 @@ bool GameEngine::playerStand(int playerIndex) {
         Player& player = players[playerIndex];
         
         // Record the strategy decision
-        if (basicStrategy) {
-            Action takenAction = Action::STAND;
-            basicStrategy->recordPlayerAction(player.getName(), player, dealer, 
-                                            takenAction, true, true);
-        }
+        bool firstDecision = player.getCardCount() == 2;
+        recordStrategyDecision(playerIndex, Action::STAND, firstDecision, rules.lateSurrender && firstDecision,
+                               canPlayerSplit(playerIndex));
         return true;
     }
     return false;
@@ -267,11 +264,10 @@ bool GameEngine::playerDoublesDown(int playerIndex) {
         Player& player = players[playerIndex];
         
         // Record the strategy decision
-        if (basicStrategy) {
-            Action takenAction = Action::DOUBLE;
-            basicStrategy->recordPlayerAction(player.getName(), player, dealer, 
-                                            takenAction, true, true);
-        }
+        bool firstDecision = player.getCardCount() == 2;
+        recordStrategyDecision(playerIndex, Action::DOUBLE, firstDecision, rules.lateSurrender && firstDecision,
+                               canPlayerSplit(playerIndex));
+        playerHasDoubled[playerIndex] = true;
         
         Card newCard = deck.dealCard();
         player.addCard(newCard);
@@ -301,19 +297,44 @@ bool GameEngine::playerSurrenders(int playerIndex) {
     }
     
     Player& player = players[playerIndex];
+
+    if (!rules.lateSurrender) {
+        std::cout << "Surrender is not offered at this table." << std::endl;
+        return false;
+    }
     
     // Record the strategy decision
-    if (basicStrategy) {
-        Action takenAction = Action::SURRENDER;
-        basicStrategy->recordPlayerAction(player.getName(), player, dealer, 
-                                        takenAction, true, true);
-    }
+    bool firstDecision = player.getCardCount() == 2;
+    recordStrategyDecision(playerIndex, Action::SURRENDER, firstDecision, rules.lateSurrender && firstDecision,
+                           canPlayerSplit(playerIndex));
     
     std::cout << player.getName() << " surrenders and loses half their bet." << std::endl;
     playerHasSurrendered[playerIndex] = true;
     return true;
 }
 
+bool GameEngine::playerHitsSplitHand(int playerIndex, int handIndex) {
+    if (playerIndex < 0 || playerIndex >= static_cast<int>(players.size())) {
+        return false;
+    }
+    return splitManager->hitSplitHand(playerIndex, handIndex);
+}
+
+bool GameEngine::playerDoublesDownSplitHand(int playerIndex, int handIndex) {
+    if (playerIndex < 0 || playerIndex >= static_cast<int>(players.size()) ||
+        !splitManager->playerDoublesDownSplit(playerIndex, handIndex)) {
+        return false;
+    }
+    return !splitManager->getPlayerSplitHands().at(playerIndex)[handIndex].isBusted();
+}
+
+bool GameEngine::playerStandsSplitHand(int playerIndex, int handIndex) {
+    if (playerIndex < 0 || playerIndex >= static_cast<int>(players.size())) {
+        return false;
+    }
+    return splitManager->standSplitHand(playerIndex, handIndex);
+}
+
 void GameEngine::displayPlayerHand(const Player& player) const {
     std::cout << player.getName() << "'s hand: ";
     
@@ -410,62 +431,148 @@ void GameEngine::displayResults() const {
 }
 
 void GameEngine::updateGameStats() {
+    roundUnitsWon.assign(players.size(), 0.0);
     for (size_t i = 0; i < players.size(); ++i) {
         const Player& player = players[i];
-        std::string playerName = player.getName();
+        PlayerId playerId = player.getId();
+        double unitsWon = 0.0;
+        double unitsWagered = 1.0;
+        bool blackjackPaid = false;
+        bool surrendered = false;
         
         // Check if player surrendered first
         if (playerHasSurrendered.find(i) != playerHasSurrendered.end() && 
             playerHasSurrendered.at(i)) {
-            gameStats.updatePlayerStats(playerName, GameResult::LOSS);
-            continue;
-        }
-        
-        // Check if this player has split hands
-        if (splitManager->getPlayerSplitHands().find(i) != splitManager->getPlayerSplitHands().end()) {
-            // Handle split hands
+            gameStats.updatePlayerStats(playerId, GameResult::SURRENDER);
+            unitsWon = -0.5;
+            surrendered = true;
+            if (handHistory) historyRecords[i].addHand(player, 1, unitsWon);
+        } else if (splitManager->getPlayerSplitHands().find(i) != splitManager->getPlayerSplitHands().end()) {
+            // Handle split hands; each carries its own bet, doubled or not
             auto& splitHands = splitManager->getPlayerSplitHands().at(i);
+            unitsWagered = 0.0;
             
             for (size_t handIndex = 0; handIndex < splitHands.size(); ++handIndex) {
                 const auto& hand = splitHands[handIndex];
+                int bet = hand.getBetMultiplier();
+                GameResult result;
                 
+                // A split 21 is not a blackjack; it only beats a lower total
                 if (hand.isBusted()) {
-                    gameStats.updatePlayerStats(playerName, GameResult::LOSS);
-                } else if (hand.is21() && !dealer.isBlackjack()) {
-                    gameStats.updatePlayerStats(playerName, GameResult::WIN);
+                    result = GameResult::LOSS;
                 } else if (dealer.isBusted()) {
-                    gameStats.updatePlayerStats(playerName, GameResult::WIN);
-                } else if (hand.is21() && dealer.isBlackjack()) {
-                    gameStats.updatePlayerStats(playerName, GameResult::PUSH);
+                    result = GameResult::WIN;
                 } else if (hand.getTotalValue() > dealer.getTotalValue()) {
-                    gameStats.updatePlayerStats(playerName, GameResult::WIN);
+                    result = GameResult::WIN;
                 } else if (hand.getTotalValue() < dealer.getTotalValue()) {
-                    gameStats.updatePlayerStats(playerName, GameResult::LOSS);
+                    result = GameResult::LOSS;
                 } else {
-                    gameStats.updatePlayerStats(playerName, GameResult::PUSH);
+                    result = GameResult::PUSH;
                 }
+                
+                gameStats.updatePlayerStats(playerId, result);
+                unitsWagered += bet;
+                double handNet = result == GameResult::WIN ? bet : (result == GameResult::LOSS ? -bet : 0.0);
+                unitsWon += handNet;
+                if (handHistory) historyRecords[i].addHand(hand.cards, bet, handNet);
             }
         } else {
             // Handle regular (non-split) hands
+            int bet = (playerHasDoubled.find(i) != playerHasDoubled.end() && playerHasDoubled.at(i)) ? 2 : 1;
+            GameResult result;
+            
             if (player.isBusted()) {
-                gameStats.updatePlayerStats(playerName, GameResult::LOSS);
+                result = GameResult::LOSS;
             } else if (player.isBlackjack() && !dealer.isBlackjack()) {
-                gameStats.updatePlayerStats(playerName, GameResult::BLACKJACK);
+                result = GameResult::BLACKJACK;
             } else if (dealer.isBusted()) {
-                gameStats.updatePlayerStats(playerName, GameResult::WIN);
+                result = GameResult::WIN;
             } else if (player.isBlackjack() && dealer.isBlackjack()) {
-                gameStats.updatePlayerStats(playerName, GameResult::PUSH);
+                result = GameResult::PUSH;
             } else if (player.getTotalValue() > dealer.getTotalValue()) {
-                gameStats.updatePlayerStats(playerName, GameResult::WIN);
+                result = GameResult::WIN;
             } else if (player.getTotalValue() < dealer.getTotalValue()) {
-                gameStats.updatePlayerStats(playerName, GameResult::LOSS);
+                result = GameResult::LOSS;
             } else {
-                gameStats.updatePlayerStats(playerName, GameResult::PUSH);
+                result = GameResult::PUSH;
             }
+            
+            gameStats.updatePlayerStats(playerId, result);
+            unitsWagered = bet;
+            if (result == GameResult::BLACKJACK) unitsWon = rules.blackjackPayout;
+            if (result == GameResult::WIN) unitsWon = bet;
+            if (result == GameResult::LOSS) unitsWon = -bet;
+            blackjackPaid = result == GameResult::BLACKJACK;
+            if (handHistory) historyRecords[i].addHand(player, bet, unitsWon);
+        }
+        
+        roundUnitsWon[i] = unitsWon;
+        recordRoundResult(playerId, unitsWon, unitsWagered);
+        if (handHistory) {
+            endHistoryRound(i, unitsWon, unitsWagered, blackjackPaid, surrendered);
         }
     }
 }
 
+void GameEngine::beginHistoryRound() {
+    historyRounds++;
+    historyRecords.resize(players.size());
+    for (size_t i = 0; i < players.size(); ++i) {
+        HandRecord& record = historyRecords[i];
+        record.clear();
+        record.seat = static_cast<uint8_t>(i);
+        record.shoe = deck.getShoeNumber();
+        record.round = historyRounds;
+        record.shoePosition = deck.getCardsDealt();
+        record.counted = roundCounted;
+        record.trueCount = roundTrueCount;
+    }
+}
+
+void GameEngine::endHistoryRound(size_t playerIndex, double unitsWon, double unitsWagered, bool blackjackPaid,
+                                 bool surrendered) {
+    // A round dealt before the log was set has no staged record
+    if (playerIndex >= historyRecords.size()) return;
+
+    HandRecord& record = historyRecords[playerIndex];
+    record.dealerBlackjack = dealer.isBlackjack();
+    record.surrendered = surrendered;
+    record.blackjackPaid = blackjackPaid;
+    record.wagered = unitsWagered;
+    record.net = unitsWon;
+    record.setDealer(dealer);
+    handHistory->append(record);
+}
+
+void GameEngine::onSplitHandDecision(int playerIndex, int handIndex, const Hand& cards, Action action) {
+    if (!handHistory || playerIndex >= static_cast<int>(historyRecords.size())) return;
+
+    HandRecord& record = historyRecords[playerIndex];
+    record.addDecision(handIndex, cards, action);
+    if (action == Action::SPLIT) {
+        record.insertHand(handIndex);
+    }
+}
+
+void GameEngine::recordRoundResult(const std::string& playerName, double unitsWon, double unitsWagered) {
+    recordRoundResult(playerRegistry->intern(playerName), unitsWon, unitsWagered);
+}
+
+void GameEngine::recordRoundResult(PlayerId id, double unitsWon, double unitsWagered) {
+    if (roundCounted) {
+        gameStats.recordRound(id, unitsWon, unitsWagered, roundTrueCount);
+    } else {
+        gameStats.recordRound(id, unitsWon, unitsWagered);
+    }
+}
+
+double GameEngine::getRoundUnitsWon(int playerIndex) const {
+    if (playerIndex < 0 || playerIndex >= static_cast<int>(roundUnitsWon.size())) {
+        return 0.0;
+    }
+    return roundUnitsWon[playerIndex];
+}
+
 void GameEngine::playGame() {
     if (players.empty()) {
         std::cout << "No players added to the game!" << std::endl;
@@ -540,6 +647,45 @@ bool GameEngine::isDeckReshuffleNeeded() const {
     return deck.isThresholdReached();
 }
 
+ShoeComposition GameEngine::getUnseenComposition() const {
+    ShoeComposition unseen = deck.getRankCounts();
+
+    // The hole card has left the shoe but nobody at the table has seen it
+    if (dealer.getCardCount() >= 2 && !dealer.isHoleCardRevealed()) {
+        unseen[dealer.getHoleCard().getPacked().getRankIndex()]++;
+    }
+    return unseen;
+}
+
+void GameEngine::recordStrategyDecision(int playerIndex, Action takenAction, bool canDouble,
+                                        bool canSurrender, bool canSplit) {
+    const Player& player = players[playerIndex];
+    if (handHistory && playerIndex < static_cast<int>(historyRecords.size())) {
+        historyRecords[playerIndex].addDecision(0, player, takenAction);
+    }
+
+    if (!basicStrategy) return;
+
+    ShoeComposition unseen = getUnseenComposition();
+
+    // A counting player is graded against the index plays as well
+    if (countingSystem && countingSystem->isCountingEnabled()) {
+        basicStrategy->recordPlayerAction(player.getId(), player, dealer, takenAction, canDouble,
+                                          canSurrender, canSplit, &unseen, &getIndexTable(),
+                                          countingSystem->getTrueCount());
+    } else {
+        basicStrategy->recordPlayerAction(player.getId(), player, dealer, takenAction, canDouble,
+                                          canSurrender, canSplit, &unseen);
+    }
+}
+
+const IndexTable& GameEngine::getIndexTable() const {
+    if (basicStrategy) {
+        return basicStrategy->getIndexTable(static_cast<int>(countingSystem->getCurrentSystem()));
+    }
+    return countingSystem->getIndexTable();
+}
+
 // Statistics methods
 void GameEngine::displayGameStats() const {
     gameStats.displayFinalResults(countingSystem.get(), basicStrategy.get());
@@ -9,9 +9,12 @@
 #include "player.h"
 #include "Dealer.h"
 #include "Stats.h"
+#include "HandHistory.h"
 #include "SplitHand.h"
 #include "counting.h"
 #include "basicStrag.h"
+#include "PlayerActionHandler.h"
+#include "TableRules.h"
 
 enum class GameState {
     SETUP,
@@ -22,33 +25,58 @@ enum class GameState {
 };
 
 // Forward declarations for classes that are only used as pointers
-class PlayerActionHandler;
 class GameDisp;
 
-class GameEngine {
+class GameEngine : private SplitHandListener {
 private:
     Deck& deck;
+    TableRules rules;
     Dealer dealer;
     std::vector<Player> players;
     GameState currentState;
     int currentPlayerIndex;
     std::map<int, bool> playerHasSurrendered;
+    std::map<int, bool> playerHasDoubled;
+    double roundTrueCount;      // at the deal, for the per-count results
+    bool roundCounted;
+    std::vector<double> roundUnitsWon;     // per seat, from the last updateGameStats
     
     std::unique_ptr<SplitHand> splitManager;
     
     PlayerActionHandler* actionHandler;
+    ConsoleActionHandler consoleHandler;   // asks at the console when no handler is set
     GameDisp* display;
     
+    // Seated names, shared with the stats, counting and strategy trackers
+    // so every per-hand record is indexed by the player's ID
+    std::shared_ptr<PlayerRegistry> playerRegistry;
     Stats gameStats;
 
     std::unique_ptr<Counting> countingSystem;
     std::unique_ptr<BasicStrat> basicStrategy;
 
+    // Round log; one staged record per seat while a round is played
+    HandHistoryRecorder* handHistory;
+    std::vector<HandRecord> historyRecords;
+    uint64_t historyRounds;
+
+    // Grades and logs a decision on a seat's main hand. The flags are what
+    // the seat was offered; the main hand's first decision is the one made
+    // on its two dealt cards.
+    void recordStrategyDecision(int playerIndex, Action takenAction, bool canDouble, bool canSurrender,
+                                bool canSplit);
+    void beginHistoryRound();
+    void endHistoryRound(size_t playerIndex, double unitsWon, double unitsWagered, bool blackjackPaid,
+                         bool surrendered);
+    // Logs decisions SplitHand makes on split hands under their own index
+    void onSplitHandDecision(int playerIndex, int handIndex, const Hand& cards, Action action) override;
+
 public:
     GameEngine(Deck& gameDeck);
     ~GameEngine() = default;  
     
-    // Game Setup
+    // Game Setup. A player keeps the ID interned here across
+    // clearPlayers(), so a returning name resumes its statistics.
     void addPlayer(const std::string& playerName);
     void startNewGame();
     void clearPlayers();
@@ -70,6 +98,7 @@ public:
     bool isGameOver() const;
     int getCurrentPlayerIndex() const;
     bool isDeckReshuffleNeeded() const;
+    ShoeComposition getUnseenComposition() const;  // undealt cards plus the dealer's hole card
     
     // Player actions
     bool canPlayerSplit(int playerIndex);
@@ -79,8 +108,22 @@ public:
     bool playerDoublesDown(int playerIndex);
     bool playerSurrenders(int playerIndex);
     
+    // One action on a hand made by playerSplits, for callers that play
+    // split hands themselves (the GUI). The first two return false if the
+    // hand busts, and all three if the action is not allowed.
+    bool playerHitsSplitHand(int playerIndex, int handIndex);
+    bool playerDoublesDownSplitHand(int playerIndex, int handIndex);
+    bool playerStandsSplitHand(int playerIndex, int handIndex);
+    
     // Statistics methods
     void updateGameStats();
+    // Money result of a round settled by the caller (the GUI), filed under
+    // the true count the round was dealt at
+    void recordRoundResult(const std::string& playerName, double unitsWon, double unitsWagered);
+    void recordRoundResult(PlayerId id, double unitsWon, double unitsWagered);
+    // Units a seat won in the round updateGameStats last settled, all of
+    // its split hands together; 0 before the first
+    double getRoundUnitsWon(int playerIndex) const;
     void displayGameStats() const;
     void resetGameStats();
     
@@ -89,17 +132,30 @@ public:
     const Stats* getGameStats() const { return &gameStats; }
     SplitHand* getSplitManager() const { return splitManager.get(); }
     
+    // playGame asks this handler for every decision, split hands included;
+    // nullptr asks at the console
     void setActionHandler(PlayerActionHandler* handler) { actionHandler = handler; }
     void setDisplay(GameDisp* disp) { display = disp; }
 
+    // Logs every round updateGameStats settles to `recorder`, one record
+    // per seat with every decision, split hands included; nullptr stops it.
+    void setHandHistory(HandHistoryRecorder* recorder) {
+        handHistory = recorder;
+        historyRecords.clear();
+    }
+
     Counting* getCountingSystem() const { return countingSystem.get(); }
     BasicStrat* getBasicStrategy() const { return basicStrategy.get(); }
     void enableCounting(bool enabled);
     void enableBasicStrategy(bool enabled);
     void setCountingSystem(CountingSystem system);
+    // Index plays for the current counting system, loaded or built in
+    const IndexTable& getIndexTable() const;
 
+    const TableRules& getRules() const { return rules; }
     const Dealer& getDealer() const { return dealer; }
     const std::vector<Player>& getPlayers() const { return players; }
+    const PlayerRegistry& getPlayerRegistry() const { return *playerRegistry; }
 };
 
 #endif
\ No newline at end of file
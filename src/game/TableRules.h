@@ -0,0 +1,50 @@
+#ifndef TABLERULES_H
+#define TABLERULES_H
+
+#include <string>
+
+// Every house rule the table plays by. A Deck is built from a TableRules and
+// GameEngine, Dealer, SplitHand, BasicStrat and the simulator all read the
+// same copy, so a rule set can be swapped at runtime without recompiling.
+// The defaults are the table this game has always dealt.
+struct TableRules {
+    // Eight decks is the largest shoe dealt; the count tables and the hand
+    // history's 16-bit shoe positions are sized for it
+    static constexpr int max_decks = 8;
+    // Splits are capped well inside the byte-wide hand counters of the batch
+    // kernel and the hand history, which also keeps a round's decisions
+    // under the hand history's 255
+    static constexpr int max_split_hands = 16;
+
+    int numDecks;
+    int cutCardMin;          // cut card sits between cutCardMin and cutCardMax
+    int cutCardMax;          // cards from the end of the shoe
+    bool dealerHitsSoft17;   // H17 when true, S17 when false
+    bool doubleAfterSplit;   // DAS
+    bool resplitAces;        // RSA
+    int maxSplitHands;       // most hands one seat can split into
+    bool lateSurrender;      // surrender after the dealer checks for blackjack
+    double blackjackPayout;  // 1.5 for 3:2, 1.2 for 6:5
+
+    TableRules() : numDecks(8), cutCardMin(60), cutCardMax(80), dealerHitsSoft17(false),
+                   doubleAfterSplit(true), resplitAces(false), maxSplitHands(4),
+                   lateSurrender(true), blackjackPayout(1.5) {}
+
+    int totalCards() const { return numDecks * 52; }
+
+    // Short form such as "8D S17 DAS NRSA LS 3:2"
+    std::string describe() const {
+        std::string text = std::to_string(numDecks) + "D ";
+        text += dealerHitsSoft17 ? "H17" : "S17";
+        text += doubleAfterSplit ? " DAS" : " NDAS";
+        text += resplitAces ? " RSA" : " NRSA";
+        if (lateSurrender) text += " LS";
+        if (blackjackPayout == 1.5) text += " 3:2";
+        else if (blackjackPayout == 1.2) text += " 6:5";
+        else if (blackjackPayout == 1.0) text += " 1:1";
+        else text += " BJ pays " + std::to_string(blackjackPayout);
+        return text;
+    }
+};
+
+#endif
@@ -17,11 +17,14 @@ BlackjackGUI::BlackjackGUI(QWidget *parent)
     cardImageManager = new CardImageManager(cardImagePath, 80, 112);
 
     setupUI();
-
-
-    logMessage("🃏 NEW 8-DECK SHOE INITIALIZED");
-    logMessage(QString("📚 Starting with %1 cards (8 decks × 52 cards)").arg(gameDeck->getCardsRemaining()));
-    logMessage("🔄 Shuffle point: ~60-80 cards remaining");
+    gameDeck->setListener(this);
+
+    const TableRules& rules = gameDeck->getRules();
+    logMessage(QString("🃏 NEW %1-DECK SHOE INITIALIZED").arg(rules.numDecks));
+    logMessage(QString("📚 Starting with %1 cards (%2 decks × 52 cards)")
+               .arg(gameDeck->getCardsRemaining()).arg(rules.numDecks));
+    logMessage(QString("🔄 Shuffle point: ~%1-%2 cards remaining").arg(rules.cutCardMin).arg(rules.cutCardMax));
+    logMessage(QString("📜 Rules: %1").arg(QString::fromStdString(rules.describe())));
     logMessage("Welcome to Blackjack! Click 'New Game' to start.");
 
     bool ok;
@@ -37,11 +40,21 @@ BlackjackGUI::BlackjackGUI(QWidget *parent)
 }
 
 BlackjackGUI::~BlackjackGUI() {
+    gameDeck->setListener(nullptr);
     delete cardImageManager;
     delete gameEngine;
     delete gameDeck;
 }
 
+void BlackjackGUI::onShoeCreated(int numDecks, int totalCards, int cutPoint) {
+    logMessage(QString("✨ Fresh shoe! New %1-deck shoe with %2 cards (cut card at %3)")
+               .arg(numDecks).arg(totalCards).arg(cutPoint));
+}
+
+void BlackjackGUI::onCutCardReached(int cardsRemaining) {
+    logMessage(QString("🔄 CUT CARD REACHED with %1 cards left! Reshuffling...").arg(cardsRemaining));
+}
+
 void BlackjackGUI::setupUI() {
     centralWidget = new QWidget(this);
     setCentralWidget(centralWidget);
@@ -296,9 +309,8 @@ void BlackjackGUI::onNewGameClicked() {
     
     // Check for reshuffle BEFORE dealing
     if (gameDeck->isThresholdReached()) {
-        logMessage("🔄 CUT CARD REACHED! Reshuffling 8-deck shoe...");
-        gameDeck->resetDeck();  // This reshuffles
-        logMessage(QString("✨ Fresh shoe! New 8-deck shoe with %1 cards").arg(gameDeck->getCardsRemaining()));
+        logMessage("🔄 CUT CARD REACHED! Reshuffling the shoe...");
+        gameDeck->resetDeck();  // This reshuffles; onShoeCreated logs the new shoe
     }
 
     updateGameButtonStates();
@@ -376,17 +388,29 @@ void BlackjackGUI::offerEvenMoney() {
     QMessageBox evenMoneyDialog;
     evenMoneyDialog.setWindowTitle("Even Money Offer");
     evenMoneyDialog.setText("🎰 EVEN MONEY OFFER 🎰");
-    evenMoneyDialog.setInformativeText(
+    QString offerText =
         QString("You have blackjack and the dealer is showing an Ace!\n\n"
                 "Take even money? You'll win $%1 guaranteed.\n"
                 "Or risk it for $%2 if dealer doesn't have blackjack?\n\n"
                 "Current bet: $%3")
         .arg(currentBet, 0, 'f', 2)           // Even money payout (1:1)
-        .arg(currentBet * 1.5, 0, 'f', 2)    // Blackjack payout (3:2)
-        .arg(currentBet, 0, 'f', 2));
+        .arg(currentBet * gameEngine->getRules().blackjackPayout, 0, 'f', 2)    // Blackjack payout
+        .arg(currentBet, 0, 'f', 2);
+
+    // Even money is insurance on a blackjack, so the same index applies
+    Counting* counting = gameEngine->getCountingSystem();
+    const IndexTable& indices = gameEngine->getIndexTable();
+    bool countSaysInsure = counting && counting->shouldTakeInsurance(indices);
+    if (counting && counting->isCountingEnabled()) {
+        offerText += QString("\n\n📈 True count %1, insurance index %2: %3")
+            .arg(counting->getTrueCount(), 0, 'f', 1)
+            .arg(indices.insuranceIndex, 0, 'f', 0)
+            .arg(countSaysInsure ? "take even money" : "decline");
+    }
+    evenMoneyDialog.setInformativeText(offerText);
     
     evenMoneyDialog.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
-    evenMoneyDialog.setDefaultButton(QMessageBox::No);
+    evenMoneyDialog.setDefaultButton(countSaysInsure ? QMessageBox::Yes : QMessageBox::No);
     evenMoneyDialog.button(QMessageBox::Yes)->setText("Take Even Money ($" + QString::number(currentBet, 'f', 2) + ")");
     evenMoneyDialog.button(QMessageBox::No)->setText("Risk It for Blackjack Payout");
     
@@ -558,7 +582,8 @@ void BlackjackGUI::onMaxBet() {
 void BlackjackGUI::onHitClicked() {
     logMessage("Player chooses to HIT");
     
-    bool success = gameEngine->playerHit(0);
+    bool success = isPlayingSplitHands ? gameEngine->playerHitsSplitHand(0, currentSplitHandIndex)
+                                       : gameEngine->playerHit(0);
     updateDisplay();
     
     if (!success) {
@@ -584,7 +609,11 @@ void BlackjackGUI::onHitClicked() {
 void BlackjackGUI::onStandClicked() {
     logMessage("Player chooses to STAND");
     
-    gameEngine->playerStand(0);
+    if (isPlayingSplitHands) {
+        gameEngine->playerStandsSplitHand(0, currentSplitHandIndex);
+    } else {
+        gameEngine->playerStand(0);
+    }
     
     if (isPlayingSplitHands) {
         // Move to next split hand or finish split play
@@ -623,7 +652,8 @@ void BlackjackGUI::onDoubleClicked() {
     logMessage(QString("💸 Additional bet for double down: -$%1").arg(currentBet, 0, 'f', 2));
     logMessage(QString("💰 Total at risk: $%1 (doubled)").arg(currentBet * 2, 0, 'f', 2));
     
-    bool success = gameEngine->playerDoublesDown(0);
+    bool success = isPlayingSplitHands ? gameEngine->playerDoublesDownSplitHand(0, currentSplitHandIndex)
+                                       : gameEngine->playerDoublesDown(0);
     updateDisplay();
     
     if (!success) {
@@ -749,9 +779,10 @@ void BlackjackGUI::onSurrenderClicked() {
     
     statusLabel->setText("🏳️ Status: Surrendered - Lost half bet");
     
-    // Record as loss in stats
+    // Record the surrender and its half-unit loss in stats
     if (gameEngine && gameEngine->getGameStats()) {
-        gameEngine->getGameStats()->updatePlayerStats("Player", GameResult::LOSS);
+        gameEngine->getGameStats()->updatePlayerStats("Player", GameResult::SURRENDER);
+        gameEngine->recordRoundResult("Player", -0.5, 1.0);
         updateGameStats();
     }
     
@@ -1289,9 +1320,12 @@ void BlackjackGUI::processBetResult(GameResult result, bool isBlackjack, bool do
             break;
             
         case GameResult::BLACKJACK:
-            // Blackjack: return bet + 1.5x winnings
-            payout = baseBet + (baseBet * 1.5);
-            resultMessage = QString("🎊 BLACKJACK! +$%1").arg(baseBet * 1.5, 0, 'f', 2); // Show net gain
+        {
+            // Blackjack: return bet + the table's blackjack payout
+            double blackjackWin = baseBet * gameEngine->getRules().blackjackPayout;
+            payout = baseBet + blackjackWin;
+            resultMessage = QString("🎊 BLACKJACK! +$%1").arg(blackjackWin, 0, 'f', 2); // Show net gain
+        }
             break;
             
         case GameResult::PUSH:
@@ -1315,6 +1349,12 @@ void BlackjackGUI::processBetResult(GameResult result, bool isBlackjack, bool do
                 resultMessage = QString("💸 YOU LOSE! Lost: $%1").arg(baseBet, 0, 'f', 2);
             }
             break;
+
+        case GameResult::SURRENDER:
+            // Settled in onSurrenderClicked
+            payout = baseBet / 2.0;
+            resultMessage = "🏳️ SURRENDER - Half the bet returned";
+            break;
     }
     
     playerBalance += payout;
@@ -1323,6 +1363,10 @@ void BlackjackGUI::processBetResult(GameResult result, bool isBlackjack, bool do
 
     if(gameEngine && gameEngine->getGameStats()){
         gameEngine->getGameStats()->updatePlayerStats("Player", result);
+        if (baseBet > 0.0) {
+            double wagered = doubledDown ? baseBet * 2 : baseBet;
+            gameEngine->recordRoundResult("Player", (payout - wagered) / baseBet, wagered / baseBet);
+        }
         updateGameStats();
     }
     
@@ -1588,6 +1632,7 @@ void BlackjackGUI::processSplitHandResults() {
     
     int wins = 0, losses = 0, pushes = 0;
     double totalPayout = 0.0;
+    double totalWagered = 0.0;
     
     for (size_t i = 0; i < playerSplitHands.size(); ++i) {
         const auto& hand = playerSplitHands[i];
@@ -1624,12 +1669,23 @@ void BlackjackGUI::processSplitHandResults() {
             totalPayout += handBet;
             logMessage(QString("🤝 Split hand %1: PUSH (%2 vs %3) - Bet returned").arg(i + 1).arg(hand.getTotalValue()).arg(dealer.getTotalValue()));
         }
+        
+        totalWagered += handBet;
+        if (gameEngine->getGameStats()) {
+            gameEngine->getGameStats()->updatePlayerStats("Player", result);
+        }
     }
     
     // Update balance with total payout
     playerBalance += totalPayout;
     updateBettingDisplay();
     
+    // All split hands make one round in the money results
+    if (gameEngine->getGameStats() && currentBet > 0.0) {
+        gameEngine->recordRoundResult("Player", (totalPayout - totalWagered) / currentBet, totalWagered / currentBet);
+        updateGameStats();
+    }
+    
     // Summary message
     logMessage(QString("📊 Split Results: %1 wins, %2 losses, %3 pushes").arg(wins).arg(losses).arg(pushes));
     
@@ -1651,7 +1707,7 @@ void BlackjackGUI::offerInsurance() {
     QMessageBox insuranceDialog;
     insuranceDialog.setWindowTitle("Insurance Offer");
     insuranceDialog.setText("🛡️ INSURANCE OFFER 🛡️");
-    insuranceDialog.setInformativeText(
+    QString offerText =
         QString("The dealer is showing an Ace!\n\n"
                 "Purchase insurance for $%1?\n"
                 "• Insurance costs half your original bet\n"
@@ -1660,10 +1716,22 @@ void BlackjackGUI::offerInsurance() {
                 "Original bet: $%2\nInsurance cost: $%3")
         .arg(insuranceAmount, 0, 'f', 2)
         .arg(currentBet, 0, 'f', 2)
-        .arg(insuranceAmount, 0, 'f', 2));
+        .arg(insuranceAmount, 0, 'f', 2);
+
+    // A counter takes insurance at or above the system's insurance index
+    Counting* counting = gameEngine->getCountingSystem();
+    const IndexTable& indices = gameEngine->getIndexTable();
+    bool countSaysInsure = counting && counting->shouldTakeInsurance(indices);
+    if (counting && counting->isCountingEnabled()) {
+        offerText += QString("\n\n📈 True count %1, insurance index %2: %3")
+            .arg(counting->getTrueCount(), 0, 'f', 1)
+            .arg(indices.insuranceIndex, 0, 'f', 0)
+            .arg(countSaysInsure ? "take it" : "decline");
+    }
+    insuranceDialog.setInformativeText(offerText);
     
     insuranceDialog.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
-    insuranceDialog.setDefaultButton(QMessageBox::No);
+    insuranceDialog.setDefaultButton(countSaysInsure ? QMessageBox::Yes : QMessageBox::No);
     insuranceDialog.button(QMessageBox::Yes)->setText("Buy Insurance ($" + QString::number(insuranceAmount, 'f', 2) + ")");
     insuranceDialog.button(QMessageBox::No)->setText("No Insurance");
     
@@ -31,7 +31,7 @@
 #include <iostream>
 #include <random>
 
-class BlackjackGUI : public QMainWindow {
+class BlackjackGUI : public QMainWindow, public ShoeListener {
     Q_OBJECT
 
 private:
@@ -132,6 +132,10 @@ public:
     BlackjackGUI(QWidget *parent = nullptr);
     ~BlackjackGUI();
 
+    // ShoeListener
+    void onShoeCreated(int numDecks, int totalCards, int cutPoint) override;
+    void onCutCardReached(int cardsRemaining) override;
+
 private slots:
     void onHitClicked();
     void onStandClicked();
@@ -3,25 +3,43 @@
 #include <limits>
 #include <iomanip>
 #include <vector>
+#include <memory>
 #include "GameEngine.h"
 #include "basicStrag.h"
 #include "counting.h"
+#include "TableRules.h"
+
+// Prints shoe changes for the console game
+class ConsoleShoeListener : public ShoeListener {
+public:
+    void onShoeCreated(int numDecks, int totalCards, int cutPoint) override {
+        std::cout << "New " << numDecks << "-deck shoe created (" << totalCards << " cards). Cut point at " 
+                  << cutPoint << " cards remaining.\n";
+    }
+};
+
+std::string describePayout(const TableRules& rules) {
+    if (rules.blackjackPayout == 1.5) return "3:2";
+    if (rules.blackjackPayout == 1.2) return "6:5";
+    return std::to_string(rules.blackjackPayout) + ":1";
+}
 
 void clearInput() {
     std::cin.clear();
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 }
 
-void displayWelcome() {
+void displayWelcome(const TableRules& rules) {
     std::cout << "======================================" << std::endl;
     std::cout << "       WELCOME TO BLACKJACK!         " << std::endl;
     std::cout << "======================================" << std::endl;
     std::cout << "Rules:" << std::endl;
     std::cout << "- Get as close to 21 as possible without going over" << std::endl;
     std::cout << "- Aces count as 1 or 11, face cards count as 10" << std::endl;
-    std::cout << "- Dealer hits on 16 and stands on 17" << std::endl;
-    std::cout << "- Blackjack = 21 with 2 cards" << std::endl;
-    std::cout << "- Using 6-deck shoe (312 cards total)" << std::endl;
+    std::cout << (rules.dealerHitsSoft17 ? "- Dealer hits soft 17, stands on hard 17"
+                                         : "- Dealer hits on 16 and stands on all 17s") << std::endl;
+    std::cout << "- Blackjack = 21 with 2 cards, pays " << describePayout(rules) << std::endl;
+    std::cout << "- Using " << rules.numDecks << "-deck shoe (" << rules.totalCards() << " cards total)" << std::endl;
     std::cout << "======================================" << std::endl;
 }
 
@@ -129,7 +147,7 @@ void displayGameMenu() {
     std::cout << "======================================" << std::endl;
 }
 
-void displayRules() {
+void displayRules(const TableRules& rules) {
     std::cout << "\n======================================" << std::endl;
     std::cout << "           BLACKJACK RULES            " << std::endl;
     std::cout << "======================================" << std::endl;
@@ -148,16 +166,26 @@ void displayRules() {
     std::cout << "- Additional options: Double Down, Split pairs, Surrender" << std::endl;
     std::cout << "- If you go over 21, you 'bust' and lose immediately" << std::endl;
     std::cout << "- Dealer reveals hole card and hits until reaching 17 or higher" << std::endl;
+    if (rules.dealerHitsSoft17) {
+        std::cout << "- Dealer also hits soft 17 (an Ace counted as 11)" << std::endl;
+    }
+    std::cout << "- Split up to " << rules.maxSplitHands << " hands"
+              << (rules.doubleAfterSplit ? ", double after split allowed" : ", no double after split")
+              << (rules.resplitAces ? ", aces may be resplit" : "") << std::endl;
+    if (rules.lateSurrender) {
+        std::cout << "- Late surrender: give up half your bet on your first two cards" << std::endl;
+    }
     std::cout << std::endl;
     std::cout << "WINNING:" << std::endl;
-    std::cout << "- Blackjack (21 with 2 cards) beats regular 21" << std::endl;
+    std::cout << "- Blackjack (21 with 2 cards) beats regular 21 and pays " << describePayout(rules) << std::endl;
     std::cout << "- Higher total wins (without busting)" << std::endl;
     std::cout << "- Same total = Push (tie)" << std::endl;
     std::cout << std::endl;
     std::cout << "DECK INFO:" << std::endl;
-    std::cout << "- Uses 6-deck shoe (312 cards total)" << std::endl;
+    std::cout << "- Uses " << rules.numDecks << "-deck shoe (" << rules.totalCards() << " cards total)" << std::endl;
     std::cout << "- Same shoe continues across multiple games" << std::endl;
-    std::cout << "- Reshuffles when cut card is reached (60-80 cards remaining)" << std::endl;
+    std::cout << "- Reshuffles when cut card is reached (" << rules.cutCardMin << "-"
+              << rules.cutCardMax << " cards remaining)" << std::endl;
     std::cout << "======================================" << std::endl;
 }
 
@@ -343,11 +371,17 @@ void configureGameFeatures(GameEngine& gameEngine) {
                 std::cout << "2. KO (Knock Out)" << std::endl;
                 std::cout << "3. Hi-Opt I (Intermediate)" << std::endl;
                 std::cout << "4. Omega II (Advanced)" << std::endl;
+                std::cout << "5. Count all systems side by side (on/off)" << std::endl;
                 std::cout << "Choice: ";
                 int system;
                 std::cin >> system;
                 if (system >= 1 && system <= 4) {
                     gameEngine.setCountingSystem(static_cast<CountingSystem>(system - 1));
+                } else if (system == 5 && gameEngine.getCountingSystem()) {
+                    Counting* counting = gameEngine.getCountingSystem();
+                    counting->enableAllSystems(!counting->isTrackingAllSystems());
+                    std::cout << "Simultaneous counting "
+                              << (counting->isTrackingAllSystems() ? "enabled." : "disabled.") << std::endl;
                 }
                 break;
             }
@@ -359,6 +393,9 @@ void configureGameFeatures(GameEngine& gameEngine) {
             case 4: {
                 if (gameEngine.getCountingSystem()) {
                     gameEngine.getCountingSystem()->displayCurrentCount();
+                    if (gameEngine.getCountingSystem()->isTrackingAllSystems()) {
+                        gameEngine.getCountingSystem()->displayAllSystemCounts();
+                    }
                 }
                 break;
             }
@@ -378,16 +415,42 @@ void configureGameFeatures(GameEngine& gameEngine) {
     }
 }
 
-int main() {
-    displayWelcome();
+int main(int argc, char* argv[]) {
+    // blackjack --history FILE keeps a log of every round for bjhist
+    std::string historyFile;
+    if (argc == 3 && std::string(argv[1]) == "--history") {
+        historyFile = argv[2];
+    } else if (argc != 1) {
+        std::cout << "Usage: blackjack [--history FILE]" << std::endl;
+        return 1;
+    }
+
+    TableRules rules;
+    displayWelcome(rules);
     
-    // Create the 6-deck shoe once - this persists throughout the session
-    Deck gameDeck;
-    std::cout << "\n6-deck shoe initialized and shuffled!" << std::endl;
+    // Create the shoe once - this persists throughout the session
+    Deck gameDeck(rules);
+    ConsoleShoeListener shoeListener;
+    gameDeck.setListener(&shoeListener);
+    std::cout << "\n" << rules.numDecks << "-deck shoe initialized and shuffled!" << std::endl;
     
     // Persistent player list
     std::vector<std::string> playerNames;
     GameEngine gameSession(gameDeck);
+
+    std::unique_ptr<HandHistoryWriter> historyWriter;
+    std::unique_ptr<HandHistoryRecorder> history;
+    if (!historyFile.empty()) {
+        try {
+            historyWriter = std::make_unique<HandHistoryWriter>(historyFile, rules, 0);
+        } catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+        history = std::make_unique<HandHistoryRecorder>(*historyWriter);
+        gameSession.setHandHistory(history.get());
+        std::cout << "Logging every round to " << historyFile << std::endl;
+    }
     
     bool keepPlaying = true;
     
@@ -482,7 +545,7 @@ int main() {
                 gameSession.resetGameStats();
                 break;
             case 7:
-                displayRules();
+                displayRules(rules);
                 break;
             case 8:
                 std::cout << "\n=== ENDING BLACKJACK SESSION ===" << std::endl;
@@ -495,9 +558,16 @@ int main() {
                 break;
         }
     }
-    
 
-    
+    if (historyWriter) {
+        try {
+            history->flush();
+            historyWriter->close();
+        } catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+    }
     
     return 0;
 }
\ No newline at end of file
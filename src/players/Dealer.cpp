@@ -2,10 +2,13 @@
 #include <iostream>
 #include <stdexcept>
 
-Dealer::Dealer() : Player("Dealer", true), holeCardRevealed(false) {}
+Dealer::Dealer(const TableRules& rules) 
+    : Player("Dealer", true), holeCardRevealed(false), hitsSoft17(rules.dealerHitsSoft17) {}
 
 bool Dealer::shouldHit() const {
-    return getTotalValue() <= 16;
+    int total = getTotalValue();
+    // Combined with & and | so the rule check does not add a branch
+    return (total < 17) | (hitsSoft17 & (total == 17) & isSoft());
 }
 
 void Dealer::revealHoleCard() {
@@ -2,15 +2,17 @@
 #define DEALER_H
 
 #include "player.h"
+#include "TableRules.h"
 
 class Dealer : public Player {
 private:
     bool holeCardRevealed;
+    bool hitsSoft17;
 
 public:
-    Dealer();
+    explicit Dealer(const TableRules& rules = TableRules());
     
-    bool shouldHit() const;           // True if dealer must hit (total <= 16)
+    bool shouldHit() const;           // True below 17, and on soft 17 under H17
     void revealHoleCard();            // Shows the hole card
     bool checkForBlackjack() const;   // Early blackjack check
     void playTurn();                  // Dealer's automatic play logic
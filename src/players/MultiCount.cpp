@@ -0,0 +1,58 @@
+#include "MultiCount.h"
+
+#include <stdexcept>
+
+MultiCount::MultiCount() : systemCount(0) {
+    for (int lane = 0; lane < max_systems; ++lane) {
+        for (int rank = 0; rank < PackedCard::rank_count; ++rank) {
+            tagsByRank[rank][lane] = 0;
+        }
+        counts[lane] = 0;
+    }
+}
+
+int MultiCount::addSystem(const std::string& name, const CountTags& tags) {
+    if (systemCount >= max_systems) {
+        throw std::length_error("No room for another counting system");
+    }
+
+    int lane = systemCount++;
+    for (int rank = 0; rank < PackedCard::rank_count; ++rank) {
+        tagsByRank[rank][lane] = tags[rank];
+    }
+    names[lane] = name;
+    counts[lane] = 0;
+    return lane;
+}
+
+void MultiCount::reset() {
+    for (int lane = 0; lane < max_systems; ++lane) {
+        counts[lane] = 0;
+    }
+}
+
+int MultiCount::getCount(int system) const {
+    if (system < 0 || system >= systemCount) {
+        throw std::out_of_range("Counting system index out of range");
+    }
+    return counts[system];
+}
+
+const std::string& MultiCount::getName(int system) const {
+    if (system < 0 || system >= systemCount) {
+        throw std::out_of_range("Counting system index out of range");
+    }
+    return names[system];
+}
+
+CountTags MultiCount::getTags(int system) const {
+    if (system < 0 || system >= systemCount) {
+        throw std::out_of_range("Counting system index out of range");
+    }
+
+    CountTags tags;
+    for (int rank = 0; rank < PackedCard::rank_count; ++rank) {
+        tags[rank] = tagsByRank[rank][system];
+    }
+    return tags;
+}
@@ -0,0 +1,59 @@
+#ifndef MULTICOUNT_H
+#define MULTICOUNT_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include "card.h"
+
+// Count tag per rank, indexed like PackedCard::getRankIndex()
+// (0 = ace, 1-8 = twos to nines, 9 = ten-valued)
+typedef std::array<int, PackedCard::rank_count> CountTags;
+
+// Running counts for several counting systems over the same cards. The tags
+// are stored rank-major with one lane per system, so counting a card adds one
+// row of eight int32 lanes to the counts. With GCC/Clang that row is a vector
+// type and the add is a single instruction (AVX2) or two (SSE, NEON); other
+// compilers get a plain loop.
+class MultiCount {
+public:
+    static const int max_systems = 8;
+
+private:
+#if defined(__GNUC__)
+    typedef int32_t Lanes __attribute__((vector_size(max_systems * sizeof(int32_t))));
+#else
+    typedef int32_t Lanes[max_systems];
+#endif
+
+    Lanes tagsByRank[PackedCard::rank_count];
+    Lanes counts;
+    std::string names[max_systems];
+    int systemCount;
+
+public:
+    MultiCount();
+
+    // Returns the lane of the new system. Throws std::length_error when all
+    // lanes are in use.
+    int addSystem(const std::string& name, const CountTags& tags);
+
+    void addCard(PackedCard card) { addRank(card.getRankIndex()); }
+    void addRank(int rankIndex) {
+#if defined(__GNUC__)
+        counts += tagsByRank[rankIndex];
+#else
+        for (int lane = 0; lane < max_systems; ++lane) {
+            counts[lane] += tagsByRank[rankIndex][lane];
+        }
+#endif
+    }
+    void reset();
+
+    int getSystemCount() const { return systemCount; }
+    int getCount(int system) const;
+    const std::string& getName(int system) const;
+    CountTags getTags(int system) const;
+};
+
+#endif
@@ -0,0 +1,164 @@
+#include "PlayerActionHandler.h"
+
+#include <cctype>
+#include <iostream>
+#include <stdexcept>
+
+Action legalAction(Action action, bool canDouble, bool canSplit, bool canSurrender) {
+    switch (action) {
+        case Action::DOUBLE: return canDouble ? action : Action::HIT;
+        case Action::SPLIT: return canSplit ? action : Action::HIT;
+        case Action::SURRENDER: return canSurrender ? action : Action::STAND;
+        default: return action;
+    }
+}
+
+char actionCode(Action action) {
+    switch (action) {
+        case Action::HIT: return 'h';
+        case Action::STAND: return 's';
+        case Action::DOUBLE: return 'd';
+        case Action::SPLIT: return 'p';
+        case Action::SURRENDER: return 'u';
+        default: return '?';
+    }
+}
+
+Action actionFromCode(char code) {
+    switch (std::tolower(static_cast<unsigned char>(code))) {
+        case 'h': return Action::HIT;
+        case 's': return Action::STAND;
+        case 'd': return Action::DOUBLE;
+        case 'p': return Action::SPLIT;
+        case 'u': return Action::SURRENDER;
+        default: throw std::invalid_argument(std::string("Unknown action code: ") + code);
+    }
+}
+
+BasicStrategyHandler::BasicStrategyHandler(const TableRules& tableRules) : strategy(tableRules) {}
+
+Action BasicStrategyHandler::decide(const Player& hand, const Dealer& dealer,
+                                    bool canDouble, bool canSplit, bool canSurrender) {
+    return strategy.getOptimalAction(hand, dealer, canDouble, canSurrender, canSplit);
+}
+
+std::unique_ptr<PlayerActionHandler> BasicStrategyHandler::clone() const {
+    // Copies share any loaded table
+    return std::make_unique<BasicStrategyHandler>(*this);
+}
+
+CountingStrategyHandler::CountingStrategyHandler(const TableRules& tableRules, const Counting* countingSystem)
+    : strategy(tableRules), counting(countingSystem) {}
+
+Action CountingStrategyHandler::decide(const Player& hand, const Dealer& dealer,
+                                       bool canDouble, bool canSplit, bool canSurrender) {
+    if (!counting || !counting->isCountingEnabled()) {
+        return strategy.getOptimalAction(hand, dealer, canDouble, canSurrender, canSplit);
+    }
+
+    const IndexTable& indices = strategy.getIndexTable(static_cast<int>(counting->getCurrentSystem()));
+    return strategy.getOptimalAction(hand, dealer, indices, counting->getTrueCount(),
+                                     canDouble, canSurrender, canSplit);
+}
+
+std::unique_ptr<PlayerActionHandler> CountingStrategyHandler::clone() const {
+    return std::make_unique<CountingStrategyHandler>(*this);
+}
+
+RandomActionHandler::RandomActionHandler(uint64_t seed) : rng(seed) {}
+
+Action RandomActionHandler::decide(const Player&, const Dealer&,
+                                   bool canDouble, bool canSplit, bool canSurrender) {
+    Action choices[5] = {Action::HIT, Action::STAND};
+    uint32_t count = 2;
+    if (canDouble) choices[count++] = Action::DOUBLE;
+    if (canSplit) choices[count++] = Action::SPLIT;
+    if (canSurrender) choices[count++] = Action::SURRENDER;
+    return choices[rng.bounded(count)];
+}
+
+std::unique_ptr<PlayerActionHandler> RandomActionHandler::clone() const {
+    return std::make_unique<RandomActionHandler>(*this);
+}
+
+ReplayActionHandler::ReplayActionHandler(std::vector<Action> actions)
+    : recording(std::make_shared<const std::vector<Action>>(std::move(actions))), position(0) {}
+
+ReplayActionHandler ReplayActionHandler::fromCodes(const std::string& codes) {
+    std::vector<Action> actions;
+    for (char code : codes) {
+        if (std::isspace(static_cast<unsigned char>(code))) continue;
+        actions.push_back(actionFromCode(code));
+    }
+    return ReplayActionHandler(std::move(actions));
+}
+
+Action ReplayActionHandler::decide(const Player&, const Dealer&, bool, bool, bool) {
+    if (position >= recording->size()) {
+        throw std::out_of_range("Replay has no more recorded decisions");
+    }
+    return (*recording)[position++];
+}
+
+std::unique_ptr<PlayerActionHandler> ReplayActionHandler::clone() const {
+    auto copy = std::make_unique<ReplayActionHandler>(*this);
+    copy->position = 0;
+    return copy;
+}
+
+RecordingActionHandler::RecordingActionHandler(const PlayerActionHandler& handler)
+    : inner(handler.clone()) {}
+
+Action RecordingActionHandler::decide(const Player& hand, const Dealer& dealer,
+                                      bool canDouble, bool canSplit, bool canSurrender) {
+    Action action = inner->decide(hand, dealer, canDouble, canSplit, canSurrender);
+    recording.push_back(action);
+    return action;
+}
+
+std::unique_ptr<PlayerActionHandler> RecordingActionHandler::clone() const {
+    return std::make_unique<RecordingActionHandler>(*inner);
+}
+
+std::string RecordingActionHandler::getCodes() const {
+    std::string codes;
+    for (Action action : recording) {
+        codes += actionCode(action);
+    }
+    return codes;
+}
+
+Action ConsoleActionHandler::decide(const Player&, const Dealer&,
+                                    bool canDouble, bool canSplit, bool canSurrender) {
+    while (true) {
+        std::cout << "\nChoose action: (h)it, (s)tand";
+        if (canDouble) std::cout << ", (d)ouble down";
+        if (canSurrender) std::cout << ", s(u)rrender";
+        if (canSplit) std::cout << ", s(p)lit";
+        std::cout << ": ";
+
+        char choice;
+        if (!(std::cin >> choice)) {
+            return Action::STAND;
+        }
+
+        try {
+            Action action = actionFromCode(choice);
+            if (legalAction(action, canDouble, canSplit, canSurrender) == action) {
+                return action;
+            }
+        } catch (const std::invalid_argument&) {
+            // Not an action letter; list the choices below
+        }
+
+        std::cout << "Invalid choice. Available options: h, s";
+        if (canDouble) std::cout << ", d";
+        if (canSurrender) std::cout << ", u";
+        if (canSplit) std::cout << ", p";
+        std::cout << std::endl;
+    }
+}
+
+std::unique_ptr<PlayerActionHandler> ConsoleActionHandler::clone() const {
+    return std::make_unique<ConsoleActionHandler>(*this);
+}
@@ -0,0 +1,136 @@
+#ifndef PLAYERACTIONHANDLER_H
+#define PLAYERACTIONHANDLER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "player.h"
+#include "Dealer.h"
+#include "rng.h"
+#include "basicStrag.h"
+#include "counting.h"
+#include "TableRules.h"
+
+// Decides what a seat does with a hand. GameEngine, SplitHand and the
+// simulators all ask one of these, so the same strategy code runs at the
+// console, in the GUI and headless. The flags say which extra actions the
+// table allows right now; hit and stand are always allowed.
+//
+// Each simulation worker gets its own copy through clone(), so
+// implementations may keep private state.
+class PlayerActionHandler {
+public:
+    virtual ~PlayerActionHandler() = default;
+    virtual Action decide(const Player& hand, const Dealer& dealer,
+                          bool canDouble, bool canSplit, bool canSurrender) = 0;
+    virtual std::unique_ptr<PlayerActionHandler> clone() const = 0;
+};
+
+// What the table does with an action it does not allow: a double or split
+// becomes a hit, a surrender becomes a stand
+Action legalAction(Action action, bool canDouble, bool canSplit, bool canSurrender);
+
+// One-letter codes as typed at the console: h, s, d, p (split), u (surrender)
+char actionCode(Action action);
+Action actionFromCode(char code);   // throws std::invalid_argument
+
+// Plays every hand by the BasicStrat tables
+class BasicStrategyHandler : public PlayerActionHandler {
+private:
+    BasicStrat strategy;
+
+public:
+    explicit BasicStrategyHandler(const TableRules& tableRules = TableRules());
+
+    Action decide(const Player& hand, const Dealer& dealer,
+                  bool canDouble, bool canSplit, bool canSurrender) override;
+    std::unique_ptr<PlayerActionHandler> clone() const override;
+
+    // Plays a generated table instead of the built-in one
+    void loadStrategyTables(const std::string& path) { strategy.loadStrategyTables(path); }
+};
+
+// Basic strategy plus the index plays of whatever system `counting` runs,
+// at its current true count. Plays plain basic strategy while counting is
+// off or unset. Clones read the same Counting.
+class CountingStrategyHandler : public PlayerActionHandler {
+private:
+    BasicStrat strategy;
+    const Counting* counting;
+
+public:
+    CountingStrategyHandler(const TableRules& tableRules, const Counting* countingSystem);
+
+    Action decide(const Player& hand, const Dealer& dealer,
+                  bool canDouble, bool canSplit, bool canSurrender) override;
+    std::unique_ptr<PlayerActionHandler> clone() const override;
+
+    void setCounting(const Counting* countingSystem) { counting = countingSystem; }
+    void loadStrategyTables(const std::string& path) { strategy.loadStrategyTables(path); }
+    void loadIndexTables(const std::string& path) { strategy.loadIndexTables(path); }
+};
+
+// Picks uniformly among the allowed actions. Clones repeat the same
+// sequence of draws; simulated tables still differ through their shoes.
+class RandomActionHandler : public PlayerActionHandler {
+private:
+    Rng rng;
+
+public:
+    explicit RandomActionHandler(uint64_t seed);
+
+    Action decide(const Player& hand, const Dealer& dealer,
+                  bool canDouble, bool canSplit, bool canSurrender) override;
+    std::unique_ptr<PlayerActionHandler> clone() const override;
+};
+
+// Plays back recorded decisions in order, whatever the cards. Throws
+// std::out_of_range once the recording runs out. Clones start over from
+// the first decision.
+class ReplayActionHandler : public PlayerActionHandler {
+private:
+    std::shared_ptr<const std::vector<Action>> recording;
+    size_t position;
+
+public:
+    explicit ReplayActionHandler(std::vector<Action> actions);
+
+    // From action codes such as "hsdpu"; whitespace is skipped
+    static ReplayActionHandler fromCodes(const std::string& codes);
+
+    Action decide(const Player& hand, const Dealer& dealer,
+                  bool canDouble, bool canSplit, bool canSurrender) override;
+    std::unique_ptr<PlayerActionHandler> clone() const override;
+
+    bool isFinished() const { return position >= recording->size(); }
+};
+
+// Passes decisions through from another handler and keeps them, so a
+// session can be played back with ReplayActionHandler
+class RecordingActionHandler : public PlayerActionHandler {
+private:
+    std::unique_ptr<PlayerActionHandler> inner;
+    std::vector<Action> recording;
+
+public:
+    explicit RecordingActionHandler(const PlayerActionHandler& handler);
+
+    Action decide(const Player& hand, const Dealer& dealer,
+                  bool canDouble, bool canSplit, bool canSurrender) override;
+    std::unique_ptr<PlayerActionHandler> clone() const override;
+
+    const std::vector<Action>& getRecording() const { return recording; }
+    std::string getCodes() const;
+};
+
+// Asks at the console, re-prompting until the choice is allowed. Stands
+// if input runs out.
+class ConsoleActionHandler : public PlayerActionHandler {
+public:
+    Action decide(const Player& hand, const Dealer& dealer,
+                  bool canDouble, bool canSplit, bool canSurrender) override;
+    std::unique_ptr<PlayerActionHandler> clone() const override;
+};
+
+#endif
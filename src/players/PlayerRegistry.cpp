@@ -0,0 +1,25 @@
+#include "PlayerRegistry.h"
+
+#include <stdexcept>
+
+PlayerId PlayerRegistry::intern(const std::string& playerName) {
+    auto it = ids.find(playerName);
+    if (it != ids.end()) return it->second;
+
+    PlayerId id = static_cast<PlayerId>(names.size());
+    names.push_back(playerName);
+    ids.emplace(playerName, id);
+    return id;
+}
+
+PlayerId PlayerRegistry::find(const std::string& playerName) const {
+    auto it = ids.find(playerName);
+    return (it != ids.end()) ? it->second : no_player;
+}
+
+const std::string& PlayerRegistry::getName(PlayerId id) const {
+    if (id < 0 || id >= size()) {
+        throw std::out_of_range("Unknown player id " + std::to_string(id));
+    }
+    return names[id];
+}
@@ -0,0 +1,31 @@
+#ifndef PLAYERREGISTRY_H
+#define PLAYERREGISTRY_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Dense player number, 0 for the first name interned, used to index the
+// per-player arrays in Stats, Counting and BasicStrat
+using PlayerId = int;
+const PlayerId no_player = -1;
+
+// Interns player names once, at the table, so per-hand bookkeeping indexes
+// arrays instead of hashing names. IDs are never reused or removed. Not
+// synchronised: intern every name before handing it to other threads.
+class PlayerRegistry {
+private:
+    std::vector<std::string> names;
+    std::unordered_map<std::string, PlayerId> ids;
+
+public:
+    // The name's ID, adding it if it is new
+    PlayerId intern(const std::string& playerName);
+    // no_player if the name was never interned
+    PlayerId find(const std::string& playerName) const;
+    // Throws std::out_of_range for an ID this registry did not hand out
+    const std::string& getName(PlayerId id) const;
+    int size() const { return static_cast<int>(names.size()); }
+};
+
+#endif
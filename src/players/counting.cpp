@@ -3,69 +3,69 @@
 #include <iomanip>
 #include <chrono>
 #include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// Tags by rank index: A, 2, 3, 4, 5, 6, 7, 8, 9, ten-valued
+const CountTags system_tags[] = {
+    {-1, +1, +1, +1, +1, +1,  0,  0,  0, -1},  // Hi-Lo: +1 for 2-6, 0 for 7-9, -1 for 10-A
+    {-1, +1, +1, +1, +1, +1, +1,  0,  0, -1},  // KO: +1 for 2-7, 0 for 8-9, -1 for 10-A
+    { 0,  0, +1, +1, +1, +1,  0,  0,  0, -1},  // Hi-Opt I: +1 for 3-6, 0 for 2,7-9,A, -1 for 10-K
+    { 0, +1, +1, +2, +2, +2, +1,  0, -1, -2}   // Omega II
+};
+
+static_assert(sizeof(system_tags) / sizeof(system_tags[0]) == index_table_systems,
+              "Every counting system needs its built-in index plays");
+
+const CountingSystem all_systems[] = {
+    CountingSystem::HI_LO, CountingSystem::KO, CountingSystem::HI_OPT_I, CountingSystem::OMEGA_II
+};
+
+}
 
 Counting::Counting(const Deck* gameDeck) 
     : currentSystem(CountingSystem::HI_LO), runningCount(0), countingEnabled(false),
       quizProbability(0.15), rng(std::random_device{}()), 
-      quizChance(0.0, 1.0), quizType(1, 2), deck(gameDeck) {
+      quizChance(0.0, 1.0), quizType(1, 2),
+      registry(std::make_shared<PlayerRegistry>()), deck(gameDeck),
+      deckEstimation(DeckEstimation::HALF_DECK), tableCards(0), trayErrorFraction(0.05),
+      trayRng(std::random_device{}()), trayCards(-1), trayDecks(0.0), trackAllSystems(false) {
     initializeCountingSystems();
+    buildTrueCountTable();
 }
 
 void Counting::initializeCountingSystems() {
-    // Hi-Lo System: +1 for 2-6, 0 for 7-9, -1 for 10-A
-    countingValues[CountingSystem::HI_LO] = {
-        {1, -1},  // Ace
-        {2, +1}, {3, +1}, {4, +1}, {5, +1}, {6, +1},  // 2-6
-        {7, 0}, {8, 0}, {9, 0},                        // 7-9
-        {10, -1}, {11, -1}, {12, -1}, {13, -1}         // 10, J, Q, K
-    };
-    
-    // KO (Knock Out) System: +1 for 2-7, 0 for 8-9, -1 for 10-A
-    countingValues[CountingSystem::KO] = {
-        {1, -1},  // Ace
-        {2, +1}, {3, +1}, {4, +1}, {5, +1}, {6, +1}, {7, +1},  // 2-7
-        {8, 0}, {9, 0},                                         // 8-9
-        {10, -1}, {11, -1}, {12, -1}, {13, -1}                  // 10, J, Q, K
-    };
-    
-    // Hi-Opt I System: +1 for 3-6, 0 for 2,7-9,A, -1 for 10-K
-    countingValues[CountingSystem::HI_OPT_I] = {
-        {1, 0},   // Ace
-        {2, 0},   // 2
-        {3, +1}, {4, +1}, {5, +1}, {6, +1},            // 3-6
-        {7, 0}, {8, 0}, {9, 0},                        // 7-9
-        {10, -1}, {11, -1}, {12, -1}, {13, -1}         // 10, J, Q, K
-    };
-    
-    // Omega II System (advanced): Various values
-    countingValues[CountingSystem::OMEGA_II] = {
-        {1, 0},   // Ace
-        {2, +1},  // 2
-        {3, +1}, {4, +2}, {5, +2}, {6, +2},            // 3-6
-        {7, +1},  // 7
-        {8, 0}, {9, -1},                               // 8-9
-        {10, -2}, {11, -2}, {12, -2}, {13, -2}         // 10, J, Q, K
-    };
+    currentTags = getSystemTags(currentSystem);
+
+    // Lane order matches the CountingSystem values
+    for (CountingSystem system : all_systems) {
+        allSystems.addSystem(getSystemName(system), getSystemTags(system));
+    }
+}
+
+const CountTags& Counting::getSystemTags(CountingSystem system) {
+    return system_tags[static_cast<int>(system)];
 }
 
 int Counting::getCardCountValue(const Card& card, CountingSystem system) const {
-    int value = card.getValue();
-    auto systemIt = countingValues.find(system);
-    if (systemIt == countingValues.end()) return 0;
-    
-    auto valueIt = systemIt->second.find(value);
-    return (valueIt != systemIt->second.end()) ? valueIt->second : 0;
+    return getSystemTags(system)[card.getPacked().getRankIndex()];
 }
 
 void Counting::updateCount(const Card& card) {
     if (!countingEnabled) return;
     
-    int cardValue = getCardCountValue(card, currentSystem);
-    runningCount += cardValue;
+    PackedCard packed = card.getPacked();
+    runningCount += currentTags[packed.getRankIndex()];
+
+    if (trackAllSystems) {
+        allSystems.addCard(packed);
+    }
 }
 
 void Counting::resetCount() {
     runningCount = 0;
+    allSystems.reset();
     std::cout << "Running count reset to 0." << std::endl;
 }
 
@@ -76,25 +76,110 @@ int Counting::getRunningCount() const {
 double Counting::calculateTrueCount() const {
     if (!deck) return 0.0;
     
-    int decksRemaining = getDecksRemaining();
-    if (decksRemaining <= 0) return 0.0;
-    
-    return static_cast<double>(runningCount) / decksRemaining;
+    return getTrueCountFor(runningCount, deck->getCardsRemaining());
 }
 
 double Counting::getTrueCount() const {
     return calculateTrueCount();
 }
 
-int Counting::getDecksRemaining() const {
-    if (!deck) return 1;
+double Counting::getDecksRemaining() const {
+    if (!deck) return 1.0;
     
-    int cardsRemaining = deck->getCardsRemaining();
-    return std::max(1, (cardsRemaining + 51) / 52); // Round up to nearest deck
+    return estimateDecksRemaining(deck->getCardsRemaining());
+}
+
+void Counting::setDeckEstimation(DeckEstimation mode) {
+    deckEstimation = mode;
+    trayCards = -1;
+    buildTrueCountTable();
+}
+
+std::string Counting::getDeckEstimationName(DeckEstimation mode) const {
+    switch (mode) {
+        case DeckEstimation::WHOLE_DECK: return "Whole deck";
+        case DeckEstimation::HALF_DECK: return "Half deck";
+        case DeckEstimation::QUARTER_DECK: return "Quarter deck";
+        case DeckEstimation::EXACT: return "Exact";
+        case DeckEstimation::VISUAL_TRAY: return "Visual tray";
+        default: return "Unknown";
+    }
+}
+
+void Counting::setTrayEstimateError(double fraction) {
+    trayErrorFraction = std::max(0.0, fraction);
+    trayCards = -1;
+}
+
+double Counting::estimateDecksRemaining(int cardsRemaining) const {
+    double exactDecks = cardsRemaining / 52.0;
+
+    switch (deckEstimation) {
+        case DeckEstimation::WHOLE_DECK:
+            return std::max(1, (cardsRemaining + 51) / 52); // Round up to nearest deck
+        case DeckEstimation::HALF_DECK:
+            return std::max(0.5, std::round(exactDecks * 2.0) / 2.0);
+        case DeckEstimation::QUARTER_DECK:
+            return std::max(0.25, std::round(exactDecks * 4.0) / 4.0);
+        case DeckEstimation::VISUAL_TRAY:
+            return estimateTrayDecks(cardsRemaining);
+        case DeckEstimation::EXACT:
+        default:
+            return exactDecks;
+    }
+}
+
+double Counting::estimateTrayDecks(int cardsRemaining) const {
+    // A player reads the discard tray, not the shoe. The misjudgement grows
+    // with the size of the pile and the reading is taken to the half deck.
+    if (cardsRemaining != trayCards) {
+        int totalCards = deck ? deck->getRules().totalCards() : 8 * 52;
+        double totalDecks = totalCards / 52.0;
+        double discardDecks = (totalCards - cardsRemaining) / 52.0;
+
+        std::normal_distribution<double> misjudgement(0.0, trayErrorFraction);
+        double seenDecks = discardDecks * (1.0 + misjudgement(trayRng));
+        seenDecks = std::round(seenDecks * 2.0) / 2.0;
+
+        trayDecks = std::max(0.5, totalDecks - seenDecks);
+        trayCards = cardsRemaining;
+    }
+    return trayDecks;
+}
+
+void Counting::buildTrueCountTable() {
+    trueCountTable.clear();
+    tableCards = deck ? deck->getRules().totalCards() : 0;
+
+    // The tray estimate is random, so it cannot be tabulated
+    if (tableCards == 0 || deckEstimation == DeckEstimation::VISUAL_TRAY) return;
+
+    int columns = tableCards + 1;
+    trueCountTable.resize(static_cast<size_t>(2 * true_count_range + 1) * columns);
+
+    for (int cards = 0; cards <= tableCards; ++cards) {
+        double decks = estimateDecksRemaining(cards);
+        for (int count = -true_count_range; count <= true_count_range; ++count) {
+            trueCountTable[static_cast<size_t>(count + true_count_range) * columns + cards] =
+                decks > 0.0 ? static_cast<float>(count / decks) : 0.0f;
+        }
+    }
+}
+
+double Counting::getTrueCountFor(int count, int cardsRemaining) const {
+    if (!trueCountTable.empty() && count >= -true_count_range && count <= true_count_range &&
+        cardsRemaining >= 0 && cardsRemaining <= tableCards) {
+        return trueCountTable[static_cast<size_t>(count + true_count_range) * (tableCards + 1) +
+                              cardsRemaining];
+    }
+
+    double decks = estimateDecksRemaining(cardsRemaining);
+    return decks > 0.0 ? count / decks : 0.0;
 }
 
 void Counting::setCountingSystem(CountingSystem system) {
     currentSystem = system;
+    currentTags = getSystemTags(system);
     resetCount(); // Reset count when changing systems
     std::cout << "Counting system changed to: " << getSystemName(system) << std::endl;
 }
@@ -123,6 +208,29 @@ void Counting::enableCounting(bool enabled) {
     }
 }
 
+void Counting::enableAllSystems(bool enabled) {
+    trackAllSystems = enabled;
+    allSystems.reset(); // lanes start together from the next card
+}
+
+int Counting::addCustomSystem(const std::string& name, const CountTags& tags) {
+    return allSystems.addSystem(name, tags);
+}
+
+void Counting::displayAllSystemCounts() const {
+    if (!trackAllSystems) {
+        std::cout << "Simultaneous counting is disabled." << std::endl;
+        return;
+    }
+
+    std::cout << "\n=== ALL SYSTEM COUNTS ===" << std::endl;
+    for (int system = 0; system < allSystems.getSystemCount(); ++system) {
+        std::cout << std::left << std::setw(16) << allSystems.getName(system) << std::right
+                  << allSystems.getCount(system) << std::endl;
+    }
+    std::cout << "=========================" << std::endl;
+}
+
 void Counting::setQuizProbability(double probability) {
     quizProbability = std::max(0.0, std::min(1.0, probability));
     std::cout << "Quiz probability set to " << (quizProbability * 100) << "%." << std::endl;
@@ -197,7 +305,11 @@ void Counting::askTrueCountQuiz(const std::string& playerName) {
 
 void Counting::recordQuizResult(const std::string& playerName, bool isRunningCount, 
                                bool correct, double responseTime) {
-    CountingStats& stats = playerStats[playerName];
+    PlayerId id = registry->intern(playerName);
+    if (id >= static_cast<PlayerId>(playerStats.size())) {
+        playerStats.resize(id + 1);
+    }
+    CountingStats& stats = playerStats[id];
     stats.totalQuizzes++;
     
     if (isRunningCount) {
@@ -254,7 +366,8 @@ void Counting::displayCurrentCount() const {
     std::cout << "System: " << getSystemName(currentSystem) << std::endl;
     std::cout << "Running Count: " << runningCount << std::endl;
     std::cout << "True Count: " << std::fixed << std::setprecision(2) << getTrueCount() << std::endl;
-    std::cout << "Decks Remaining: " << getDecksRemaining() << std::endl;
+    std::cout << "Decks Remaining: " << getDecksRemaining()
+              << " (" << getDeckEstimationName(deckEstimation) << ")" << std::endl;
     std::cout << "=====================" << std::endl;
 }
 
@@ -314,17 +427,48 @@ void Counting::showCountingSystemInfo() const {
             std::cout << "Difficulty: Advanced\n";
             break;
     }
+
+    std::cout << "\nIndex Plays:" << std::endl;
+    printIndexTable(std::cout, getIndexTable());
     std::cout << "=======================================" << std::endl;
 }
 
+const CountingStats* Counting::findStats(const std::string& playerName) const {
+    PlayerId id = registry->find(playerName);
+    if (id == no_player || id >= static_cast<PlayerId>(playerStats.size()) ||
+        playerStats[id].totalQuizzes == 0) {
+        return nullptr;
+    }
+    return &playerStats[id];
+}
+
+void Counting::usePlayerRegistry(std::shared_ptr<PlayerRegistry> playerRegistry) {
+    if (!playerRegistry) {
+        throw std::invalid_argument("Counting needs a player registry");
+    }
+    std::vector<CountingStats> recorded;
+    recorded.swap(playerStats);
+    std::shared_ptr<PlayerRegistry> previous = registry;
+    registry = std::move(playerRegistry);
+
+    for (PlayerId id = 0; id < static_cast<PlayerId>(recorded.size()); ++id) {
+        if (recorded[id].totalQuizzes == 0) continue;
+        PlayerId newId = registry->intern(previous->getName(id));
+        if (newId >= static_cast<PlayerId>(playerStats.size())) {
+            playerStats.resize(newId + 1);
+        }
+        playerStats[newId] = recorded[id];
+    }
+}
+
 void Counting::displayPlayerCountingStats(const std::string& playerName) const {
-    auto it = playerStats.find(playerName);
-    if (it == playerStats.end()) {
+    const CountingStats* found = findStats(playerName);
+    if (!found) {
         std::cout << "No counting statistics for " << playerName << std::endl;
         return;
     }
     
-    const CountingStats& stats = it->second;
+    const CountingStats& stats = *found;
     
     std::cout << "\n=== COUNTING STATS: " << playerName << " ===" << std::endl;
     std::cout << "Total Quizzes: " << stats.totalQuizzes << std::endl;
@@ -370,14 +514,16 @@ void Counting::displayPlayerCountingStats(const std::string& playerName) const {
 void Counting::displayAllCountingStats() const {
     std::cout << "\n======== ALL COUNTING STATISTICS ========" << std::endl;
     
-    if (playerStats.empty()) {
-        std::cout << "No counting statistics recorded yet." << std::endl;
-        std::cout << "==========================================" << std::endl;
-        return;
+    bool hasData = false;
+    for (PlayerId id = 0; id < static_cast<PlayerId>(playerStats.size()); ++id) {
+        if (playerStats[id].totalQuizzes == 0) continue;
+        displayPlayerCountingStats(registry->getName(id));
+        hasData = true;
     }
     
-    for (const auto& pair : playerStats) {
-        displayPlayerCountingStats(pair.first);
+    if (!hasData) {
+        std::cout << "No counting statistics recorded yet." << std::endl;
+        std::cout << "==========================================" << std::endl;
     }
 }
 
@@ -387,7 +533,10 @@ void Counting::resetCountingStats() {
 }
 
 void Counting::resetCountingStats(const std::string& playerName) {
-    playerStats.erase(playerName);
+    PlayerId id = registry->find(playerName);
+    if (id != no_player && id < static_cast<PlayerId>(playerStats.size())) {
+        playerStats[id] = CountingStats();
+    }
     std::cout << "Counting statistics for " << playerName << " have been reset!" << std::endl;
 }
 
@@ -412,8 +561,10 @@ std::string Counting::getBettingAdvice() const {
 int Counting::getSuggestedBetMultiplier() const {
     if (!countingEnabled) return 1;
     
-    double trueCount = getTrueCount();
-    
+    return betMultiplierFor(getTrueCount());
+}
+
+int Counting::betMultiplierFor(double trueCount) {
     if (trueCount >= 3.0) return 5;      // 5x minimum bet
     else if (trueCount >= 2.0) return 4; // 4x minimum bet
     else if (trueCount >= 1.5) return 3; // 3x minimum bet
@@ -421,6 +572,17 @@ int Counting::getSuggestedBetMultiplier() const {
     else return 1;                       // 1x minimum bet
 }
 
+const IndexTable& Counting::getIndexTable() const {
+    bool h17 = deck ? deck->getRules().dealerHitsSoft17 : false;
+    return index_tables[static_cast<int>(currentSystem)][h17 ? 1 : 0];
+}
+
+bool Counting::shouldTakeInsurance(const IndexTable& indices) const {
+    if (!countingEnabled) return false;
+
+    return indices.takesInsurance(getTrueCount());
+}
+
 void Counting::enterTrainingMode() {
     std::cout << "\n========== COUNTING TRAINING MODE ==========" << std::endl;
     std::cout << "Practice your counting skills!" << std::endl;
@@ -517,10 +679,10 @@ void Counting::practiceCountingDrill(int numberOfCards) {
 }
 
 double Counting::getCountingAccuracy(const std::string& playerName) const {
-    auto it = playerStats.find(playerName);
-    if (it == playerStats.end()) return 0.0;
+    const CountingStats* found = findStats(playerName);
+    if (!found) return 0.0;
     
-    const CountingStats& stats = it->second;
+    const CountingStats& stats = *found;
     int totalCorrect = stats.correctRunningCount + stats.correctTrueCount;
     int totalQuestions = stats.totalRunningCountQuestions + stats.totalTrueCountQuestions;
     
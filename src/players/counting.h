@@ -2,11 +2,15 @@
 #define COUNTING_H
 
 #include <string>
-#include <map>
+#include <memory>
 #include <random>
+#include <vector>
 #include "card.h"
 #include "deck.h"
 #include "Stats.h"
+#include "MultiCount.h"
+#include "IndexPlays.h"
+#include "PlayerRegistry.h"
 
 enum class CountingSystem {
     HI_LO,      // +1 for 2-6, 0 for 7-9, -1 for 10-A
@@ -15,6 +19,15 @@ enum class CountingSystem {
     OMEGA_II    // Advanced counting system
 };
 
+// How the player judges the decks left when converting to a true count
+enum class DeckEstimation {
+    WHOLE_DECK,     // rounded up to whole decks
+    HALF_DECK,      // nearest half deck
+    QUARTER_DECK,   // nearest quarter deck
+    EXACT,          // cards remaining / 52
+    VISUAL_TRAY     // eyeballing the discard tray, with human error
+};
+
 struct CountingStats {
     int totalQuizzes;
     int correctRunningCount;
@@ -40,18 +53,39 @@ private:
     std::uniform_real_distribution<double> quizChance;
     std::uniform_int_distribution<int> quizType;
     
-    // Player statistics
-    std::map<std::string, CountingStats> playerStats;
+    // Player statistics, by PlayerId; a player with no quizzes has none
+    std::shared_ptr<PlayerRegistry> registry;
+    std::vector<CountingStats> playerStats;
     
     // Deck reference for true count calculations
     const Deck* deck;
-    
-    // Card values for different counting systems
-    std::map<CountingSystem, std::map<int, int>> countingValues;
+
+    DeckEstimation deckEstimation;
+
+    // True count by [runningCount + true_count_range][cardsRemaining] for
+    // the deterministic estimators; counts outside the range are divided
+    std::vector<float> trueCountTable;
+    int tableCards;
+
+    // Visual tray estimate, redrawn whenever the number of cards changes
+    double trayErrorFraction;
+    mutable std::mt19937 trayRng;
+    mutable int trayCards;
+    mutable double trayDecks;
+    
+    // Tags of the current system, by rank index
+    CountTags currentTags;
+
+    // Every built-in system (lane = CountingSystem value) plus any custom
+    // ones, counted together when trackAllSystems is on
+    MultiCount allSystems;
+    bool trackAllSystems;
     
     void initializeCountingSystems();
     int getCardCountValue(const Card& card, CountingSystem system) const;
     double calculateTrueCount() const;
+    void buildTrueCountTable();
+    double estimateTrayDecks(int cardsRemaining) const;
     
     // Quiz management
     bool shouldTriggerQuiz();
@@ -59,6 +93,7 @@ private:
     void askTrueCountQuiz(const std::string& playerName);
     void recordQuizResult(const std::string& playerName, bool isRunningCount, 
                          bool correct, double responseTime);
+    const CountingStats* findStats(const std::string& playerName) const;   // nullptr if never quizzed
 
 public:
     Counting(const Deck* gameDeck);
@@ -70,10 +105,19 @@ public:
     double getTrueCount() const;
     
     // System management
+    static const CountTags& getSystemTags(CountingSystem system);
     void setCountingSystem(CountingSystem system);
     CountingSystem getCurrentSystem() const;
     std::string getSystemName(CountingSystem system) const;
     
+    // Simultaneous counts: every system sees the same cards. Custom systems
+    // take the next free lane, which is returned.
+    void enableAllSystems(bool enabled);
+    bool isTrackingAllSystems() const { return trackAllSystems; }
+    int addCustomSystem(const std::string& name, const CountTags& tags);
+    const MultiCount& getAllSystemCounts() const { return allSystems; }
+    void displayAllSystemCounts() const;
+    
     // Enable/disable features
     void enableCounting(bool enabled);
     void setQuizProbability(double probability); // 0.0 to 1.0
@@ -93,10 +137,21 @@ public:
     void displayAllCountingStats() const;
     void resetCountingStats();
     void resetCountingStats(const std::string& playerName);
+
+    // Player names are interned here; the table shares its registry.
+    // Players already quizzed keep their numbers.
+    void usePlayerRegistry(std::shared_ptr<PlayerRegistry> playerRegistry);
+    PlayerRegistry& getPlayerRegistry() const { return *registry; }
     
     // Betting advice based on count
     std::string getBettingAdvice() const;
     int getSuggestedBetMultiplier() const; // 1-5x based on true count
+    static int betMultiplierFor(double trueCount);
+
+    // Built-in playing deviations for the current system and the shoe's
+    // rules, for BasicStrat's count-aware lookups
+    const IndexTable& getIndexTable() const;
+    bool shouldTakeInsurance(const IndexTable& indices) const;  // true count at the insurance index
     
     // Training mode
     void enterTrainingMode();
@@ -110,7 +165,15 @@ public:
     void processDealtCards(const std::vector<Card>& cards);
     bool checkForQuizOpportunity(const std::string& currentPlayer);
 
-    int getDecksRemaining() const;
+    // Deck estimation and true count conversion
+    static const int true_count_range = 128;
+    void setDeckEstimation(DeckEstimation mode);
+    DeckEstimation getDeckEstimation() const { return deckEstimation; }
+    std::string getDeckEstimationName(DeckEstimation mode) const;
+    void setTrayEstimateError(double fraction); // std dev of the discard misjudgement, e.g. 0.05
+    double estimateDecksRemaining(int cardsRemaining) const;
+    double getTrueCountFor(int count, int cardsRemaining) const;
+    double getDecksRemaining() const;
 };
 
 #endif
\ No newline at end of file
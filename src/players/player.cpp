@@ -3,7 +3,7 @@
 #include <iostream>
 
 Player::Player(const std::string& playerName, bool dealer) 
-    : name(playerName), hand(), isDealer(dealer) {}
+    : name(playerName), hand(), isDealer(dealer), id(no_player) {}
 
 void Player::addCard(const Card& card) {
     hand.addCard(card);
@@ -41,6 +41,10 @@ bool Player::isBusted() const{
     return hand.isBusted();
 }
 
+bool Player::isSoft() const{
+    return hand.isSoft();
+}
+
 std::string Player::getName() const{
     return name;
 }
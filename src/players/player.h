@@ -4,12 +4,14 @@
 #include <string>
 #include "hand.h"
 #include "deck.h"
+#include "PlayerRegistry.h"
 
 class Player {
 private:
     std::string name;
     Hand hand;
     bool isDealer;
+    PlayerId id;    // from the table's PlayerRegistry; no_player until seated
 
 public:
 
@@ -19,12 +21,16 @@ public:
     int getTotalValue() const;
     Card getUpCard() const;
     Card getCard(int index) const;
+    PackedCard getPackedCard(int index) const { return hand.getPackedCard(index); }
     size_t getCardCount() const;
     bool isBlackjack() const;
     bool isBusted() const;
+    bool isSoft() const;
     std::string getName() const;
     bool getIsDealer() const;
     void removeCard(size_t index);
+    PlayerId getId() const { return id; }
+    void setId(PlayerId playerId) { id = playerId; }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,411 @@
+#include "BankrollSim.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// Running count of one table's shoe, converted to a true count the way a
+// Counting player with the same deck estimation would
+class ShoeCounter : public ShoeListener {
+private:
+    const Deck& deck;
+    CountTags tags;
+    int runningCount;
+    Counting conversion;
+
+public:
+    ShoeCounter(const Deck& tableDeck, CountingSystem system, DeckEstimation estimation)
+        : deck(tableDeck), tags(Counting::getSystemTags(system)), runningCount(0),
+          conversion(&tableDeck) {
+        conversion.setDeckEstimation(estimation);
+    }
+
+    bool wantsCardEvents() const override { return true; }
+    void onShoeCreated(int, int, int) override { runningCount = 0; }
+    void onCardDealt(const Card& card, int) override {
+        runningCount += tags[card.getPacked().getRankIndex()];
+    }
+
+    double getTrueCount() const {
+        return conversion.getTrueCountFor(runningCount, deck.getCardsRemaining());
+    }
+};
+
+// Runs work(worker, rounds, stream) on `threads` threads, splitting `total`
+// rounds between them. Worker N gets stream N of `seed`, as in Simulator.
+template <typename Work>
+void forEachWorker(int threads, uint64_t total, uint64_t seed, Work work) {
+    int workerCount = std::max(1, threads);
+    std::vector<std::thread> workers;
+    Rng stream(seed);
+
+    for (int w = 0; w < workerCount; ++w) {
+        uint64_t share = total / workerCount +
+                         (static_cast<uint64_t>(w) < total % workerCount ? 1 : 0);
+        workers.emplace_back([&work, w, share, stream]() {
+            work(w, share, stream);
+        });
+        stream.jump();
+    }
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+}
+
+// Until calibrated, about -0.5% off the top and +0.5% per true count
+TrueCountEdge::TrueCountEdge() : baseEdge(-0.005), edgePerTrueCount(0.005), variance(1.3) {
+    for (int i = 0; i < buckets; ++i) {
+        edge[i] = 0.0;
+        hands[i] = 0;
+    }
+}
+
+int TrueCountEdge::bucketFor(double trueCount) {
+    int whole = static_cast<int>(std::floor(trueCount));
+    return std::min(max_true_count, std::max(min_true_count, whole)) - min_true_count;
+}
+
+double TrueCountEdge::edgeAt(double trueCount) const {
+    double clamped = std::min<double>(max_true_count, std::max<double>(min_true_count, trueCount));
+    return baseEdge + edgePerTrueCount * clamped;
+}
+
+BetRamp::BetRamp() : type(Type::COUNTING), kellyFraction(1.0), minUnits(1.0), maxUnits(5.0) {}
+
+BetRamp BetRamp::counting() {
+    return BetRamp();
+}
+
+BetRamp BetRamp::parse(const std::string& spec) {
+    BetRamp ramp;
+    ramp.type = Type::TABLE;
+    ramp.maxUnits = ramp.minUnits;
+
+    std::stringstream stream(spec);
+    std::string step;
+    while (std::getline(stream, step, ',')) {
+        size_t colon = step.find(':');
+        if (colon == std::string::npos) {
+            throw std::invalid_argument("Bet ramp step '" + step + "' is not TC:UNITS");
+        }
+
+        double trueCount;
+        double units;
+        try {
+            trueCount = std::stod(step.substr(0, colon));
+            units = std::stod(step.substr(colon + 1));
+        } catch (const std::exception&) {
+            throw std::invalid_argument("Bet ramp step '" + step + "' is not TC:UNITS");
+        }
+        if (units <= 0.0) {
+            throw std::invalid_argument("Bet ramp units must be positive");
+        }
+        ramp.steps.emplace_back(trueCount, units);
+    }
+
+    if (ramp.steps.empty()) {
+        throw std::invalid_argument("Bet ramp is empty");
+    }
+
+    std::sort(ramp.steps.begin(), ramp.steps.end());
+    for (const auto& step : ramp.steps) {
+        ramp.maxUnits = std::max(ramp.maxUnits, step.second);
+    }
+    return ramp;
+}
+
+BetRamp BetRamp::kelly(double fraction, double minUnits, double maxUnits) {
+    if (fraction <= 0.0) {
+        throw std::invalid_argument("Kelly fraction must be positive");
+    }
+    if (minUnits <= 0.0 || maxUnits < minUnits) {
+        throw std::invalid_argument("Kelly bets need 0 < min <= max");
+    }
+
+    BetRamp ramp;
+    ramp.type = Type::KELLY;
+    ramp.kellyFraction = fraction;
+    ramp.minUnits = minUnits;
+    ramp.maxUnits = maxUnits;
+    return ramp;
+}
+
+double BetRamp::unitsFor(double trueCount, double bankroll, const TrueCountEdge& edges) const {
+    switch (type) {
+        case Type::TABLE: {
+            double units = minUnits;
+            for (const auto& step : steps) {
+                if (trueCount < step.first) break;
+                units = step.second;
+            }
+            return units;
+        }
+
+        case Type::KELLY: {
+            // Optimal fraction for a bet with a small edge is edge / variance
+            double edge = edges.edgeAt(trueCount);
+            if (edge <= 0.0 || edges.variance <= 0.0) return minUnits;
+            double units = kellyFraction * bankroll * edge / edges.variance;
+            return std::min(maxUnits, std::max(minUnits, units));
+        }
+
+        case Type::COUNTING:
+        default:
+            return Counting::betMultiplierFor(trueCount);
+    }
+}
+
+std::string BetRamp::describe() const {
+    std::ostringstream out;
+
+    switch (type) {
+        case Type::TABLE:
+            out << "Ramp " << minUnits << " unit";
+            for (const auto& step : steps) {
+                out << ", " << step.second << " at TC " << (step.first >= 0 ? "+" : "") << step.first;
+            }
+            break;
+
+        case Type::KELLY:
+            if (kellyFraction == 1.0) out << "Full Kelly";
+            else if (kellyFraction == 0.5) out << "Half Kelly";
+            else out << kellyFraction << " Kelly";
+            out << " (" << minUnits << "-" << maxUnits << " units)";
+            break;
+
+        case Type::COUNTING:
+        default:
+            out << "Counting 1-5x ramp";
+            break;
+    }
+    return out.str();
+}
+
+void BankrollResults::merge(const BankrollResults& other) {
+    hands += other.hands;
+    unitsWon += other.unitsWon;
+    unitsWonSquared += other.unitsWonSquared;
+    unitsBet += other.unitsBet;
+    trials += other.trials;
+    ruined += other.ruined;
+    sessionStats.merge(other.sessionStats);
+}
+
+double BankrollResults::expectedValue() const {
+    if (hands == 0) return 0.0;
+    return unitsWon / hands;
+}
+
+double BankrollResults::standardDeviation() const {
+    if (hands < 2) return 0.0;
+    double mean = expectedValue();
+    double variance = (unitsWonSquared - hands * mean * mean) / (hands - 1);
+    return std::sqrt(std::max(0.0, variance));
+}
+
+double BankrollResults::averageBet() const {
+    if (hands == 0) return 0.0;
+    return unitsBet / hands;
+}
+
+double BankrollResults::n0() const {
+    double ev = expectedValue();
+    if (ev <= 0.0) return 0.0;
+    double ratio = standardDeviation() / ev;
+    return ratio * ratio;
+}
+
+double BankrollResults::score() const {
+    double sd = standardDeviation();
+    if (sd <= 0.0 || expectedValue() <= 0.0) return 0.0;
+    double ratio = expectedValue() / sd;
+    return 1e6 * ratio * ratio;
+}
+
+double BankrollResults::riskOfRuin(double bankroll) const {
+    double ev = expectedValue();
+    double sd = standardDeviation();
+    if (ev <= 0.0) return 1.0;
+    if (sd <= 0.0) return 0.0;
+    return std::exp(-2.0 * ev * bankroll / (sd * sd));
+}
+
+double BankrollResults::simulatedRiskOfRuin() const {
+    if (trials == 0) return 0.0;
+    return static_cast<double>(ruined) / trials;
+}
+
+BankrollSimulator::BankrollSimulator(const BankrollConfig& bankrollConfig, const PlayerActionHandler& policy)
+    : config(bankrollConfig), prototype(policy) {}
+
+TrueCountEdge BankrollSimulator::calibrate() const {
+    struct Buckets {
+        double won[TrueCountEdge::buckets];
+        uint64_t hands[TrueCountEdge::buckets];
+        // Sums for the least squares line of net result on true count
+        double sumCount;
+        double sumCountSquared;
+        double sumCountWon;
+        SimResults flat;
+    };
+    std::vector<Buckets> workerBuckets(std::max(1, config.sim.threads), Buckets{});
+
+    // Flat one-unit bets on a different stream than the main run
+    forEachWorker(config.sim.threads, config.calibrationHands, config.sim.seed + 1,
+                  [this, &workerBuckets](int w, uint64_t share, const Rng& stream) {
+        std::unique_ptr<PlayerActionHandler> policy = prototype.clone();
+        SimTable table(*policy, stream, config.sim.rules);
+        ShoeCounter counter(table.getDeck(), config.system, config.estimation);
+        table.setShoeListener(&counter);
+
+        Buckets& buckets = workerBuckets[w];
+        for (uint64_t i = 0; i < share; ++i) {
+            double trueCount = std::min<double>(TrueCountEdge::max_true_count,
+                                                std::max<double>(TrueCountEdge::min_true_count,
+                                                                 counter.getTrueCount()));
+            int bucket = TrueCountEdge::bucketFor(trueCount);
+            double net = table.playRound(buckets.flat);
+            buckets.won[bucket] += net;
+            buckets.hands[bucket]++;
+            buckets.sumCount += trueCount;
+            buckets.sumCountSquared += trueCount * trueCount;
+            buckets.sumCountWon += trueCount * net;
+        }
+    });
+
+    TrueCountEdge edges;
+    for (int bucket = 0; bucket < TrueCountEdge::buckets; ++bucket) {
+        double won = 0.0;
+        uint64_t hands = 0;
+        for (const Buckets& buckets : workerBuckets) {
+            won += buckets.won[bucket];
+            hands += buckets.hands[bucket];
+        }
+        edges.edge[bucket] = hands > 0 ? won / hands : 0.0;
+        edges.hands[bucket] = hands;
+    }
+
+    SimResults flat;
+    double sumCount = 0.0;
+    double sumCountSquared = 0.0;
+    double sumCountWon = 0.0;
+    for (const Buckets& buckets : workerBuckets) {
+        flat.merge(buckets.flat);
+        sumCount += buckets.sumCount;
+        sumCountSquared += buckets.sumCountSquared;
+        sumCountWon += buckets.sumCountWon;
+    }
+    if (flat.hands < 2) return edges;
+
+    double n = static_cast<double>(flat.hands);
+    double spread = n * sumCountSquared - sumCount * sumCount;
+    if (spread > 0.0) {
+        edges.edgePerTrueCount = (n * sumCountWon - sumCount * flat.unitsWon) / spread;
+        edges.baseEdge = (flat.unitsWon - edges.edgePerTrueCount * sumCount) / n;
+    }
+    double sd = flat.standardDeviation();
+    edges.variance = sd * sd;
+    return edges;
+}
+
+void BankrollSimulator::playHands(const TrueCountEdge& edges, BankrollResults& total) const {
+    std::vector<BankrollResults> workerResults(std::max(1, config.sim.threads));
+
+    forEachWorker(config.sim.threads, config.sim.hands, config.sim.seed,
+                  [this, &edges, &workerResults](int w, uint64_t share, const Rng& stream) {
+        std::unique_ptr<PlayerActionHandler> policy = prototype.clone();
+        SimTable table(*policy, stream, config.sim.rules);
+        ShoeCounter counter(table.getDeck(), config.system, config.estimation);
+        table.setShoeListener(&counter);
+
+        // Kelly bets stay sized to the starting bankroll here, so every hand
+        // is drawn from the same ramp
+        BankrollResults& results = workerResults[w];
+        SimResults scratch;
+        for (uint64_t i = 0; i < share; ++i) {
+            double units = config.ramp.unitsFor(counter.getTrueCount(), config.bankroll, edges);
+            double net = table.playRound(scratch) * units;
+            results.hands++;
+            results.unitsBet += units;
+            results.unitsWon += net;
+            results.unitsWonSquared += net * net;
+        }
+    });
+
+    for (const BankrollResults& results : workerResults) {
+        total.merge(results);
+    }
+}
+
+void BankrollSimulator::playTrials(const TrueCountEdge& edges, BankrollResults& total) const {
+    std::vector<BankrollResults> workerResults(std::max(1, config.sim.threads));
+
+    forEachWorker(config.sim.threads, config.trials, config.sim.seed + 2,
+                  [this, &edges, &workerResults](int w, uint64_t share, const Rng& stream) {
+        std::unique_ptr<PlayerActionHandler> policy = prototype.clone();
+        SimTable table(*policy, stream, config.sim.rules);
+        ShoeCounter counter(table.getDeck(), config.system, config.estimation);
+        table.setShoeListener(&counter);
+
+        BankrollResults& results = workerResults[w];
+        SimResults scratch;
+        for (uint64_t trial = 0; trial < share; ++trial) {
+            // Kelly bets follow the bankroll as it grows and shrinks. A trial
+            // is ruined once the minimum bet can no longer be covered.
+            double bankroll = config.bankroll;
+            double peak = bankroll;
+            uint64_t losingStreak = 0;
+            SessionOutcome session;
+            for (uint64_t hand = 0; hand < config.tripHands; ++hand) {
+                double units = config.ramp.unitsFor(counter.getTrueCount(), bankroll, edges);
+                double net = table.playRound(scratch) * std::min(units, bankroll);
+                bankroll += net;
+                session.hands++;
+
+                peak = std::max(peak, bankroll);
+                session.maxDrawdown = std::max(session.maxDrawdown, peak - bankroll);
+                losingStreak = net < 0.0 ? losingStreak + 1 : 0;
+                session.longestLosingStreak = std::max(session.longestLosingStreak, losingStreak);
+
+                if (bankroll < config.ramp.minUnits) {
+                    results.ruined++;
+                    session.ruined = true;
+                    break;
+                }
+            }
+            session.netUnits = bankroll - config.bankroll;
+            results.sessionStats.recordSession(session);
+            results.trials++;
+        }
+    });
+
+    for (const BankrollResults& results : workerResults) {
+        total.merge(results);
+    }
+}
+
+BankrollResults BankrollSimulator::run() {
+    auto start = std::chrono::steady_clock::now();
+
+    BankrollResults total;
+    if (config.calibrationHands > 0) {
+        total.edges = calibrate();
+    }
+
+    playHands(total.edges, total);
+    if (config.trials > 0) {
+        playTrials(total.edges, total);
+    }
+
+    total.elapsedSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    return total;
+}
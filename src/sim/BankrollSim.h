@@ -0,0 +1,123 @@
+#ifndef BANKROLLSIM_H
+#define BANKROLLSIM_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Simulator.h"
+#include "counting.h"
+
+// Edge per unit bet by true count, measured by a flat-bet run. Counts
+// outside the range fall into the end buckets. The high buckets see few
+// hands, so bets are sized from a straight line fitted over every hand.
+struct TrueCountEdge {
+    static constexpr int min_true_count = -10;
+    static constexpr int max_true_count = 10;
+    static constexpr int buckets = max_true_count - min_true_count + 1;
+
+    double edge[buckets];
+    uint64_t hands[buckets];
+    double baseEdge;    // fitted edge at TC 0
+    double edgePerTrueCount;
+    double variance;    // per hand, flat betting
+
+    TrueCountEdge();
+
+    static int bucketFor(double trueCount);
+    double measuredEdgeAt(double trueCount) const { return edge[bucketFor(trueCount)]; }
+    double edgeAt(double trueCount) const;
+};
+
+// How many units to bet for a true count
+struct BetRamp {
+    enum class Type {
+        COUNTING,   // Counting::getSuggestedBetMultiplier's 1-5x spread
+        TABLE,      // explicit true count thresholds
+        KELLY       // fraction of the bankroll times edge / variance
+    };
+
+    Type type;
+    std::vector<std::pair<double, double>> steps;   // (minimum true count, units), ascending
+    double kellyFraction;                           // 1.0 = full Kelly, 0.5 = half Kelly
+    double minUnits;
+    double maxUnits;
+
+    BetRamp();
+
+    static BetRamp counting();
+    // "1:2,2:4,3:8" bets 2 units from TC +1, 4 from +2 and 8 from +3.
+    // Throws std::invalid_argument on a malformed ramp.
+    static BetRamp parse(const std::string& spec);
+    static BetRamp kelly(double fraction, double minUnits, double maxUnits);
+
+    // `bankroll` and `edges` are only read by Kelly ramps
+    double unitsFor(double trueCount, double bankroll, const TrueCountEdge& edges) const;
+    std::string describe() const;
+};
+
+struct BankrollConfig {
+    SimConfig sim;                  // hands, threads, seed and rules of the main run
+    CountingSystem system;
+    DeckEstimation estimation;
+    BetRamp ramp;
+    double bankroll;                // units; Kelly sizing and risk of ruin
+    uint64_t calibrationHands;      // flat-bet run that measures the edge per true count
+    uint64_t trials;                // bankrolls played out to measure ruin
+    uint64_t tripHands;             // rounds per trial
+
+    BankrollConfig()
+        : system(CountingSystem::HI_LO), estimation(DeckEstimation::EXACT),
+          ramp(BetRamp::counting()), bankroll(1000.0), calibrationHands(0),
+          trials(0), tripHands(100000) {}
+};
+
+struct BankrollResults {
+    uint64_t hands;
+    double unitsWon;
+    double unitsWonSquared;
+    double unitsBet;
+    uint64_t trials;
+    uint64_t ruined;
+    double elapsedSeconds;
+    TrueCountEdge edges;
+    Stats sessionStats;     // one session per trial, for the percentile tables
+
+    BankrollResults() : hands(0), unitsWon(0.0), unitsWonSquared(0.0), unitsBet(0.0),
+                        trials(0), ruined(0), elapsedSeconds(0.0) {}
+
+    void merge(const BankrollResults& other);
+
+    double expectedValue() const;           // units per hand
+    double standardDeviation() const;       // units per hand
+    double averageBet() const;
+    double winPer100() const { return expectedValue() * 100.0; }
+    double sdPer100() const { return standardDeviation() * 10.0; }
+    // Hands needed before the expected win equals one standard deviation
+    double n0() const;
+    // Win rate per 100 hands at the optimal bet for a 10,000 unit bankroll
+    double score() const;
+    // exp(-2 * ev * bankroll / variance), the constant-ramp ruin formula
+    double riskOfRuin(double bankroll) const;
+    double simulatedRiskOfRuin() const;
+};
+
+// Plays a counter's bet ramp over many shoes. Each worker runs its own
+// SimTable and Rng stream like Simulator, and a running count follows the
+// table's shoe through ShoeListener.
+class BankrollSimulator {
+private:
+    BankrollConfig config;
+    const PlayerActionHandler& prototype;
+
+    TrueCountEdge calibrate() const;
+    void playHands(const TrueCountEdge& edges, BankrollResults& total) const;
+    void playTrials(const TrueCountEdge& edges, BankrollResults& total) const;
+
+public:
+    BankrollSimulator(const BankrollConfig& bankrollConfig, const PlayerActionHandler& policy);
+
+    BankrollResults run();
+};
+
+#endif
@@ -0,0 +1,465 @@
+#include "BatchSim.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+
+// Ace counts 11 when that does not bust the hand
+inline int bestTotal(int hard, int soft) {
+    return hard + ((soft & (hard <= 11)) ? 10 : 0);
+}
+
+void requireBatchCut(const TableRules& rules, int minCutCard) {
+    if (rules.cutCardMin < minCutCard) {
+        throw std::invalid_argument("The batch kernel needs the cut card at least " + std::to_string(minCutCard) +
+                                    " cards from the end");
+    }
+}
+
+}
+
+BatchTable::BatchTable(const BasicStrat& basicStrategy, const Rng& stream, int lanes,
+                       const TableRules& tableRules, DealerKernel kernel)
+    : rules(tableRules), strategy(basicStrategy), rng(stream), laneCount(std::max(1, lanes)),
+      shoeSize(tableRules.totalCards()), stride(tableRules.totalCards() + lockstep_reserve),
+      maxHands(std::max(1, tableRules.maxSplitHands)), dealerKernel(kernel) {
+    requireBatchCut(rules, min_cut_card);
+
+    for (int type = 0; type < StrategyTable::hand_types; ++type) {
+        for (int value = 0; value < StrategyTable::values; ++value) {
+            for (int up = 1; up < StrategyTable::dealer_cards; ++up) {
+                bool pair = type == static_cast<int>(HandType::PAIR);
+                firstAction[type][value][up] = strategy.lookupAction(static_cast<HandType>(type), value, up, true,
+                                                                     rules.lateSurrender, pair && maxHands > 1);
+            }
+        }
+    }
+
+    // After the first decision only hit or stand is left
+    for (int soft = 0; soft < 2; ++soft) {
+        HandType type = soft ? HandType::SOFT : HandType::HARD;
+        for (int total = 0; total < StrategyTable::values; ++total) {
+            for (int up = 0; up < StrategyTable::dealer_cards; ++up) {
+                hitsAt[soft][total][up] = up > 0 && total < 21 &&
+                    strategy.lookupAction(type, total, up, false, false, false) == Action::HIT;
+            }
+        }
+    }
+
+    size_t count = static_cast<size_t>(laneCount);
+    shoe.resize(count * stride + dealer_kernel_padding);
+    cursor.resize(count);
+    cutPoint.resize(count);
+    roundStart.resize(count);
+    playerHard.resize(count);
+    playerSoft.resize(count);
+    playerFirst.resize(count);
+    playerSecond.resize(count);
+    bet.resize(count);
+    active.resize(count);
+    dealerUp.resize(count);
+    dealerHard.resize(count);
+    dealerSoft.resize(count);
+    dealerPlays.resize(count);
+    settled.resize(count);
+    net.resize(count);
+    splitHandCount.resize(count);
+    splitHandTotal.resize(count * maxHands);
+    splitHandBet.resize(count * maxHands);
+    splitLanes.reserve(count);
+    seats.reserve(maxHands);
+
+    for (int lane = 0; lane < laneCount; ++lane) {
+        uint8_t* cards = &shoe[static_cast<size_t>(lane) * stride];
+        int position = 0;
+        for (int deck = 0; deck < rules.numDecks; ++deck) {
+            for (int suit = 0; suit < 4; ++suit) {
+                for (int rank = 1; rank <= 13; ++rank) {
+                    cards[position++] = static_cast<uint8_t>(std::min(rank, 10));
+                }
+            }
+        }
+        shuffleLane(lane);
+    }
+}
+
+void BatchTable::shuffleLane(int lane) {
+    uint8_t* cards = &shoe[static_cast<size_t>(lane) * stride];
+    for (int i = shoeSize; i > 1; --i) {
+        int j = static_cast<int>(rng.bounded(static_cast<uint32_t>(i)));
+        std::swap(cards[i - 1], cards[j]);
+    }
+    // Padding only; see lockstep_reserve
+    std::copy(cards, cards + lockstep_reserve, cards + shoeSize);
+
+    cursor[lane] = 0;
+    int cutRange = std::max(0, rules.cutCardMax - rules.cutCardMin);
+    cutPoint[lane] = rules.cutCardMin + static_cast<int>(rng.bounded(cutRange + 1));
+}
+
+void BatchTable::refillLane(int lane) {
+    // A whole shoe in one round leaves nothing to shuffle back
+    int discards = roundStart[lane];
+    if (discards == 0) {
+        throw std::runtime_error("A round took more cards than the shoe holds");
+    }
+
+    // [discards][this round][undealt] becomes [this round][undealt][discards]
+    uint8_t* cards = &shoe[static_cast<size_t>(lane) * stride];
+    std::rotate(cards, cards + discards, cards + shoeSize);
+    uint8_t* reshuffled = cards + (shoeSize - discards);
+    for (int i = discards; i > 1; --i) {
+        int j = static_cast<int>(rng.bounded(static_cast<uint32_t>(i)));
+        std::swap(reshuffled[i - 1], reshuffled[j]);
+    }
+    std::copy(cards, cards + lockstep_reserve, cards + shoeSize);
+
+    cursor[lane] -= discards;
+    roundStart[lane] = 0;
+    // Past any cut card, so the lane is reshuffled before its next round
+    cutPoint[lane] = shoeSize;
+}
+
+uint8_t BatchTable::drawScalar(int lane) {
+    if (cursor[lane] >= shoeSize) refillLane(lane);
+    return shoe[static_cast<size_t>(lane) * stride + cursor[lane]++];
+}
+
+void BatchTable::playRounds(uint64_t rounds, SimResults& results) {
+    while (rounds > 0) {
+        int lanes = static_cast<int>(std::min<uint64_t>(rounds, static_cast<uint64_t>(laneCount)));
+        playBatch(lanes, results);
+        rounds -= lanes;
+    }
+}
+
+void BatchTable::playBatch(int lanes, SimResults& results) {
+    const uint8_t* cards = shoe.data();
+
+    // Shoes past the cut card are reshuffled between rounds. SimTable's Deck
+    // reshuffles the moment the cut card comes out, mid-round, so in shoes of
+    // a deck or two the two tables differ by the cut card effect (a few
+    // hundredths of a percent of EV).
+    for (int lane = 0; lane < lanes; ++lane) {
+        if (shoeSize - cursor[lane] <= cutPoint[lane]) shuffleLane(lane);
+    }
+
+    // Deal in SimTable's order: two to the seat, then up card and hole card
+    for (int lane = 0; lane < lanes; ++lane) {
+        roundStart[lane] = cursor[lane];
+        const uint8_t* next = cards + static_cast<size_t>(lane) * stride + cursor[lane];
+        uint8_t card1 = next[0], card2 = next[1], up = next[2], hole = next[3];
+        cursor[lane] += 4;
+
+        playerFirst[lane] = card1;
+        playerSecond[lane] = card2;
+        playerHard[lane] = card1 + card2;
+        playerSoft[lane] = (card1 == 1) | (card2 == 1);
+        dealerUp[lane] = up;
+        dealerHard[lane] = up + hole;
+        dealerSoft[lane] = (up == 1) | (hole == 1);
+        bet[lane] = 1;
+    }
+
+    // Naturals settle at once; everyone else takes a first decision
+    uint64_t blackjacks = 0;
+    for (int lane = 0; lane < lanes; ++lane) {
+        int dealerNatural = dealerSoft[lane] & (dealerHard[lane] == 11);
+        int playerNatural = playerSoft[lane] & (playerHard[lane] == 11);
+        net[lane] = dealerNatural ? (playerNatural ? 0.0 : -1.0) : (playerNatural ? rules.blackjackPayout : 0.0);
+        settled[lane] = static_cast<uint8_t>(dealerNatural | playerNatural);
+        blackjacks += static_cast<uint64_t>(playerNatural & !dealerNatural);
+    }
+    results.blackjacks += blackjacks;
+
+    splitLanes.clear();
+    for (int lane = 0; lane < lanes; ++lane) {
+        active[lane] = 0;
+        splitHandCount[lane] = 0;
+        if (settled[lane]) continue;
+
+        int first = playerFirst[lane];
+        bool pair = first == playerSecond[lane];
+        int total = bestTotal(playerHard[lane], playerSoft[lane]);
+        HandType type = pair ? HandType::PAIR
+                             : (total != playerHard[lane] ? HandType::SOFT : HandType::HARD);
+        Action action = firstAction[static_cast<int>(type)][pair ? first : total][dealerUp[lane]];
+
+        size_t base = static_cast<size_t>(lane) * stride;
+        switch (action) {
+            case Action::HIT: {
+                uint8_t card = cards[base + cursor[lane]++];
+                playerHard[lane] += card;
+                playerSoft[lane] |= card == 1;
+                active[lane] = bestTotal(playerHard[lane], playerSoft[lane]) < 21;
+                break;
+            }
+            case Action::DOUBLE: {
+                uint8_t card = cards[base + cursor[lane]++];
+                playerHard[lane] += card;
+                playerSoft[lane] |= card == 1;
+                bet[lane] = 2;
+                results.doubles++;
+                break;
+            }
+            case Action::SURRENDER:
+                net[lane] = -0.5;
+                settled[lane] = 1;
+                results.surrenders++;
+                break;
+            case Action::SPLIT:
+                splitLanes.push_back(lane);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Hit/stand draws until every lane stands, busts or reaches 21
+    for (bool drawing = true; drawing; ) {
+        int anyActive = 0;
+        for (int lane = 0; lane < lanes; ++lane) {
+            int hard = playerHard[lane];
+            int soft = playerSoft[lane];
+            int total = bestTotal(hard, soft);
+            int row = total != hard;
+            int hit = active[lane] & hitsAt[row][std::min(total, 21)][dealerUp[lane]];
+
+            uint8_t card = cards[static_cast<size_t>(lane) * stride + cursor[lane]];
+            hard += hit * card;
+            soft |= hit & (card == 1);
+            cursor[lane] += hit;
+            playerHard[lane] = static_cast<uint8_t>(hard);
+            playerSoft[lane] = static_cast<uint8_t>(soft);
+            active[lane] = static_cast<uint8_t>(hit & (bestTotal(hard, soft) < 21));
+            anyActive |= active[lane];
+        }
+        drawing = anyActive != 0;
+    }
+
+    // Split rounds are rare enough to play one lane at a time. One that
+    // ends near the bottom of the shoe gets the discards shuffled back in
+    // before the dealer draws.
+    for (int lane : splitLanes) {
+        playSplitLane(lane, results);
+        if (shoeSize - cursor[lane] < lockstep_reserve) refillLane(lane);
+    }
+
+    // The dealer only plays out lanes with a hand left to beat
+    for (int lane = 0; lane < lanes; ++lane) {
+        int live = !settled[lane] & (splitHandCount[lane] == 0) & (playerHard[lane] <= 21);
+        for (int hand = 0; hand < splitHandCount[lane]; ++hand) {
+            live |= splitHandTotal[static_cast<size_t>(lane) * maxHands + hand] <= 21;
+        }
+        dealerPlays[lane] = live;
+    }
+
+    DealerLanes dealerLanes{cards, stride, cursor.data(), dealerHard.data(), dealerSoft.data(),
+                            dealerPlays.data(), lanes};
+    playDealerLanes(dealerLanes, rules.dealerHitsSoft17, dealerKernel);
+
+    // Settle the unsplit hands branch-free, then any split hands
+    for (int lane = 0; lane < lanes; ++lane) {
+        int dealerTotal = bestTotal(dealerHard[lane], dealerSoft[lane]);
+        int playerTotal = bestTotal(playerHard[lane], playerSoft[lane]);
+        int playerBust = playerTotal > 21;
+        int dealerBust = dealerTotal > 21;
+        int sign = playerBust ? -1 : (dealerBust ? 1 : (playerTotal > dealerTotal) - (playerTotal < dealerTotal));
+        int played = !settled[lane] & (splitHandCount[lane] == 0);
+        net[lane] += played ? static_cast<double>(sign * bet[lane]) : 0.0;
+    }
+    for (int lane : splitLanes) {
+        int dealerTotal = bestTotal(dealerHard[lane], dealerSoft[lane]);
+        for (int hand = 0; hand < splitHandCount[lane]; ++hand) {
+            size_t slot = static_cast<size_t>(lane) * maxHands + hand;
+            int playerTotal = splitHandTotal[slot];
+            int handBet = splitHandBet[slot];
+            if (playerTotal > 21) net[lane] -= handBet;
+            else if (dealerTotal > 21 || playerTotal > dealerTotal) net[lane] += handBet;
+            else if (playerTotal < dealerTotal) net[lane] -= handBet;
+        }
+    }
+
+    for (int lane = 0; lane < lanes; ++lane) {
+        double value = net[lane];
+        results.wins += value > 0.0;
+        results.losses += value < 0.0;
+        results.pushes += value == 0.0;
+        results.unitsWon += value;
+        results.unitsWonSquared += value * value;
+    }
+    results.hands += static_cast<uint64_t>(lanes);
+}
+
+void BatchTable::playSplitLane(int lane, SimResults& results) {
+    SplitSeat seat = {};
+    seat.first = playerFirst[lane];
+    seat.second = playerSecond[lane];
+    seat.hard = playerHard[lane];
+    seat.soft = playerSoft[lane];
+    seat.cards = 2;
+    seat.bet = 1;
+
+    seats.clear();
+    seats.push_back(seat);
+
+    // Split hands are appended while we walk the list
+    for (size_t i = 0; i < seats.size(); ++i) {
+        playSplitSeat(lane, i, results);
+    }
+
+    splitHandCount[lane] = static_cast<uint8_t>(seats.size());
+    for (size_t i = 0; i < seats.size(); ++i) {
+        size_t slot = static_cast<size_t>(lane) * maxHands + i;
+        int total = bestTotal(seats[i].hard, seats[i].soft);
+        splitHandTotal[slot] = static_cast<uint8_t>(std::min(total, 22));
+        splitHandBet[slot] = seats[i].bet;
+    }
+}
+
+void BatchTable::playSplitSeat(int lane, size_t seatIndex, SimResults& results) {
+    bool firstDecision = true;
+
+    // Same decisions and rules as SimTable::playHand
+    while (true) {
+        SplitSeat& seat = seats[seatIndex];
+        int total = bestTotal(seat.hard, seat.soft);
+        if (total >= 21) return;
+
+        bool twoCards = seat.cards == 2;
+        bool pair = twoCards && seat.first == seat.second;
+        bool canSplit = pair && seats.size() < static_cast<size_t>(maxHands) &&
+                        (!seat.aceSplit || rules.resplitAces);
+
+        if (seat.aceSplit && !canSplit) return;
+
+        bool canDouble = twoCards && !seat.aceSplit && (!seat.fromSplit || rules.doubleAfterSplit);
+        bool canSurrender = rules.lateSurrender && firstDecision && twoCards && !seat.fromSplit;
+
+        HandType type = pair ? HandType::PAIR : (total != seat.hard ? HandType::SOFT : HandType::HARD);
+        Action action = strategy.lookupAction(type, pair ? seat.first : total, dealerUp[lane],
+                                              canDouble, canSurrender, canSplit);
+        firstDecision = false;
+
+        if (seat.aceSplit && action != Action::SPLIT) return;
+
+        switch (action) {
+            case Action::STAND:
+                return;
+
+            case Action::DOUBLE: {
+                uint8_t card = drawScalar(lane);
+                seat.hard += card;
+                seat.soft |= card == 1;
+                seat.cards++;
+                seat.bet = 2;
+                results.doubles++;
+                return;
+            }
+
+            case Action::SURRENDER:
+                seat.bet = 0;
+                results.surrenders++;
+                return;
+
+            case Action::SPLIT: {
+                results.splits++;
+                bool splittingAces = seat.first == 1;
+
+                // The hand being split is dealt to first, as in SplitHand
+                SplitSeat newSeat = {};
+                newSeat.first = seat.second;
+
+                seat.second = drawScalar(lane);
+                seat.hard = seat.first + seat.second;
+                seat.soft = (seat.first == 1) | (seat.second == 1);
+                seat.fromSplit = true;
+                seat.aceSplit = splittingAces;
+
+                newSeat.second = drawScalar(lane);
+                newSeat.hard = newSeat.first + newSeat.second;
+                newSeat.soft = (newSeat.first == 1) | (newSeat.second == 1);
+                newSeat.cards = 2;
+                newSeat.bet = 1;
+                newSeat.fromSplit = true;
+                newSeat.aceSplit = splittingAces;
+
+                // May reallocate; the loop refetches the seat
+                seats.insert(seats.begin() + seatIndex + 1, newSeat);
+                break;
+            }
+
+            case Action::HIT:
+            default: {
+                uint8_t card = drawScalar(lane);
+                seat.hard += card;
+                seat.soft |= card == 1;
+                seat.cards++;
+                break;
+            }
+        }
+    }
+}
+
+BatchSimulator::BatchSimulator(const SimConfig& simConfig, const BasicStrat& basicStrategy, int laneCount,
+                               DealerKernel kernel)
+    : config(simConfig), strategy(basicStrategy), lanes(laneCount), dealerKernel(kernel) {
+    requireBatchCut(config.rules, BatchTable::min_cut_card);
+}
+
+SimResults BatchSimulator::run() {
+    int workerCount = std::max(1, config.threads);
+    std::vector<SimResults> workerResults(workerCount);
+    std::vector<std::thread> workers;
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Worker streams as in Simulator::run
+    Rng stream(config.seed);
+
+    for (int w = 0; w < workerCount; ++w) {
+        uint64_t share = config.hands / workerCount +
+                         (static_cast<uint64_t>(w) < config.hands % workerCount ? 1 : 0);
+
+        workers.emplace_back([this, share, stream, &workerResults, w, &failure, &failureMutex]() {
+            try {
+                BatchTable table(strategy, stream, lanes, config.rules, dealerKernel);
+                SimResults& results = workerResults[w];
+
+                auto workerStart = std::chrono::steady_clock::now();
+                table.playRounds(share, results);
+                auto workerEnd = std::chrono::steady_clock::now();
+                results.elapsedSeconds = std::chrono::duration<double>(workerEnd - workerStart).count();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure) failure = std::current_exception();
+            }
+        });
+
+        stream.jump();
+    }
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+
+    SimResults total;
+    for (const SimResults& results : workerResults) {
+        total.merge(results);
+    }
+    total.elapsedSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    return total;
+}
@@ -0,0 +1,119 @@
+#ifndef BATCHSIM_H
+#define BATCHSIM_H
+
+#include <cstdint>
+#include <vector>
+#include "rng.h"
+#include "basicStrag.h"
+#include "Simulator.h"
+#include "DealerKernel.h"
+#include "TableRules.h"
+
+// Thousands of independent basic strategy seats, each on its own shoe, kept
+// as structure-of-arrays and advanced one phase at a time in lockstep:
+// deal, first decision, hit/stand draws, dealer draws, settlement. The draw
+// loops are branch-free over every lane, with finished lanes masked out, so
+// the compiler can vectorize them; the dealer draws go to DealerKernel. Rounds that split drop to a scalar path
+// with the same rules as SimTable.
+class BatchTable {
+private:
+    // Cards one unsplit round can take past the cut card: 4 dealt, 9 hits
+    // to 21 and 10 dealer draws. The cut card must leave at least this many,
+    // so lockstep draws never need a bounds check; the copy of the front of
+    // the shoe after each lane only pads reads that a masked lane discards.
+    static constexpr int lockstep_reserve = 24;
+
+    struct SplitSeat {
+        uint8_t first;
+        uint8_t second;
+        uint8_t hard;       // aces counted as 1
+        uint8_t soft;       // holds an ace
+        uint8_t cards;
+        uint8_t bet;
+        bool fromSplit;
+        bool aceSplit;
+    };
+
+    TableRules rules;
+    BasicStrat strategy;
+    Rng rng;
+    int laneCount;
+    int shoeSize;
+    int stride;                 // shoeSize + lockstep_reserve
+    int maxHands;
+    DealerKernel dealerKernel;
+
+    // The first decision of a dealt hand, and 1 where a hand past it hits:
+    // [handType or soft][value][dealerUp]
+    Action firstAction[StrategyTable::hand_types][StrategyTable::values][StrategyTable::dealer_cards];
+    uint8_t hitsAt[2][StrategyTable::values][StrategyTable::dealer_cards];
+
+    // Per lane
+    std::vector<uint8_t> shoe;          // card values 1-10, `stride` per lane
+    std::vector<int32_t> cursor;
+    std::vector<int32_t> cutPoint;
+    std::vector<int32_t> roundStart;    // cursor at this round's deal
+    std::vector<uint8_t> playerHard;
+    std::vector<uint8_t> playerSoft;
+    std::vector<uint8_t> playerFirst;
+    std::vector<uint8_t> playerSecond;
+    std::vector<uint8_t> bet;           // units at risk; 0 after surrender
+    std::vector<uint8_t> active;        // still taking hit/stand decisions
+    std::vector<uint8_t> dealerUp;
+    std::vector<int32_t> dealerHard;    // int32 for the dealer kernel
+    std::vector<int32_t> dealerSoft;
+    std::vector<int32_t> dealerPlays;   // some hand is still live
+    std::vector<uint8_t> settled;       // natural or surrender, already paid
+    std::vector<double> net;
+
+    // Lanes that split this round, and their finished hands
+    std::vector<int> splitLanes;
+    std::vector<uint8_t> splitHandCount;
+    std::vector<uint8_t> splitHandTotal;    // maxHands per lane; 22 is bust
+    std::vector<uint8_t> splitHandBet;
+    std::vector<SplitSeat> seats;           // scratch for the scalar path
+
+    void shuffleLane(int lane);
+    // For a split round about to run out of shoe: shuffles the cards dealt
+    // before it back in behind the undealt ones, as a dealer would, and
+    // reshuffles the lane after the round
+    void refillLane(int lane);
+    uint8_t drawScalar(int lane);
+    void playSplitLane(int lane, SimResults& results);
+    void playSplitSeat(int lane, size_t seatIndex, SimResults& results);
+    void playBatch(int lanes, SimResults& results);
+
+public:
+    // Lowest cutCardMin a batch table deals to
+    static constexpr int min_cut_card = lockstep_reserve;
+
+    // Throws std::invalid_argument for a cut card closer to the end than
+    // min_cut_card
+    BatchTable(const BasicStrat& basicStrategy, const Rng& stream, int lanes,
+               const TableRules& tableRules = TableRules(),
+               DealerKernel kernel = bestDealerKernel());
+
+    // Plays `rounds` rounds at one unit, `lanes` at a time
+    void playRounds(uint64_t rounds, SimResults& results);
+};
+
+// Simulator with a BatchTable per worker thread in place of a SimTable
+class BatchSimulator {
+private:
+    SimConfig config;
+    const BasicStrat& strategy;
+    int lanes;
+    DealerKernel dealerKernel;
+
+public:
+    static constexpr int default_lanes = 2048;
+
+    // Throws std::invalid_argument like BatchTable
+    BatchSimulator(const SimConfig& simConfig, const BasicStrat& basicStrategy,
+                   int laneCount = default_lanes, DealerKernel kernel = bestDealerKernel());
+
+    // Rethrows the first exception a worker threw, after every worker stops
+    SimResults run();
+};
+
+#endif
@@ -0,0 +1,129 @@
+#include "CompareSim.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+void PairedDifference::merge(const PairedDifference& other) {
+    rounds += other.rounds;
+    sum += other.sum;
+    sumSquared += other.sumSquared;
+}
+
+double PairedDifference::mean() const {
+    if (rounds == 0) return 0.0;
+    return sum / rounds;
+}
+
+double PairedDifference::standardError() const {
+    if (rounds < 2) return 0.0;
+    double average = mean();
+    double variance = std::max(0.0, (sumSquared - rounds * average * average) / (rounds - 1));
+    return std::sqrt(variance / rounds);
+}
+
+double ComparisonResults::independentStandardError(size_t policy) const {
+    const SimResults& baseline = policies[0];
+    const SimResults& other = policies[policy];
+    if (baseline.hands == 0 || other.hands == 0) return 0.0;
+
+    double baselineSd = baseline.standardDeviation();
+    double otherSd = other.standardDeviation();
+    return std::sqrt(baselineSd * baselineSd / baseline.hands + otherSd * otherSd / other.hands);
+}
+
+ComparisonSimulator::ComparisonSimulator(const SimConfig& simConfig,
+                                         const std::vector<const PlayerActionHandler*>& policies)
+    : config(simConfig), prototypes(policies) {
+    if (prototypes.empty()) {
+        throw std::invalid_argument("A comparison needs at least one policy");
+    }
+}
+
+ComparisonResults ComparisonSimulator::run() {
+    int workerCount = std::max(1, config.threads);
+    size_t policyCount = prototypes.size();
+    std::vector<ComparisonResults> workerResults(workerCount);
+    std::vector<std::thread> workers;
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Same streams and shoe assignment as Simulator, so the baseline plays
+    // exactly the rounds a plain run with this seed would
+    Rng stream(config.seed);
+
+    for (int w = 0; w < workerCount; ++w) {
+        uint64_t share = config.hands / workerCount +
+                         (static_cast<uint64_t>(w) < config.hands % workerCount ? 1 : 0);
+
+        workers.emplace_back([this, share, stream, &workerResults, w, workerCount, policyCount,
+                              &failure, &failureMutex]() {
+            try {
+                std::vector<std::unique_ptr<PlayerActionHandler>> policies;
+                std::vector<std::unique_ptr<SimTable>> tables;
+                for (const PlayerActionHandler* prototype : prototypes) {
+                    policies.push_back(prototype->clone());
+                    tables.push_back(std::make_unique<SimTable>(*policies.back(), stream, config.rules));
+                    if (config.shoes) {
+                        tables.back()->useShoeFile(config.shoes, static_cast<uint64_t>(w),
+                                                   static_cast<uint64_t>(workerCount));
+                    }
+                }
+
+                ComparisonResults& results = workerResults[w];
+                results.policies.resize(policyCount);
+                results.differences.resize(policyCount);
+
+                auto workerStart = std::chrono::steady_clock::now();
+                for (uint64_t i = 0; i < share; ++i) {
+                    for (size_t p = 1; p < policyCount; ++p) {
+                        tables[p]->matchShoe(*tables[0]);
+                    }
+                    double baseline = tables[0]->playRound(results.policies[0]);
+                    for (size_t p = 1; p < policyCount; ++p) {
+                        double net = tables[p]->playRound(results.policies[p]);
+                        results.differences[p].add(net - baseline);
+                    }
+                }
+                auto workerEnd = std::chrono::steady_clock::now();
+                results.elapsedSeconds = std::chrono::duration<double>(workerEnd - workerStart).count();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure) failure = std::current_exception();
+            }
+        });
+
+        stream.jump();
+    }
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+
+    ComparisonResults total;
+    total.policies.resize(policyCount);
+    total.differences.resize(policyCount);
+    for (const ComparisonResults& results : workerResults) {
+        for (size_t p = 0; p < policyCount; ++p) {
+            total.policies[p].merge(results.policies[p]);
+            total.differences[p].merge(results.differences[p]);
+        }
+    }
+    total.elapsedSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    for (SimResults& results : total.policies) {
+        results.elapsedSeconds = total.elapsedSeconds;
+    }
+
+    return total;
+}
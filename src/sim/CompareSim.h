@@ -0,0 +1,59 @@
+#ifndef COMPARESIM_H
+#define COMPARESIM_H
+
+#include <cstdint>
+#include <vector>
+#include "Simulator.h"
+#include "PlayerActionHandler.h"
+
+// Per-round difference between one policy and the baseline, summed over
+// rounds played on the same cards
+struct PairedDifference {
+    uint64_t rounds;
+    double sum;
+    double sumSquared;
+
+    PairedDifference() : rounds(0), sum(0.0), sumSquared(0.0) {}
+
+    void add(double difference) {
+        rounds++;
+        sum += difference;
+        sumSquared += difference * difference;
+    }
+    void merge(const PairedDifference& other);
+    double mean() const;                // units per round
+    double standardError() const;
+};
+
+struct ComparisonResults {
+    std::vector<SimResults> policies;           // in the order given; 0 is the baseline
+    std::vector<PairedDifference> differences;  // [p] is policy p minus the baseline
+    double elapsedSeconds;
+
+    ComparisonResults() : elapsedSeconds(0.0) {}
+
+    // The standard error two unpaired runs of the same length would give
+    double independentStandardError(size_t policy) const;
+};
+
+// Plays every policy on common random numbers: before each round, each
+// policy's table is set to the baseline table's place in its shoe, so all
+// of them are dealt the same cards, split and draw cards included. The
+// baseline's play decides how far the shoe advances. Each round's cards are
+// copied from the shoe already in cache, not shuffled again, so an extra
+// policy costs only its own play, and the paired EV differences need far
+// fewer rounds for the same interval than separate runs would.
+class ComparisonSimulator {
+private:
+    SimConfig config;
+    std::vector<const PlayerActionHandler*> prototypes;
+
+public:
+    // policies[0] is the baseline; all must outlive run()
+    ComparisonSimulator(const SimConfig& simConfig, const std::vector<const PlayerActionHandler*>& policies);
+
+    // Rethrows the first exception a worker hit, once all have stopped
+    ComparisonResults run();
+};
+
+#endif
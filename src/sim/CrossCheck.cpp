@@ -0,0 +1,71 @@
+#include "CrossCheck.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include "GameEngine.h"
+
+namespace {
+
+// GameEngine narrates every round to std::cout; keep it quiet while the
+// check runs, and restore the console even if it throws
+class MutedConsole {
+private:
+    std::streambuf* console;
+
+public:
+    MutedConsole() : console(std::cout.rdbuf(nullptr)) {}
+    ~MutedConsole() { std::cout.rdbuf(console); }
+
+    MutedConsole(const MutedConsole&) = delete;
+    MutedConsole& operator=(const MutedConsole&) = delete;
+};
+
+}
+
+EngineCrossCheck::EngineCrossCheck(const SimConfig& simConfig, const PlayerActionHandler& policy)
+    : config(simConfig), prototype(policy) {}
+
+SimResults EngineCrossCheck::run() {
+    std::unique_ptr<PlayerActionHandler> tablePolicy = prototype.clone();
+    std::unique_ptr<PlayerActionHandler> enginePolicy = prototype.clone();
+
+    SimTable table(*tablePolicy, Rng(config.seed), config.rules);
+    Deck engineDeck(config.rules, config.seed);
+    if (config.shoes) {
+        table.useShoeFile(config.shoes, 0, 1);
+        engineDeck.useShoeFile(config.shoes, 0, 1);
+    }
+
+    SimResults results;
+    auto start = std::chrono::steady_clock::now();
+    {
+        MutedConsole muted;
+        GameEngine engine(engineDeck);
+        engine.addPlayer(sim_seat_name);
+        engine.setActionHandler(enginePolicy.get());
+
+        for (uint64_t round = 1; round <= config.hands; ++round) {
+            engineDeck.matchShoe(table.getDeck());
+            uint64_t splitsBefore = results.splits;
+
+            double tableNet = table.playRound(results);
+            engine.playGame();
+            double engineNet = engine.getRoundUnitsWon(0);
+
+            // Only the net is compared: the engine also lets the dealer draw
+            // to a lone blackjack, which moves the shoe but not the result
+            if (tableNet != engineNet) {
+                std::ostringstream message;
+                message << "Round " << round << (results.splits > splitsBefore ? " (split)" : "")
+                        << ": SimTable nets " << tableNet << ", GameEngine nets " << engineNet;
+                throw std::runtime_error(message.str());
+            }
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    results.elapsedSeconds = std::chrono::duration<double>(end - start).count();
+    return results;
+}
@@ -0,0 +1,27 @@
+#ifndef CROSSCHECK_H
+#define CROSSCHECK_H
+
+#include "Simulator.h"
+#include "PlayerActionHandler.h"
+
+// SimTable plays the rules again, apart from GameEngine and SplitHand, for
+// speed. This replays a SimTable's shoe through a one-seat GameEngine:
+// before each round the engine's deck is set to the table's place in its
+// shoe, both play the round with their own copy of the policy, and the
+// seat's net must come out the same, split and resplit hands included.
+class EngineCrossCheck {
+private:
+    SimConfig config;
+    const PlayerActionHandler& prototype;
+
+public:
+    // `policy` must outlive run()
+    EngineCrossCheck(const SimConfig& simConfig, const PlayerActionHandler& policy);
+
+    // Plays config.hands rounds on one thread, with GameEngine's console
+    // output muted, and returns the table's totals. Throws
+    // std::runtime_error naming the first round the two disagree on.
+    SimResults run();
+};
+
+#endif
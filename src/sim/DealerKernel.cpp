@@ -0,0 +1,246 @@
+#include "DealerKernel.h"
+#include "rng.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define DEALER_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+void playScalar(const DealerLanes& lanes, bool hitsSoft17, int first) {
+    for (int lane = first; lane < lanes.count; ++lane) {
+        if (!lanes.live[lane]) continue;
+
+        const uint8_t* cards = lanes.shoe + static_cast<size_t>(lane) * lanes.stride;
+        int hard = lanes.hard[lane];
+        int soft = lanes.soft[lane];
+        int position = lanes.cursor[lane];
+        while (true) {
+            int total = hard + ((soft && hard <= 11) ? 10 : 0);
+            bool softSeventeen = total == 17 && soft && hard == 7;
+            if (total > 17 || (total == 17 && !(hitsSoft17 && softSeventeen))) break;
+
+            uint8_t card = cards[position++];
+            hard += card;
+            if (card == 1) soft = 1;
+        }
+        lanes.hard[lane] = hard;
+        lanes.soft[lane] = soft;
+        lanes.cursor[lane] = position;
+        lanes.live[lane] = 0;
+    }
+}
+
+#ifdef DEALER_KERNEL_X86
+
+// Both SIMD kernels keep a block of lanes in registers until every lane in
+// it stands, then move to the next block; leftover lanes go to playScalar.
+// Masks are all ones in a lane that still hits.
+
+__attribute__((target("sse2")))
+int playSse(const DealerLanes& lanes, bool hitsSoft17) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i ten = _mm_set1_epi32(10);
+    const __m128i twelve = _mm_set1_epi32(12);
+    const __m128i seventeen = _mm_set1_epi32(17);
+    const __m128i softHits = _mm_set1_epi32(hitsSoft17 ? -1 : 0);
+
+    int lane = 0;
+    for (; lane + 4 <= lanes.count; lane += 4) {
+        __m128i playing = _mm_cmpgt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes.live + lane)), zero);
+        if (_mm_movemask_epi8(playing) == 0) continue;
+
+        __m128i hard = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes.hard + lane));
+        __m128i soft = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes.soft + lane));
+        __m128i cursor = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes.cursor + lane));
+        const uint8_t* cards = lanes.shoe + static_cast<size_t>(lane) * lanes.stride;
+
+        while (true) {
+            __m128i aceHigh = _mm_and_si128(_mm_cmpgt_epi32(soft, zero), _mm_cmpgt_epi32(twelve, hard));
+            __m128i total = _mm_add_epi32(hard, _mm_and_si128(aceHigh, ten));
+            __m128i softSeventeen = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi32(total, seventeen), aceHigh), softHits);
+            __m128i hit = _mm_and_si128(playing, _mm_or_si128(_mm_cmpgt_epi32(seventeen, total), softSeventeen));
+            if (_mm_movemask_epi8(hit) == 0) break;
+
+            // SSE2 has no gather; load the four cards one by one
+            alignas(16) int32_t position[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(position), cursor);
+            __m128i card = _mm_setr_epi32(cards[position[0]],
+                                          cards[lanes.stride + position[1]],
+                                          cards[2 * lanes.stride + position[2]],
+                                          cards[3 * lanes.stride + position[3]]);
+            card = _mm_and_si128(card, hit);
+
+            hard = _mm_add_epi32(hard, card);
+            soft = _mm_or_si128(soft, _mm_and_si128(_mm_cmpeq_epi32(card, one), one));
+            cursor = _mm_sub_epi32(cursor, hit);
+            playing = hit;
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.hard + lane), hard);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.soft + lane), soft);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.cursor + lane), cursor);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.live + lane), zero);
+    }
+    return lane;
+}
+
+__attribute__((target("avx2")))
+int playAvx2(const DealerLanes& lanes, bool hitsSoft17) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i ten = _mm256_set1_epi32(10);
+    const __m256i twelve = _mm256_set1_epi32(12);
+    const __m256i seventeen = _mm256_set1_epi32(17);
+    const __m256i lowByte = _mm256_set1_epi32(0xFF);
+    const __m256i softHits = _mm256_set1_epi32(hitsSoft17 ? -1 : 0);
+    const __m256i laneOffsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                                   _mm256_set1_epi32(lanes.stride));
+
+    int lane = 0;
+    for (; lane + 8 <= lanes.count; lane += 8) {
+        __m256i playing = _mm256_cmpgt_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes.live + lane)), zero);
+        if (_mm256_testz_si256(playing, playing)) continue;
+
+        __m256i hard = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes.hard + lane));
+        __m256i soft = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes.soft + lane));
+        __m256i cursor = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes.cursor + lane));
+        const int* cards = reinterpret_cast<const int*>(lanes.shoe + static_cast<size_t>(lane) * lanes.stride);
+
+        while (true) {
+            __m256i aceHigh = _mm256_and_si256(_mm256_cmpgt_epi32(soft, zero), _mm256_cmpgt_epi32(twelve, hard));
+            __m256i total = _mm256_add_epi32(hard, _mm256_and_si256(aceHigh, ten));
+            __m256i softSeventeen = _mm256_and_si256(_mm256_and_si256(_mm256_cmpeq_epi32(total, seventeen), aceHigh),
+                                                     softHits);
+            __m256i hit = _mm256_and_si256(playing, _mm256_or_si256(_mm256_cmpgt_epi32(seventeen, total), softSeventeen));
+            if (_mm256_testz_si256(hit, hit)) break;
+
+            // Gathers four bytes from each hitting lane and keeps the first
+            __m256i card = _mm256_mask_i32gather_epi32(zero, cards, _mm256_add_epi32(laneOffsets, cursor), hit, 1);
+            card = _mm256_and_si256(card, lowByte);
+
+            hard = _mm256_add_epi32(hard, card);
+            soft = _mm256_or_si256(soft, _mm256_and_si256(_mm256_cmpeq_epi32(card, one), one));
+            cursor = _mm256_sub_epi32(cursor, hit);
+            playing = hit;
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes.hard + lane), hard);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes.soft + lane), soft);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes.cursor + lane), cursor);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes.live + lane), zero);
+    }
+    return lane;
+}
+
+#endif
+
+DealerKernel detectDealerKernel() {
+#ifdef DEALER_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return DealerKernel::AVX2;
+    if (__builtin_cpu_supports("sse2")) return DealerKernel::SSE;
+#endif
+    return DealerKernel::SCALAR;
+}
+
+}
+
+DealerKernel bestDealerKernel() {
+    static const DealerKernel best = detectDealerKernel();
+    return best;
+}
+
+bool dealerKernelSupported(DealerKernel kernel) {
+    return static_cast<int>(kernel) <= static_cast<int>(bestDealerKernel());
+}
+
+const char* dealerKernelName(DealerKernel kernel) {
+    switch (kernel) {
+        case DealerKernel::SCALAR: return "scalar";
+        case DealerKernel::SSE: return "sse";
+        case DealerKernel::AVX2: return "avx2";
+        default: return "unknown";
+    }
+}
+
+DealerKernel parseDealerKernel(const std::string& name) {
+    if (name == "scalar") return DealerKernel::SCALAR;
+    if (name == "sse") return DealerKernel::SSE;
+    if (name == "avx2") return DealerKernel::AVX2;
+    throw std::invalid_argument("Unknown dealer kernel: " + name);
+}
+
+void playDealerLanes(const DealerLanes& lanes, bool hitsSoft17, DealerKernel kernel) {
+    if (!dealerKernelSupported(kernel)) {
+        throw std::runtime_error(std::string("This CPU cannot run the ") + dealerKernelName(kernel) + " dealer kernel");
+    }
+
+    int first = 0;
+#ifdef DEALER_KERNEL_X86
+    if (kernel == DealerKernel::AVX2) first = playAvx2(lanes, hitsSoft17);
+    else if (kernel == DealerKernel::SSE) first = playSse(lanes, hitsSoft17);
+#endif
+    playScalar(lanes, hitsSoft17, first);
+}
+
+uint64_t verifyDealerKernel(DealerKernel kernel, uint64_t seed, int rounds) {
+    // Odd so both SIMD kernels leave lanes for the scalar tail
+    constexpr int lanes = 19;
+    // Longest dealer hand is under 26 cards; starts vary to shift the gathers
+    constexpr int max_start = 40;
+    constexpr int stride = max_start + 32;
+
+    Rng rng(seed);
+    std::vector<uint8_t> shoe(lanes * stride + dealer_kernel_padding);
+    std::vector<int32_t> cursor[2], hard[2], soft[2], live[2];
+    for (int k = 0; k < 2; ++k) {
+        cursor[k].resize(lanes);
+        hard[k].resize(lanes);
+        soft[k].resize(lanes);
+        live[k].resize(lanes);
+    }
+
+    uint64_t compared = 0;
+    for (int round = 0; round < rounds; ++round) {
+        for (uint8_t& card : shoe) {
+            card = static_cast<uint8_t>(std::min<uint32_t>(rng.bounded(13) + 1, 10));
+        }
+        for (int lane = 0; lane < lanes; ++lane) {
+            // The dealer's two cards come from the same distribution
+            int card1 = std::min<int>(static_cast<int>(rng.bounded(13)) + 1, 10);
+            int card2 = std::min<int>(static_cast<int>(rng.bounded(13)) + 1, 10);
+            cursor[0][lane] = static_cast<int32_t>(rng.bounded(max_start + 1));
+            hard[0][lane] = card1 + card2;
+            soft[0][lane] = (card1 == 1 || card2 == 1) ? 1 : 0;
+            live[0][lane] = rng.bounded(8) != 0 ? 1 : 0;
+        }
+        cursor[1] = cursor[0];
+        hard[1] = hard[0];
+        soft[1] = soft[0];
+        live[1] = live[0];
+
+        bool hitsSoft17 = (round & 1) != 0;
+        playDealerLanes(DealerLanes{shoe.data(), stride, cursor[0].data(), hard[0].data(), soft[0].data(),
+                                    live[0].data(), lanes}, hitsSoft17, kernel);
+        playDealerLanes(DealerLanes{shoe.data(), stride, cursor[1].data(), hard[1].data(), soft[1].data(),
+                                    live[1].data(), lanes}, hitsSoft17, DealerKernel::SCALAR);
+
+        for (int lane = 0; lane < lanes; ++lane) {
+            if (cursor[0][lane] != cursor[1][lane] || hard[0][lane] != hard[1][lane] ||
+                soft[0][lane] != soft[1][lane] || live[0][lane] != live[1][lane]) {
+                throw std::runtime_error(std::string("The ") + dealerKernelName(kernel) +
+                                         " dealer kernel disagrees with scalar in round " + std::to_string(round) +
+                                         ", lane " + std::to_string(lane));
+            }
+        }
+        compared += lanes;
+    }
+    return compared;
+}
@@ -0,0 +1,51 @@
+#ifndef DEALERKERNEL_H
+#define DEALERKERNEL_H
+
+#include <cstdint>
+#include <string>
+
+// Plays out many dealer hands at once: every live lane draws until it
+// stands, on 17 or on hard 17 under H17. Lanes that are not live are left
+// untouched, and lanes that stand or bust are masked off while the rest
+// keep drawing.
+//
+// Lane i draws shoe[i * stride + cursor[i]] next. The SIMD kernels read
+// four bytes per card, so the shoe must stay readable for
+// dealer_kernel_padding bytes past the last card any lane can draw.
+struct DealerLanes {
+    const uint8_t* shoe;    // card values 1-10
+    int stride;
+    int32_t* cursor;
+    int32_t* hard;          // aces counted as 1
+    int32_t* soft;          // 1 when the hand holds an ace
+    int32_t* live;          // 1 to play the lane; 0 on return
+    int count;
+};
+
+constexpr int dealer_kernel_padding = 3;
+
+enum class DealerKernel {
+    SCALAR,     // one lane at a time; the reference the others must match
+    SSE,        // four lanes per step, SSE2
+    AVX2        // eight lanes per step with gathered card loads
+};
+
+// Widest kernel this CPU runs; checked once at startup
+DealerKernel bestDealerKernel();
+bool dealerKernelSupported(DealerKernel kernel);
+
+const char* dealerKernelName(DealerKernel kernel);
+DealerKernel parseDealerKernel(const std::string& name);   // throws std::invalid_argument
+
+// Throws std::runtime_error if the CPU cannot run `kernel`
+void playDealerLanes(const DealerLanes& lanes, bool hitsSoft17, DealerKernel kernel);
+inline void playDealerLanes(const DealerLanes& lanes, bool hitsSoft17) {
+    playDealerLanes(lanes, hitsSoft17, bestDealerKernel());
+}
+
+// Plays `rounds` sets of random lanes, some idle, under H17 and S17
+// through `kernel` and the scalar kernel. Throws std::runtime_error
+// naming the first lane they disagree on; returns the lanes compared.
+uint64_t verifyDealerKernel(DealerKernel kernel, uint64_t seed, int rounds);
+
+#endif
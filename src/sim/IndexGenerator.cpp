@@ -0,0 +1,276 @@
+#include "IndexGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "StrategyGenerator.h"
+
+namespace {
+
+// Actions a plays entry may switch between
+const Action play_actions[] = {Action::HIT, Action::STAND, Action::DOUBLE, Action::SPLIT};
+
+// The hand classes the generator looks at; other rows keep the table
+struct CellRange {
+    HandType type;
+    int first;
+    int last;
+};
+
+const CellRange cell_ranges[] = {
+    {HandType::HARD, 5, 20},
+    {HandType::SOFT, 13, 20},
+    {HandType::PAIR, 1, 10}
+};
+
+}
+
+IndexGenerator::IndexGenerator(const TableRules& tableRules, const StrategyTable& baseTable,
+                               double remaining, int minTc, int maxTc)
+    : rules(tableRules), table(baseTable), decksRemaining(remaining),
+      minTrueCount(minTc), maxTrueCount(maxTc) {}
+
+ShoeComposition IndexGenerator::conditionedShoe(const CountTags& tags, double trueCount) const {
+    ShoeComposition full = EVAnalyzer::fullShoe(rules.numDecks);
+    int fullCards = rules.totalCards();
+    int cards = std::max(1, std::min(fullCards, static_cast<int>(std::lround(decksRemaining * 52.0))));
+
+    double fullTags = 0.0;
+    for (int rank = 0; rank < PackedCard::rank_count; ++rank) {
+        fullTags += tags[rank] * full[rank];
+    }
+
+    // The dealt cards carry the running count, so the undealt ones must
+    // add up to what is left of the full shoe's tags
+    double targetTags = fullTags - trueCount * (cards / 52.0);
+
+    // Exponential tilt: rank r keeps full[r] * exp(-lambda * tag[r]),
+    // scaled to `cards`. The tag sum falls as lambda grows.
+    auto tiltedShoe = [&](double lambda, double* shoe) {
+        double total = 0.0;
+        for (int rank = 0; rank < PackedCard::rank_count; ++rank) {
+            shoe[rank] = full[rank] * std::exp(-lambda * tags[rank]);
+            total += shoe[rank];
+        }
+        double tagSum = 0.0;
+        for (int rank = 0; rank < PackedCard::rank_count; ++rank) {
+            shoe[rank] = std::min<double>(full[rank], shoe[rank] * cards / total);
+            tagSum += tags[rank] * shoe[rank];
+        }
+        return tagSum;
+    };
+
+    double shoe[PackedCard::rank_count];
+    double low = -20.0;
+    double high = 20.0;
+    for (int step = 0; step < 100; ++step) {
+        double lambda = 0.5 * (low + high);
+        if (tiltedShoe(lambda, shoe) > targetTags) low = lambda;
+        else high = lambda;
+    }
+    tiltedShoe(0.5 * (low + high), shoe);
+
+    // Whole cards by largest remainder, keeping the total
+    ShoeComposition counts;
+    int assigned = 0;
+    double remainders[PackedCard::rank_count];
+    for (int rank = 0; rank < PackedCard::rank_count; ++rank) {
+        counts[rank] = static_cast<int>(std::floor(shoe[rank]));
+        remainders[rank] = shoe[rank] - counts[rank];
+        assigned += counts[rank];
+    }
+    while (assigned < cards) {
+        int best = -1;
+        for (int rank = 0; rank < PackedCard::rank_count; ++rank) {
+            if (counts[rank] < full[rank] && (best < 0 || remainders[rank] > remainders[best])) best = rank;
+        }
+        if (best < 0) break;
+        counts[best]++;
+        remainders[best] = -1.0;
+        assigned++;
+    }
+    return counts;
+}
+
+double IndexGenerator::trueCountOf(const CountTags& tags, const ShoeComposition& shoe) const {
+    ShoeComposition full = EVAnalyzer::fullShoe(rules.numDecks);
+    int runningCount = 0;
+    int cards = 0;
+    for (int rank = 0; rank < PackedCard::rank_count; ++rank) {
+        runningCount += tags[rank] * (full[rank] - shoe[rank]);
+        cards += shoe[rank];
+    }
+    return cards > 0 ? runningCount / (cards / 52.0) : 0.0;
+}
+
+void IndexGenerator::analyzeColumn(int dealerUp, const CountTags& tags, std::vector<ColumnEV>& grid) const {
+    StrategyGenerator averager(rules);
+
+    for (int tc = minTrueCount; tc <= maxTrueCount; ++tc) {
+        ColumnEV& column = grid[tc - minTrueCount];
+        column.shoe = conditionedShoe(tags, tc);
+        column.trueCount = trueCountOf(tags, column.shoe);
+        column.valid = column.shoe[dealerUp - 1] > 0;
+        if (!column.valid) continue;
+
+        // A fresh analyzer per composition keeps the caches small
+        EVAnalyzer analyzer(rules);
+        ShoeComposition shoe = column.shoe;
+        shoe[dealerUp - 1]--;
+
+        for (const CellRange& range : cell_ranges) {
+            for (int value = range.first; value <= range.last; ++value) {
+                column.cells[static_cast<int>(range.type)][value] =
+                    averager.averageEV(analyzer, shoe, dealerUp, StrategyGenerator::cellHands(range.type, value),
+                                       false, range.type == HandType::PAIR);
+            }
+        }
+    }
+}
+
+bool IndexGenerator::findCrossing(const std::vector<double>& trueCounts, const std::vector<double>& gain,
+                                  size_t start, int direction, double& crossing) {
+    // Walks away from `start` until gain turns positive, then interpolates
+    // the true count where it crossed zero
+    for (size_t i = start; ; ) {
+        size_t next = direction > 0 ? i + 1 : i - 1;
+        if ((direction > 0 && next >= gain.size()) || (direction < 0 && i == 0)) return false;
+
+        if (gain[i] <= 0.0 && gain[next] > 0.0) {
+            double t = gain[i] / (gain[i] - gain[next]);
+            crossing = trueCounts[i] + t * (trueCounts[next] - trueCounts[i]);
+            return true;
+        }
+        i = next;
+    }
+}
+
+void IndexGenerator::findColumnIndices(int dealerUp, const std::vector<ColumnEV>& grid,
+                                       IndexTable& indices) const {
+    std::vector<double> trueCounts;
+    std::vector<const ColumnEV*> columns;
+    for (const ColumnEV& column : grid) {
+        if (!column.valid) continue;
+        trueCounts.push_back(column.trueCount);
+        columns.push_back(&column);
+    }
+    if (columns.size() < 2) return;
+
+    // Start from the composition closest to a neutral count
+    size_t start = 0;
+    for (size_t i = 1; i < trueCounts.size(); ++i) {
+        if (std::fabs(trueCounts[i]) < std::fabs(trueCounts[start])) start = i;
+    }
+
+    for (const CellRange& range : cell_ranges) {
+        int row = static_cast<int>(range.type);
+
+        for (int value = range.first; value <= range.last; ++value) {
+            Action primary = table.primary[row][value][dealerUp];
+            Action base = primary == Action::SURRENDER ? table.fallback[row][value][dealerUp] : primary;
+
+            // Plays: the alternative that overtakes the table's action
+            // closest to a neutral count
+            bool found = false;
+            double bestCrossing = 0.0;
+            Action bestAction = base;
+            int bestDirection = 0;
+
+            for (Action alternative : play_actions) {
+                if (alternative == base) continue;
+                if (alternative == Action::SPLIT && range.type != HandType::PAIR) continue;
+
+                std::vector<double> gain;
+                for (const ColumnEV* column : columns) {
+                    const ActionEV& ev = column->cells[row][value];
+                    gain.push_back(ev.getEV(alternative) - ev.getEV(base));
+                }
+                if (gain[start] > 0.0) continue;  // the table disagrees at this depth
+
+                for (int direction : {+1, -1}) {
+                    double crossing;
+                    if (findCrossing(trueCounts, gain, start, direction, crossing) &&
+                        (!found || std::fabs(crossing) < std::fabs(bestCrossing))) {
+                        found = true;
+                        bestCrossing = crossing;
+                        bestAction = alternative;
+                        bestDirection = direction;
+                    }
+                }
+            }
+
+            if (found) {
+                float index = static_cast<float>(std::round(bestCrossing));
+                if (bestDirection > 0) {
+                    indices.setPlay(range.type, value, dealerUp, index, bestAction, base);
+                } else {
+                    indices.setPlay(range.type, value, dealerUp, index, base, bestAction);
+                }
+            }
+
+            // Surrender: where giving up half beats the best way to play on
+            if (!rules.lateSurrender || range.type == HandType::PAIR) continue;
+
+            std::vector<double> gain;
+            for (const ColumnEV* column : columns) {
+                const ActionEV& ev = column->cells[row][value];
+                double playOn = std::max(ev.getEV(Action::HIT),
+                                         std::max(ev.getEV(Action::STAND), ev.getEV(Action::DOUBLE)));
+                gain.push_back(-0.5 - playOn);
+            }
+
+            // Where the table surrenders, look down for the count below
+            // which playing on is better; elsewhere look up
+            double crossing;
+            bool crosses = false;
+            if (primary == Action::SURRENDER) {
+                std::vector<double> playOnGain;
+                for (double value : gain) playOnGain.push_back(-value);
+                crosses = gain[start] > 0.0 && findCrossing(trueCounts, playOnGain, start, -1, crossing);
+            } else {
+                crosses = gain[start] <= 0.0 && findCrossing(trueCounts, gain, start, +1, crossing);
+            }
+            if (crosses) {
+                indices.setSurrender(range.type, value, dealerUp, static_cast<float>(std::round(crossing)));
+            }
+        }
+    }
+}
+
+IndexTable IndexGenerator::generate(const CountTags& tags, int threads) const {
+    IndexTable indices;
+    size_t gridSize = static_cast<size_t>(maxTrueCount - minTrueCount + 1);
+    std::vector<std::vector<ColumnEV>> grids(11, std::vector<ColumnEV>(gridSize));
+
+    forEachUpcard(threads, [this, &tags, &grids](int dealerUp) {
+        analyzeColumn(dealerUp, tags, grids[dealerUp]);
+    });
+
+    // The search is cheap next to the analysis
+    for (int dealerUp = 1; dealerUp <= 10; ++dealerUp) {
+        findColumnIndices(dealerUp, grids[dealerUp], indices);
+    }
+
+    // Insurance wins 2:1 when the hole card under an ace is a ten
+    std::vector<double> trueCounts;
+    std::vector<double> gain;
+    for (int tc = minTrueCount; tc <= maxTrueCount; ++tc) {
+        ShoeComposition shoe = conditionedShoe(tags, tc);
+        int cards = 0;
+        for (int count : shoe) cards += count;
+        if (shoe[0] == 0 || cards < 2) continue;
+
+        double tenChance = static_cast<double>(shoe[PackedCard::rank_count - 1]) / (cards - 1);
+        trueCounts.push_back(trueCountOf(tags, shoe));
+        gain.push_back(3.0 * tenChance - 1.0);
+    }
+
+    double crossing;
+    if (!gain.empty() && findCrossing(trueCounts, gain, 0, +1, crossing)) {
+        indices.insuranceIndex = static_cast<float>(std::round(crossing * 10.0) / 10.0);
+    } else {
+        indices.insuranceIndex = static_cast<float>(maxTrueCount + 1);
+    }
+
+    return indices;
+}
@@ -0,0 +1,52 @@
+#ifndef INDEXGENERATOR_H
+#define INDEXGENERATOR_H
+
+#include <vector>
+#include "EVAnalyzer.h"
+#include "IndexPlays.h"
+#include "MultiCount.h"
+#include "StrategyTables.h"
+#include "TableRules.h"
+
+// Derives index plays for a counting system from EVAnalyzer. For every
+// whole true count in range it builds the shoe a counter expects to see at
+// that count, then finds where another action's EV overtakes the table's
+// action in each cell.
+class IndexGenerator {
+private:
+    TableRules rules;
+    StrategyTable table;
+    double decksRemaining;
+    int minTrueCount;
+    int maxTrueCount;
+
+    // Action EVs of every cell for one upcard at one true count
+    struct ColumnEV {
+        double trueCount;               // of the rounded composition
+        ShoeComposition shoe;
+        ActionEV cells[StrategyTable::hand_types][StrategyTable::values];
+        bool valid;
+    };
+
+    void analyzeColumn(int dealerUp, const CountTags& tags, std::vector<ColumnEV>& grid) const;
+    void findColumnIndices(int dealerUp, const std::vector<ColumnEV>& grid, IndexTable& indices) const;
+    static bool findCrossing(const std::vector<double>& trueCounts, const std::vector<double>& gain,
+                             size_t start, int direction, double& crossing);
+
+public:
+    // `table` is the strategy the indices deviate from. The compositions
+    // have `decksRemaining` decks left in the shoe.
+    IndexGenerator(const TableRules& tableRules, const StrategyTable& baseTable,
+                   double remaining, int minTc = -8, int maxTc = 10);
+
+    // Expected undealt cards at `trueCount` for a count with these tags:
+    // the full shoe tilted toward low or high tags until the running count
+    // of the dealt cards, divided by the decks left, equals the true count
+    ShoeComposition conditionedShoe(const CountTags& tags, double trueCount) const;
+    double trueCountOf(const CountTags& tags, const ShoeComposition& shoe) const;
+
+    // Upcards are worked on in parallel
+    IndexTable generate(const CountTags& tags, int threads = 1) const;
+};
+
+#endif
@@ -0,0 +1,88 @@
+#include "RuleOptions.h"
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+void printRuleOptions() {
+    std::cout << "Rule options (default 8D S17 DAS NRSA LS 3:2):" << std::endl;
+    std::cout << "  --decks N         Decks in the shoe, 1 to " << TableRules::max_decks << std::endl;
+    std::cout << "  --cut MIN-MAX     Cut card position, cards from the end (default 60-80)" << std::endl;
+    std::cout << "  --h17 / --s17     Dealer hits / stands on soft 17" << std::endl;
+    std::cout << "  --das / --no-das  Double after split" << std::endl;
+    std::cout << "  --rsa / --no-rsa  Resplit aces" << std::endl;
+    std::cout << "  --ls / --no-ls    Late surrender" << std::endl;
+    std::cout << "  --max-hands N     Most hands a seat can split into, 1 to " << TableRules::max_split_hands
+              << std::endl;
+    std::cout << "  --payout X        Blackjack payout, e.g. 1.5 or 1.2" << std::endl;
+}
+
+bool parseRuleOption(int argc, char* argv[], int& i, TableRules& rules) {
+    std::string arg = argv[i];
+
+    // Switches without a value
+    if (arg == "--h17") { rules.dealerHitsSoft17 = true; return true; }
+    if (arg == "--s17") { rules.dealerHitsSoft17 = false; return true; }
+    if (arg == "--das") { rules.doubleAfterSplit = true; return true; }
+    if (arg == "--no-das") { rules.doubleAfterSplit = false; return true; }
+    if (arg == "--rsa") { rules.resplitAces = true; return true; }
+    if (arg == "--no-rsa") { rules.resplitAces = false; return true; }
+    if (arg == "--ls") { rules.lateSurrender = true; return true; }
+    if (arg == "--no-ls") { rules.lateSurrender = false; return true; }
+
+    if (arg != "--decks" && arg != "--cut" && arg != "--max-hands" && arg != "--payout") {
+        return false;
+    }
+
+    if (i + 1 >= argc) {
+        throw std::invalid_argument("Missing value for " + arg);
+    }
+    std::string value = argv[++i];
+
+    try {
+        if (arg == "--decks") {
+            rules.numDecks = std::stoi(value);
+        } else if (arg == "--cut") {
+            size_t dash = value.find('-');
+            rules.cutCardMin = std::stoi(value.substr(0, dash));
+            rules.cutCardMax = dash == std::string::npos ? rules.cutCardMin
+                                                         : std::stoi(value.substr(dash + 1));
+        } else if (arg == "--max-hands") {
+            rules.maxSplitHands = std::stoi(value);
+        } else {
+            rules.blackjackPayout = std::stod(value);
+        }
+    } catch (const std::exception&) {
+        throw std::invalid_argument("Invalid value for " + arg + ": " + value);
+    }
+    return true;
+}
+
+uint64_t parseCount(const std::string& value) {
+    double count = std::stod(value);
+    // 2^64; the negated test also turns away NaN
+    if (!(count >= 1.0 && count < 18446744073709551616.0)) {
+        throw std::out_of_range("Count out of range: " + value);
+    }
+    return static_cast<uint64_t>(count);
+}
+
+int parseThreadCount(const std::string& value) {
+    int threads = std::stoi(value);
+    if (threads < 1) {
+        throw std::out_of_range("Thread count out of range: " + value);
+    }
+    return threads;
+}
+
+bool validateRules(const TableRules& rules) {
+    if (rules.numDecks < 1 || rules.numDecks > TableRules::max_decks || rules.cutCardMin < 0 ||
+        rules.cutCardMax < rules.cutCardMin || rules.cutCardMax >= rules.totalCards() ||
+        rules.maxSplitHands < 1 || rules.maxSplitHands > TableRules::max_split_hands ||
+        !(rules.blackjackPayout > 0.0)) {
+        std::cout << "Invalid rule set: " << rules.describe() << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,28 @@
+#ifndef RULEOPTIONS_H
+#define RULEOPTIONS_H
+
+#include <cstdint>
+#include <string>
+#include "TableRules.h"
+
+// Command line rule switches shared by the simulation tools
+
+void printRuleOptions();
+
+// Reads the rule option at argv[i], if it is one. A value that the option
+// takes is consumed and i moves past it. Returns false when argv[i] is not
+// a rule option. Throws std::invalid_argument for a missing or bad value.
+bool parseRuleOption(int argc, char* argv[], int& i, TableRules& rules);
+
+// Reads a count of rounds or shoes, "1e9" style included. Throws
+// std::invalid_argument when `value` is not a number and std::out_of_range
+// when it is below 1 or does not fit a uint64_t.
+uint64_t parseCount(const std::string& value);
+
+// Reads a --threads value; throws like parseCount for one below 1
+int parseThreadCount(const std::string& value);
+
+// Prints why and returns false when the rules cannot be dealt
+bool validateRules(const TableRules& rules);
+
+#endif
@@ -0,0 +1,384 @@
+#include "Simulator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include "counting.h"
+
+void SimResults::merge(const SimResults& other) {
+    hands += other.hands;
+    unitsWon += other.unitsWon;
+    unitsWonSquared += other.unitsWonSquared;
+    wins += other.wins;
+    losses += other.losses;
+    pushes += other.pushes;
+    blackjacks += other.blackjacks;
+    doubles += other.doubles;
+    splits += other.splits;
+    surrenders += other.surrenders;
+    elapsedSeconds = std::max(elapsedSeconds, other.elapsedSeconds);
+}
+
+double SimResults::expectedValue() const {
+    if (hands == 0) return 0.0;
+    return unitsWon / hands;
+}
+
+double SimResults::standardDeviation() const {
+    if (hands < 2) return 0.0;
+    double mean = expectedValue();
+    double variance = (unitsWonSquared - hands * mean * mean) / (hands - 1);
+    return std::sqrt(std::max(0.0, variance));
+}
+
+double SimResults::handsPerSecond() const {
+    if (elapsedSeconds <= 0.0) return 0.0;
+    return hands / elapsedSeconds;
+}
+
+SimTable::SimTable(PlayerActionHandler& decisionPolicy, const Rng& stream, const TableRules& tableRules)
+    : deck(tableRules, 0), dealer(tableRules), policy(decisionPolicy), rules(tableRules), stats(nullptr),
+      seatId(no_player), history(nullptr), roundsPlayed(0) {
+    deck.setRng(stream);
+    hands.reserve(rules.maxSplitHands);
+}
+
+void SimTable::setHandHistory(HandHistoryRecorder* recorder, int stream) {
+    history = recorder;
+    historyRecord.stream = static_cast<uint16_t>(stream);
+}
+
+double SimTable::trueCountAtDeal() const {
+    // The running count of every card dealt from this shoe, by what is left
+    const CountTags& tags = Counting::getSystemTags(CountingSystem::HI_LO);
+    int runningCount = 0;
+    for (int rank = 0; rank < PackedCard::rank_count; ++rank) {
+        int full = (rank == 9 ? 16 : 4) * rules.numDecks;
+        runningCount += tags[rank] * (full - deck.getRankCount(rank));
+    }
+    int remaining = deck.getCardsRemaining();
+    return remaining > 0 ? runningCount / (remaining / 52.0) : 0.0;
+}
+
+bool SimTable::isSplittablePair(const Player& hand) const {
+    if (hand.getCardCount() != 2) return false;
+
+    int value1 = hand.getCard(0).getValue();
+    int value2 = hand.getCard(1).getValue();
+    if (value1 == value2) return true;
+
+    // Any two ten-valued cards split, same as SplitHand::canPlayerSplit
+    return value1 >= 10 && value2 >= 10;
+}
+
+double SimTable::playRound(SimResults& results) {
+    hands.clear();
+    hands.emplace_back();
+    dealer.clearHand();
+    dealer.resetForNewGame();
+    roundsPlayed++;
+
+    if (history) {
+        historyRecord.clear();
+        historyRecord.shoe = deck.getShoeNumber();
+        historyRecord.round = roundsPlayed;
+        historyRecord.shoePosition = deck.getCardsDealt();
+        historyRecord.counted = true;
+        historyRecord.trueCount = trueCountAtDeal();
+    }
+
+    // Same dealing order as GameEngine::dealInitialCards
+    Player& seat = hands[0].cards;
+    seat.addCard(deck.dealCard());
+    seat.addCard(deck.dealCard());
+    dealer.addCard(deck.dealCard());
+    dealer.addCard(deck.dealCard());
+
+    results.hands++;
+
+    double net = 0.0;
+    bool blackjackPaid = false;
+
+    if (dealer.checkForBlackjack()) {
+        net = seat.isBlackjack() ? 0.0 : -1.0;
+    } else if (seat.isBlackjack()) {
+        net = rules.blackjackPayout;
+        blackjackPaid = true;
+        results.blackjacks++;
+    } else {
+        // Split hands are appended while we walk the list
+        for (size_t i = 0; i < hands.size(); ++i) {
+            playHand(i, results);
+        }
+
+        if (hands.size() == 1 && hands[0].betUnits == 0) {
+            net = -0.5; // surrendered
+        } else {
+            bool anyHandLive = false;
+            for (const SeatHand& hand : hands) {
+                if (!hand.cards.isBusted()) anyHandLive = true;
+            }
+
+            if (anyHandLive) {
+                dealer.revealHoleCard();
+                while (dealer.shouldHit()) {
+                    dealer.addCard(deck.dealCard());
+                }
+            }
+
+            for (const SeatHand& hand : hands) {
+                net += settleHand(hand);
+            }
+        }
+    }
+
+    if (net > 0.0) results.wins++;
+    else if (net < 0.0) results.losses++;
+    else results.pushes++;
+
+    results.unitsWon += net;
+    results.unitsWonSquared += net * net;
+    if (stats) {
+        recordRound(net, blackjackPaid);
+    }
+    if (history) {
+        recordHistory(net, blackjackPaid);
+    }
+    return net;
+}
+
+void SimTable::recordRound(double net, bool blackjackPaid) {
+    bool surrendered = hands.size() == 1 && hands[0].betUnits == 0;
+    double wagered = surrendered ? 1.0 : 0.0;
+    for (const SeatHand& hand : hands) {
+        wagered += hand.betUnits;
+    }
+
+    GameResult result = GameResult::PUSH;
+    if (surrendered) result = GameResult::SURRENDER;
+    else if (blackjackPaid) result = GameResult::BLACKJACK;
+    else if (net > 0.0) result = GameResult::WIN;
+    else if (net < 0.0) result = GameResult::LOSS;
+
+    stats->incrementGamesPlayed();
+    stats->updatePlayerStats(seatId, result);
+    stats->recordRound(seatId, net, wagered);
+}
+
+void SimTable::recordHistory(double net, bool blackjackPaid) {
+    bool surrendered = hands.size() == 1 && hands[0].betUnits == 0;
+
+    historyRecord.dealerBlackjack = dealer.isBlackjack();
+    historyRecord.surrendered = surrendered;
+    historyRecord.blackjackPaid = blackjackPaid;
+    historyRecord.net = net;
+    historyRecord.wagered = surrendered ? 1.0 : 0.0;
+    historyRecord.setDealer(dealer);
+
+    // A round that ended at the deal has only the one hand, and its net
+    // is the round's
+    bool settledAtDeal = blackjackPaid || historyRecord.dealerBlackjack;
+    for (const SeatHand& hand : hands) {
+        historyRecord.wagered += hand.betUnits;
+        if (surrendered) {
+            historyRecord.addHand(hand.cards, 1, net);
+        } else {
+            historyRecord.addHand(hand.cards, hand.betUnits, settledAtDeal ? net : settleHand(hand));
+        }
+    }
+
+    history->append(historyRecord);
+}
+
+void SimTable::playHand(size_t handIndex, SimResults& results) {
+    bool firstDecision = true;
+
+    while (true) {
+        SeatHand& hand = hands[handIndex];
+        Player& cards = hand.cards;
+
+        if (cards.isBusted() || cards.getTotalValue() == 21) return;
+
+        bool twoCards = cards.getCardCount() == 2;
+        bool canSplit = isSplittablePair(cards) &&
+                        hands.size() < static_cast<size_t>(rules.maxSplitHands) &&
+                        (!hand.aceSplit || rules.resplitAces);
+
+        // Split aces get exactly one card each; the only choice left is
+        // resplitting another ace where RSA allows it
+        if (hand.aceSplit && !canSplit) return;
+
+        bool canDouble = twoCards && !hand.aceSplit && (!hand.fromSplit || rules.doubleAfterSplit);
+        bool canSurrender = rules.lateSurrender && firstDecision && twoCards && !hand.fromSplit;
+
+        Action action = legalAction(policy.decide(cards, dealer, canDouble, canSplit, canSurrender),
+                                    canDouble, canSplit, canSurrender);
+        firstDecision = false;
+
+        if (hand.aceSplit && action != Action::SPLIT) return;
+
+        if (history) {
+            historyRecord.addDecision(static_cast<int>(handIndex), cards, action);
+        }
+
+        switch (action) {
+            case Action::STAND:
+                return;
+
+            case Action::DOUBLE:
+                hand.betUnits = 2;
+                cards.addCard(deck.dealCard());
+                results.doubles++;
+                return;
+
+            case Action::SURRENDER:
+                hand.betUnits = 0;
+                results.surrenders++;
+                return;
+
+            case Action::SPLIT: {
+                results.splits++;
+
+                Card card1 = cards.getCard(0);
+                Card card2 = cards.getCard(1);
+                bool splittingAces = card1.getValue() == 1 && card2.getValue() == 1;
+
+                // The hand being split is dealt to first, as in SplitHand
+                cards.removeCard(1);
+                cards.addCard(deck.dealCard());
+                hand.fromSplit = true;
+                hand.aceSplit = splittingAces;
+
+                SeatHand newHand;
+                newHand.fromSplit = true;
+                newHand.aceSplit = splittingAces;
+                newHand.cards.addCard(card2);
+                newHand.cards.addCard(deck.dealCard());
+
+                // Insert right after the current hand, like SplitHand::reSplit.
+                // This may reallocate, so refetch references on the next pass.
+                hands.insert(hands.begin() + handIndex + 1, newHand);
+                if (history) {
+                    historyRecord.insertHand(static_cast<int>(handIndex));
+                }
+                break;
+            }
+
+            case Action::HIT:
+            default:
+                cards.addCard(deck.dealCard());
+                break;
+        }
+    }
+}
+
+double SimTable::settleHand(const SeatHand& hand) const {
+    const Player& cards = hand.cards;
+    int bet = hand.betUnits;
+
+    if (cards.isBusted()) return -bet;
+    if (dealer.isBusted()) return bet;
+
+    int playerTotal = cards.getTotalValue();
+    int dealerTotal = dealer.getTotalValue();
+
+    if (playerTotal > dealerTotal) return bet;
+    if (playerTotal < dealerTotal) return -bet;
+    return 0.0;
+}
+
+Simulator::Simulator(const SimConfig& simConfig, const PlayerActionHandler& policy)
+    : config(simConfig), prototype(policy), liveStats(nullptr), seatId(no_player), historyWriter(nullptr) {}
+
+void Simulator::setStats(ShardedStats* sharded) {
+    if (sharded && sharded->getShardCount() < std::max(1, config.threads)) {
+        throw std::invalid_argument("Need a stats shard for each of the " +
+                                    std::to_string(config.threads) + " threads");
+    }
+    liveStats = sharded;
+    seatId = sharded ? sharded->getPlayerRegistry().intern(sim_seat_name) : no_player;
+}
+
+SimResults Simulator::run() {
+    int workerCount = std::max(1, config.threads);
+    std::vector<SimResults> workerResults(workerCount);
+    std::vector<std::thread> workers;
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Every worker gets its own jump-ahead stream of the master seed, so a
+    // run is reproducible for a given seed and thread count
+    Rng stream(config.seed);
+
+    for (int w = 0; w < workerCount; ++w) {
+        // Spread the remainder over the first few workers
+        uint64_t share = config.hands / workerCount +
+                         (static_cast<uint64_t>(w) < config.hands % workerCount ? 1 : 0);
+
+        workers.emplace_back([this, share, stream, &workerResults, w, workerCount, &failure, &failureMutex]() {
+            try {
+                std::unique_ptr<PlayerActionHandler> policy = prototype.clone();
+                SimTable table(*policy, stream, config.rules);
+                if (config.shoes) {
+                    table.useShoeFile(config.shoes, static_cast<uint64_t>(w), static_cast<uint64_t>(workerCount));
+                }
+                if (liveStats) {
+                    table.setStats(&liveStats->getShard(w), seatId);
+                }
+                std::unique_ptr<HandHistoryRecorder> history;
+                if (historyWriter) {
+                    history = std::make_unique<HandHistoryRecorder>(*historyWriter);
+                    table.setHandHistory(history.get(), w);
+                }
+
+                // Tallied on this thread's stack; neighbouring entries of
+                // workerResults would share cache lines
+                SimResults results;
+
+                auto workerStart = std::chrono::steady_clock::now();
+                for (uint64_t i = 0; i < share; ++i) {
+                    table.playRound(results);
+                    if (liveStats && (i + 1) % stats_publish_rounds == 0) {
+                        liveStats->publish(w);
+                    }
+                }
+                if (liveStats) {
+                    liveStats->publish(w);
+                }
+                if (history) {
+                    history->flush();
+                }
+                auto workerEnd = std::chrono::steady_clock::now();
+                results.elapsedSeconds = std::chrono::duration<double>(workerEnd - workerStart).count();
+                workerResults[w] = results;
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure) failure = std::current_exception();
+            }
+        });
+
+        stream.jump();
+    }
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+
+    SimResults total;
+    for (const SimResults& results : workerResults) {
+        total.merge(results);
+    }
+    total.elapsedSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    return total;
+}
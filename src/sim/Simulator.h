@@ -0,0 +1,147 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "deck.h"
+#include "ShoeFile.h"
+#include "rng.h"
+#include "player.h"
+#include "Dealer.h"
+#include "PlayerActionHandler.h"
+#include "HandHistory.h"
+#include "ShardedStats.h"
+#include "TableRules.h"
+
+// Name the simulated seat is filed under in Stats
+const char* const sim_seat_name = "Seat";
+
+struct SimConfig {
+    uint64_t hands;     // total rounds to play across all workers
+    int threads;
+    uint64_t seed;      // master seed; worker N plays stream N of it
+    TableRules rules;
+
+    // When set, worker N deals shoes N, N + threads, ... from this file
+    // instead of shuffling, so runs with other strategies see the same cards
+    std::shared_ptr<const ShoeFile> shoes;
+
+    SimConfig() : hands(1000000), threads(1), seed(0) {}
+};
+
+// Totals for one worker; merged into a single result once all workers finish
+struct SimResults {
+    uint64_t hands;
+    double unitsWon;
+    double unitsWonSquared;
+    uint64_t wins;
+    uint64_t losses;
+    uint64_t pushes;
+    uint64_t blackjacks;
+    uint64_t doubles;
+    uint64_t splits;
+    uint64_t surrenders;
+    double elapsedSeconds;
+
+    SimResults() : hands(0), unitsWon(0.0), unitsWonSquared(0.0), wins(0), losses(0),
+                   pushes(0), blackjacks(0), doubles(0), splits(0), surrenders(0),
+                   elapsedSeconds(0.0) {}
+
+    void merge(const SimResults& other);
+    double expectedValue() const;   // units won per hand
+    double standardDeviation() const;
+    double handsPerSecond() const;
+};
+
+// One seat against the dealer on a private shoe. Follows the same rules as
+// GameEngine/SplitHand without any console I/O; bjsim --cross-check
+// (EngineCrossCheck) plays both on the same cards to keep them agreeing.
+class SimTable {
+private:
+    struct SeatHand {
+        Player cards;
+        int betUnits;
+        bool fromSplit;
+        bool aceSplit;
+
+        SeatHand() : cards("Seat"), betUnits(1), fromSplit(false), aceSplit(false) {}
+    };
+
+    Deck deck;
+    Dealer dealer;
+    std::vector<SeatHand> hands;
+    PlayerActionHandler& policy;
+    TableRules rules;
+    Stats* stats;
+    PlayerId seatId;
+    HandHistoryRecorder* history;
+    HandRecord historyRecord;
+    uint64_t roundsPlayed;
+
+    bool isSplittablePair(const Player& hand) const;
+    void playHand(size_t handIndex, SimResults& results);
+    double settleHand(const SeatHand& hand) const;
+    void recordRound(double net, bool blackjackPaid);
+    void recordHistory(double net, bool blackjackPaid);
+    double trueCountAtDeal() const;
+
+public:
+    SimTable(PlayerActionHandler& decisionPolicy, const Rng& stream,
+             const TableRules& tableRules = TableRules());
+
+    // Plays one round at one unit and returns the seat's net units
+    double playRound(SimResults& results);
+
+    // Also files every round in `roundStats` under `seat`: one result per
+    // round, as SimResults counts them, and the units won and wagered.
+    // nullptr stops it.
+    void setStats(Stats* roundStats, PlayerId seat) { stats = roundStats; seatId = seat; }
+
+    // Also logs every round to `recorder` under `stream`, with the Hi-Lo
+    // true count at the deal. nullptr stops it.
+    void setHandHistory(HandHistoryRecorder* recorder, int stream);
+
+    // Card events from this table's shoe, e.g. for a running count
+    void setShoeListener(ShoeListener* listener) { deck.setListener(listener); }
+    const Deck& getDeck() const { return deck; }
+
+    // Deals the same cards as `other` from here on; see Deck::matchShoe
+    void matchShoe(const SimTable& other) { deck.matchShoe(other.deck); }
+
+    // Deals pre-shuffled shoes; see Deck::useShoeFile
+    void useShoeFile(std::shared_ptr<const ShoeFile> file, uint64_t firstShoe, uint64_t step) {
+        deck.useShoeFile(std::move(file), firstShoe, step);
+    }
+};
+
+// Rounds a worker plays between publishes to its ShardedStats shard
+const uint64_t stats_publish_rounds = 4096;
+
+class Simulator {
+private:
+    SimConfig config;
+    const PlayerActionHandler& prototype;
+    ShardedStats* liveStats;
+    PlayerId seatId;
+    HandHistoryWriter* historyWriter;
+
+public:
+    Simulator(const SimConfig& simConfig, const PlayerActionHandler& policy);
+
+    // Worker N also records into shard N of `sharded`, under the name
+    // sim_seat_name, so another thread can watch the run through
+    // ShardedStats::snapshot. Call before run(); throws
+    // std::invalid_argument if there are fewer shards than threads.
+    void setStats(ShardedStats* sharded);
+
+    // Worker N logs every round it plays to `writer` as stream N. The
+    // caller closes the writer after run().
+    void setHandHistory(HandHistoryWriter* writer) { historyWriter = writer; }
+
+    // Rethrows the first exception a worker hit, once all have stopped
+    SimResults run();
+};
+
+#endif
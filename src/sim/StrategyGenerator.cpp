@@ -0,0 +1,178 @@
+#include "StrategyGenerator.h"
+
+#include "player.h"
+
+namespace {
+
+Action hitOrStand(const ActionEV& ev) {
+    return ev.hit > ev.stand ? Action::HIT : Action::STAND;
+}
+
+}
+
+StrategyGenerator::StrategyGenerator(const TableRules& tableRules) : rules(tableRules) {}
+
+std::vector<std::pair<int, int>> StrategyGenerator::cellHands(HandType handType, int value) {
+    std::vector<std::pair<int, int>> hands;
+
+    switch (handType) {
+        case HandType::PAIR:
+            hands.emplace_back(value, value);
+            break;
+
+        case HandType::SOFT:
+            if (value >= 12 && value <= 21) hands.emplace_back(1, value - 11);
+            break;
+
+        case HandType::HARD:
+        default:
+            // Both cards 2-10, so no ace and no soft total
+            for (int card1 = 2; card1 <= 10; ++card1) {
+                int card2 = value - card1;
+                if (card2 >= card1 && card2 <= 10) hands.emplace_back(card1, card2);
+            }
+            break;
+    }
+    return hands;
+}
+
+ActionEV StrategyGenerator::averageEV(EVAnalyzer& analyzer, const ShoeComposition& shoe, int dealerUp,
+                                      const std::vector<std::pair<int, int>>& hands,
+                                      bool canSurrender, bool canSplit) const {
+    ActionEV average;
+    double totalWeight = 0.0;
+
+    for (const auto& cards : hands) {
+        int rank1 = cards.first - 1;
+        int rank2 = cards.second - 1;
+
+        // Chance of being dealt these two cards, in either order
+        double weight = rank1 == rank2 ? shoe[rank1] * (shoe[rank1] - 1.0)
+                                       : 2.0 * shoe[rank1] * shoe[rank2];
+        if (weight <= 0.0) continue;
+
+        ShoeComposition unseen = shoe;
+        unseen[rank1]--;
+        unseen[rank2]--;
+
+        Player hand("Generator");
+        hand.addCard(Card(cards.first, Hearts));
+        hand.addCard(Card(cards.second, Spades));
+
+        ActionEV ev = analyzer.analyze(hand, dealerUp, unseen, true, canSurrender, canSplit);
+        average.stand += weight * ev.stand;
+        average.hit += weight * ev.hit;
+        average.doubleDown += weight * ev.doubleDown;
+        average.split += weight * ev.split;
+        average.surrender += weight * ev.surrender;
+        average.canDouble = ev.canDouble;
+        average.canSplit = ev.canSplit;
+        average.canSurrender = ev.canSurrender;
+        totalWeight += weight;
+    }
+
+    if (totalWeight > 0.0) {
+        average.stand /= totalWeight;
+        average.hit /= totalWeight;
+        average.doubleDown /= totalWeight;
+        average.split /= totalWeight;
+        average.surrender /= totalWeight;
+    }
+    return average;
+}
+
+void StrategyGenerator::generateColumn(int dealerUp, StrategyTable& table) const {
+    EVAnalyzer analyzer(rules);
+    ShoeComposition shoe = EVAnalyzer::fullShoe(rules.numDecks);
+    shoe[dealerUp - 1]--;
+
+    // Totals no starting hand can have keep the plain defaults
+    for (int total = 0; total < StrategyTable::values; ++total) {
+        Action play = total >= 17 ? Action::STAND : Action::HIT;
+        table.set(HandType::HARD, total, dealerUp, play, play);
+        table.set(HandType::SOFT, total, dealerUp, play, play);
+    }
+    table.set(HandType::SOFT, 21, dealerUp, Action::STAND, Action::STAND);
+
+    for (int total = 4; total <= 20; ++total) {
+        ActionEV ev = averageEV(analyzer, shoe, dealerUp, cellHands(HandType::HARD, total),
+                                rules.lateSurrender, false);
+        table.set(HandType::HARD, total, dealerUp, ev.getBestAction(), hitOrStand(ev));
+    }
+
+    // Soft 12 is A,A played without splitting
+    for (int total = 12; total <= 20; ++total) {
+        ActionEV ev = averageEV(analyzer, shoe, dealerUp, cellHands(HandType::SOFT, total),
+                                rules.lateSurrender, false);
+        table.set(HandType::SOFT, total, dealerUp, ev.getBestAction(), hitOrStand(ev));
+    }
+
+    // Pair cells choose among split, double, hit and stand; the table does
+    // not surrender pairs
+    for (int value = 1; value <= 10; ++value) {
+        ActionEV ev = averageEV(analyzer, shoe, dealerUp, cellHands(HandType::PAIR, value), false, true);
+        table.set(HandType::PAIR, value, dealerUp, ev.getBestAction(), hitOrStand(ev));
+    }
+}
+
+StrategyTable StrategyGenerator::generate(int threads) const {
+    StrategyTable table;
+
+    // Columns are disjoint, so the workers can share the table
+    forEachUpcard(threads, [this, &table](int dealerUp) {
+        generateColumn(dealerUp, table);
+    });
+
+    return table;
+}
+
+void StrategyGenerator::findColumnPlays(int dealerUp, const StrategyTable& table,
+                                        std::vector<CompositionPlay>& plays) const {
+    EVAnalyzer analyzer(rules);
+    ShoeComposition shoe = EVAnalyzer::fullShoe(rules.numDecks);
+    shoe[dealerUp - 1]--;
+
+    for (int card1 = 1; card1 <= 10; ++card1) {
+        for (int card2 = card1; card2 <= 10; ++card2) {
+            // Blackjack needs no decision
+            if (card1 == 1 && card2 == 10) continue;
+
+            ShoeComposition unseen = shoe;
+            unseen[card1 - 1]--;
+            unseen[card2 - 1]--;
+            if (unseen[card1 - 1] < 0 || unseen[card2 - 1] < 0) continue;
+
+            Player hand("Generator");
+            hand.addCard(Card(card1, Hearts));
+            hand.addCard(Card(card2, Spades));
+            ActionEV ev = analyzer.analyze(hand, dealerUp, unseen, true, rules.lateSurrender, true);
+
+            HandType handType = card1 == card2 ? HandType::PAIR
+                                               : (card1 == 1 ? HandType::SOFT : HandType::HARD);
+            int value = handType == HandType::PAIR ? card1
+                                                   : (card1 == 1 ? card2 + 11 : card1 + card2);
+            Action tableAction = table.primary[static_cast<int>(handType)][value][dealerUp];
+            Action bestAction = ev.getBestAction();
+
+            double gain = ev.getBestEV() - ev.getEV(tableAction);
+            if (bestAction != tableAction && gain > 0.0) {
+                plays.push_back({card1, card2, dealerUp, tableAction, bestAction, gain});
+            }
+        }
+    }
+}
+
+std::vector<CompositionPlay> StrategyGenerator::findCompositionPlays(const StrategyTable& table,
+                                                                     int threads) const {
+    std::vector<std::vector<CompositionPlay>> columns(11);
+
+    forEachUpcard(threads, [this, &table, &columns](int dealerUp) {
+        findColumnPlays(dealerUp, table, columns[dealerUp]);
+    });
+
+    std::vector<CompositionPlay> plays;
+    for (const auto& column : columns) {
+        plays.insert(plays.end(), column.begin(), column.end());
+    }
+    return plays;
+}
@@ -0,0 +1,78 @@
+#ifndef STRATEGYGENERATOR_H
+#define STRATEGYGENERATOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "EVAnalyzer.h"
+#include "StrategyTables.h"
+#include "TableRules.h"
+
+// A two-card hand whose composition-dependent best play differs from the
+// total-dependent table
+struct CompositionPlay {
+    int card1;          // card values, 1 = ace, 10 = any ten
+    int card2;
+    int dealerUp;
+    Action tableAction;
+    Action bestAction;
+    double evGain;      // per unit bet, from playing bestAction instead
+};
+
+// Runs work(dealerUp) for upcards 1-10 on up to `threads` threads
+template <typename Work>
+void forEachUpcard(int threads, Work work) {
+    std::atomic<int> nextUpcard(1);
+    std::vector<std::thread> workers;
+
+    int workerCount = std::min(10, std::max(1, threads));
+    for (int w = 0; w < workerCount; ++w) {
+        workers.emplace_back([&nextUpcard, &work]() {
+            for (int dealerUp = nextUpcard++; dealerUp <= 10; dealerUp = nextUpcard++) {
+                work(dealerUp);
+            }
+        });
+    }
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+// Derives basic strategy for any rule set from EVAnalyzer against a full
+// shoe. Every cell is the best action for the probability-weighted
+// average of the two-card hands that make up that total, which is
+// total-dependent basic strategy.
+class StrategyGenerator {
+private:
+    TableRules rules;
+
+    void generateColumn(int dealerUp, StrategyTable& table) const;
+    void findColumnPlays(int dealerUp, const StrategyTable& table,
+                         std::vector<CompositionPlay>& plays) const;
+
+public:
+    explicit StrategyGenerator(const TableRules& tableRules = TableRules());
+
+    // The two-card hands a table cell stands for: every hard pair of cards
+    // 2-10 with that total, A,x for soft totals (soft 12 is unsplit A,A) and
+    // the pair itself for PAIR cells
+    static std::vector<std::pair<int, int>> cellHands(HandType handType, int value);
+
+    // Action EVs averaged over `hands`, each weighted by its chance of
+    // being dealt from `shoe`. `shoe` must already exclude the upcard.
+    ActionEV averageEV(EVAnalyzer& analyzer, const ShoeComposition& shoe, int dealerUp,
+                       const std::vector<std::pair<int, int>>& hands, bool canSurrender,
+                       bool canSplit) const;
+
+    // Upcards are worked on in parallel, one analyzer per thread
+    StrategyTable generate(int threads = 1) const;
+
+    // Two-card hands where playing the exact cards beats the table
+    std::vector<CompositionPlay> findCompositionPlays(const StrategyTable& table, int threads = 1) const;
+};
+
+#endif
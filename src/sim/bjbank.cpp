@@ -0,0 +1,235 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <random>
+#include "BankrollSim.h"
+#include "RuleOptions.h"
+
+void printUsage() {
+    std::cout << "Usage: bjbank [--hands N] [--threads N] [--seed N] [--system NAME] [--estimation NAME]" << std::endl;
+    std::cout << "              [--ramp SPEC | --kelly F] [--bankroll UNITS] [--trials N] [--trip-hands N]" << std::endl;
+    std::cout << "              [--percentiles FILE] [rule options]" << std::endl;
+    std::cout << "  --hands N          Rounds played on the bet ramp (accepts 1e9 style values)" << std::endl;
+    std::cout << "  --threads N        Worker threads, one shoe each (default: all cores)" << std::endl;
+    std::cout << "  --seed N           Master RNG seed" << std::endl;
+    std::cout << "  --system NAME      hilo, ko, hiopt1 or omega2 (default: hilo)" << std::endl;
+    std::cout << "  --estimation NAME  exact, quarter, half, whole or tray (default: exact)" << std::endl;
+    std::cout << "  --ramp SPEC        TC:UNITS steps, e.g. 1:2,2:4,3:8; 'counting' is the 1-5x ramp" << std::endl;
+    std::cout << "  --kelly F          Bet F times the Kelly fraction of the bankroll (1 full, 0.5 half)" << std::endl;
+    std::cout << "  --min-bet UNITS    Smallest Kelly bet (default: 1)" << std::endl;
+    std::cout << "  --max-bet UNITS    Largest Kelly bet (default: 20)" << std::endl;
+    std::cout << "  --calibrate N      Flat-bet rounds that measure the edge per true count" << std::endl;
+    std::cout << "                     (default: --hands with Kelly, otherwise none)" << std::endl;
+    std::cout << "  --bankroll UNITS   Starting bankroll for Kelly sizing and risk of ruin (default: 1000)" << std::endl;
+    std::cout << "  --trials N         Bankrolls played out to measure ruin (default: none)" << std::endl;
+    std::cout << "  --trip-hands N     Rounds per trial (default: 100000)" << std::endl;
+    std::cout << "  --percentiles FILE Write the trials' session percentiles as CSV" << std::endl;
+    printRuleOptions();
+}
+
+CountingSystem parseSystem(const std::string& name) {
+    if (name == "hilo") return CountingSystem::HI_LO;
+    if (name == "ko") return CountingSystem::KO;
+    if (name == "hiopt1") return CountingSystem::HI_OPT_I;
+    if (name == "omega2") return CountingSystem::OMEGA_II;
+    throw std::invalid_argument("Unknown counting system: " + name);
+}
+
+DeckEstimation parseEstimation(const std::string& name) {
+    if (name == "exact") return DeckEstimation::EXACT;
+    if (name == "quarter") return DeckEstimation::QUARTER_DECK;
+    if (name == "half") return DeckEstimation::HALF_DECK;
+    if (name == "whole") return DeckEstimation::WHOLE_DECK;
+    if (name == "tray") return DeckEstimation::VISUAL_TRAY;
+    throw std::invalid_argument("Unknown deck estimation: " + name);
+}
+
+bool parseArguments(int argc, char* argv[], BankrollConfig& config, std::string& percentileFile) {
+    double kellyFraction = 0.0;
+    double minBet = 1.0;
+    double maxBet = 20.0;
+    bool calibrationSet = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return false;
+        }
+
+        try {
+            if (parseRuleOption(argc, argv, i, config.sim.rules)) {
+                continue;
+            }
+        } catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return false;
+        }
+
+        if (i + 1 >= argc) {
+            std::cout << "Missing value for " << arg << std::endl;
+            printUsage();
+            return false;
+        }
+
+        try {
+            if (arg == "--hands") {
+                config.sim.hands = parseCount(argv[++i]);
+            } else if (arg == "--threads") {
+                config.sim.threads = parseThreadCount(argv[++i]);
+            } else if (arg == "--seed") {
+                config.sim.seed = std::stoull(argv[++i]);
+            } else if (arg == "--system") {
+                config.system = parseSystem(argv[++i]);
+            } else if (arg == "--estimation") {
+                config.estimation = parseEstimation(argv[++i]);
+            } else if (arg == "--ramp") {
+                std::string spec = argv[++i];
+                config.ramp = spec == "counting" ? BetRamp::counting() : BetRamp::parse(spec);
+            } else if (arg == "--kelly") {
+                kellyFraction = std::stod(argv[++i]);
+            } else if (arg == "--min-bet") {
+                minBet = std::stod(argv[++i]);
+            } else if (arg == "--max-bet") {
+                maxBet = std::stod(argv[++i]);
+            } else if (arg == "--calibrate") {
+                config.calibrationHands = static_cast<uint64_t>(std::stod(argv[++i]));
+                calibrationSet = true;
+            } else if (arg == "--bankroll") {
+                config.bankroll = std::stod(argv[++i]);
+            } else if (arg == "--trials") {
+                config.trials = static_cast<uint64_t>(std::stod(argv[++i]));
+            } else if (arg == "--trip-hands") {
+                config.tripHands = static_cast<uint64_t>(std::stod(argv[++i]));
+            } else if (arg == "--percentiles") {
+                percentileFile = argv[++i];
+            } else {
+                std::cout << "Unknown option: " << arg << std::endl;
+                printUsage();
+                return false;
+            }
+        } catch (const std::invalid_argument& e) {
+            // Our own parsers explain themselves; std::sto* just say "stod"
+            std::string what = e.what();
+            if (what.compare(0, 3, "sto") == 0) {
+                std::cout << "Invalid value for " << arg << ": " << argv[i] << std::endl;
+            } else {
+                std::cout << what << std::endl;
+            }
+            return false;
+        } catch (const std::exception&) {
+            std::cout << "Invalid value for " << arg << ": " << argv[i] << std::endl;
+            return false;
+        }
+    }
+
+    if (kellyFraction > 0.0) {
+        try {
+            config.ramp = BetRamp::kelly(kellyFraction, minBet, maxBet);
+        } catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return false;
+        }
+        if (!calibrationSet) {
+            config.calibrationHands = config.sim.hands;
+        }
+    }
+
+    if (!percentileFile.empty() && config.trials == 0) {
+        std::cout << "--percentiles needs --trials" << std::endl;
+        return false;
+    }
+
+    if (config.bankroll <= 0.0) {
+        std::cout << "Bankroll must be positive" << std::endl;
+        return false;
+    }
+
+    return validateRules(config.sim.rules);
+}
+
+int main(int argc, char* argv[]) {
+    BankrollConfig config;
+    config.sim.threads = std::max(1u, std::thread::hardware_concurrency());
+    config.sim.seed = std::random_device{}();
+
+    std::string percentileFile;
+    if (!parseArguments(argc, argv, config, percentileFile)) {
+        return 1;
+    }
+
+    Counting names(nullptr);
+    std::cout << "Simulating " << config.sim.hands << " hands on "
+              << config.sim.threads << " thread(s), seed " << config.sim.seed << "..." << std::endl;
+    std::cout << "Rules: " << config.sim.rules.describe() << std::endl;
+    std::cout << "Count: " << names.getSystemName(config.system) << ", "
+              << names.getDeckEstimationName(config.estimation) << " deck estimation" << std::endl;
+    std::cout << "Bets: " << config.ramp.describe() << std::endl;
+
+    BasicStrategyHandler policy(config.sim.rules);
+    BankrollSimulator simulator(config, policy);
+    BankrollResults results = simulator.run();
+
+    std::cout << "\n======== BANKROLL RESULTS ========" << std::endl;
+    std::cout << "Hands Played: " << results.hands << std::endl;
+    std::cout << "Elapsed: " << std::fixed << std::setprecision(2)
+              << results.elapsedSeconds << " s" << std::endl;
+    std::cout << "Average Bet: " << std::fixed << std::setprecision(3)
+              << results.averageBet() << " units" << std::endl;
+    std::cout << "Win Rate: " << std::fixed << std::setprecision(4)
+              << results.winPer100() << " units per 100 hands" << std::endl;
+    std::cout << "Std Dev: " << std::fixed << std::setprecision(3)
+              << results.sdPer100() << " units per 100 hands" << std::endl;
+    if (results.n0() > 0.0) {
+        std::cout << "N0: " << std::fixed << std::setprecision(0) << results.n0() << " hands" << std::endl;
+    } else {
+        std::cout << "N0: never (no edge)" << std::endl;
+    }
+    std::cout << "SCORE: " << std::fixed << std::setprecision(2) << results.score() << std::endl;
+    std::cout << "Risk of Ruin (" << std::setprecision(0) << config.bankroll << " units): "
+              << std::setprecision(2) << results.riskOfRuin(config.bankroll) * 100.0 << "%" << std::endl;
+    if (results.trials > 0) {
+        std::cout << "Simulated Ruin: " << results.ruined << " of " << results.trials
+                  << " trials of " << config.tripHands << " hands ("
+                  << std::setprecision(2) << results.simulatedRiskOfRuin() * 100.0 << "%)" << std::endl;
+    }
+
+    if (config.calibrationHands > 0) {
+        const TrueCountEdge& edges = results.edges;
+        std::cout << "\n--- EDGE BY TRUE COUNT (flat bet) ---" << std::endl;
+        std::cout << "Fitted: " << std::setprecision(3) << edges.baseEdge * 100.0 << "% + "
+                  << edges.edgePerTrueCount * 100.0 << "% per TC, variance "
+                  << edges.variance << std::endl;
+        for (int tc = TrueCountEdge::min_true_count; tc <= TrueCountEdge::max_true_count; ++tc) {
+            int bucket = TrueCountEdge::bucketFor(tc);
+            std::cout << "TC " << std::showpos << std::setw(3) << tc << std::noshowpos << ": "
+                      << std::setw(8) << std::setprecision(3) << edges.edge[bucket] * 100.0 << "%"
+                      << "  fitted " << std::setw(7) << edges.edgeAt(tc) * 100.0 << "%"
+                      << "  bet " << std::setw(6) << std::setprecision(2)
+                      << config.ramp.unitsFor(tc, config.bankroll, edges)
+                      << "  (" << edges.hands[bucket] << " hands)" << std::endl;
+        }
+    }
+    std::cout << "==================================" << std::endl;
+
+    if (results.trials > 0) {
+        results.sessionStats.displaySessionPercentiles();
+    }
+    if (!percentileFile.empty()) {
+        std::ofstream out(percentileFile);
+        results.sessionStats.writeSessionPercentiles(out);
+        if (!out) {
+            std::cout << "Failed writing " << percentileFile << std::endl;
+            return 1;
+        }
+        std::cout << "Session percentiles written to " << percentileFile << std::endl;
+    }
+
+    return 0;
+}
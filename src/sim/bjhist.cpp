@@ -0,0 +1,229 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "HandHistory.h"
+
+// Which logged decisions to count; -1 / false leaves a field open
+struct DecisionQuery {
+    int total;
+    int upCard;         // 1 for an ace, 10 for any ten-valued card
+    bool softOnly;
+    bool hardOnly;
+    bool pairOnly;
+    bool twoCardsOnly;
+    bool minSet;
+    bool maxSet;
+    double minTrueCount;
+    double maxTrueCount;
+
+    DecisionQuery() : total(-1), upCard(-1), softOnly(false), hardOnly(false), pairOnly(false),
+                      twoCardsOnly(false), minSet(false), maxSet(false), minTrueCount(0.0),
+                      maxTrueCount(0.0) {}
+
+    bool filtersDecisions() const {
+        return total >= 0 || upCard >= 0 || softOnly || hardOnly || pairOnly || twoCardsOnly || minSet || maxSet;
+    }
+
+    bool matches(const HandRecordView& record) const {
+        if (upCard >= 0 && std::min(record.getUpCard().getValue(), 10) != upCard) return false;
+        if (minSet || maxSet) {
+            if (!record.isCounted()) return false;
+            double trueCount = record.getTrueCount();
+            if ((minSet && trueCount < minTrueCount) || (maxSet && trueCount > maxTrueCount)) return false;
+        }
+        return true;
+    }
+
+    bool matches(const HandDecision& decision) const {
+        if (total >= 0 && decision.total != total) return false;
+        if (softOnly && !decision.soft) return false;
+        if (hardOnly && decision.soft) return false;
+        if (pairOnly && !decision.pair) return false;
+        if (twoCardsOnly && !decision.twoCards) return false;
+        return true;
+    }
+
+    std::string describe() const {
+        std::string text;
+        if (pairOnly) text += "pair ";
+        if (softOnly) text += "soft ";
+        if (hardOnly) text += "hard ";
+        text += total >= 0 ? std::to_string(total) : "hands";
+        if (twoCardsOnly) text += " (two cards)";
+        text += " vs ";
+        text += upCard < 0 ? "any up card" : (upCard == 1 ? "A" : std::to_string(upCard));
+        std::ostringstream range;
+        if (minSet && maxSet) range << ", true count " << minTrueCount << " to " << maxTrueCount;
+        else if (minSet) range << ", true count >= " << minTrueCount;
+        else if (maxSet) range << ", true count <= " << maxTrueCount;
+        return text + range.str();
+    }
+};
+
+void printUsage() {
+    std::cout << "Usage: bjhist --in FILE [--total N] [--up CARD] [--soft | --hard] [--pair] [--two-cards]" << std::endl;
+    std::cout << "              [--min-tc X] [--max-tc X]" << std::endl;
+    std::cout << "  --in FILE      Hand history written by bjsim --history or blackjack --history" << std::endl;
+    std::cout << "  --total N      Only decisions on hands totalling N" << std::endl;
+    std::cout << "  --up CARD      Only rounds with this dealer up card: A or 2-10" << std::endl;
+    std::cout << "  --soft, --hard Only soft or hard totals" << std::endl;
+    std::cout << "  --pair         Only two-card hands that could split" << std::endl;
+    std::cout << "  --two-cards    Only decisions on two-card hands" << std::endl;
+    std::cout << "  --min-tc X     Only rounds dealt at a true count of X or more" << std::endl;
+    std::cout << "  --max-tc X     Only rounds dealt at a true count of X or less" << std::endl;
+    std::cout << "With any filter, prints how often each action was taken and how the hand did." << std::endl;
+}
+
+const char* actionName(Action action) {
+    switch (action) {
+        case Action::HIT: return "Hit";
+        case Action::STAND: return "Stand";
+        case Action::DOUBLE: return "Double";
+        case Action::SPLIT: return "Split";
+        case Action::SURRENDER: return "Surrender";
+    }
+    return "?";
+}
+
+int main(int argc, char* argv[]) {
+    std::string inFile;
+    DecisionQuery query;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        } else if (arg == "--soft") {
+            query.softOnly = true;
+            continue;
+        } else if (arg == "--hard") {
+            query.hardOnly = true;
+            continue;
+        } else if (arg == "--pair") {
+            query.pairOnly = true;
+            continue;
+        } else if (arg == "--two-cards") {
+            query.twoCardsOnly = true;
+            continue;
+        }
+
+        if (i + 1 >= argc) {
+            std::cout << "Missing value for " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+
+        try {
+            if (arg == "--in") {
+                inFile = argv[++i];
+            } else if (arg == "--total") {
+                query.total = std::stoi(argv[++i]);
+            } else if (arg == "--up") {
+                std::string card = argv[++i];
+                query.upCard = (card == "A" || card == "a") ? 1 : std::stoi(card);
+                if (query.upCard < 1 || query.upCard > 10) throw std::invalid_argument(card);
+            } else if (arg == "--min-tc") {
+                query.minTrueCount = std::stod(argv[++i]);
+                query.minSet = true;
+            } else if (arg == "--max-tc") {
+                query.maxTrueCount = std::stod(argv[++i]);
+                query.maxSet = true;
+            } else {
+                std::cout << "Unknown option: " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cout << "Invalid value for " << arg << ": " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    if (inFile.empty()) {
+        printUsage();
+        return 1;
+    }
+    if (query.softOnly && query.hardOnly) {
+        std::cout << "--soft and --hard cannot be used together" << std::endl;
+        return 1;
+    }
+
+    try {
+        HandHistoryFile history(inFile);
+        std::cout << inFile << ": " << history.getRules().describe() << ", seed " << history.getSeed()
+                  << std::endl;
+
+        uint64_t records = 0;
+        uint64_t hands = 0;
+        double unitsWon = 0.0;
+        double unitsWagered = 0.0;
+        bool filtering = query.filtersDecisions();
+
+        std::array<uint64_t, 5> taken{};
+        std::array<double, 5> takenNet{};
+
+        auto start = std::chrono::steady_clock::now();
+        HandHistoryFile::Iterator record = history.begin();
+        for (; record != history.end(); ++record) {
+            HandRecordView view = *record;
+            records++;
+            hands += view.getHandCount();
+            unitsWon += view.getNet();
+            unitsWagered += view.getWagered();
+
+            if (!filtering || view.getDecisionCount() == 0 || !query.matches(view)) continue;
+            for (int d = 0; d < view.getDecisionCount(); ++d) {
+                HandDecision decision = view.getDecision(d);
+                size_t action = static_cast<size_t>(decision.action);
+                if (action >= taken.size() || !query.matches(decision)) continue;
+                taken[action]++;
+                takenNet[action] += view.getHand(decision.hand).net;
+            }
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        size_t scanned = history.getOffset(record);
+        std::cout << "Rounds: " << records << "  Hands: " << hands << std::endl;
+        std::cout << "Net: " << std::fixed << std::setprecision(2) << unitsWon << " units on "
+                  << unitsWagered << " wagered, EV per round "
+                  << std::setprecision(4) << (records > 0 ? unitsWon / records * 100.0 : 0.0) << "%" << std::endl;
+        std::cout << "Scanned " << std::setprecision(1) << (scanned / 1048576.0) << " MB in "
+                  << std::setprecision(2) << elapsed << " s (" << std::setprecision(0)
+                  << (elapsed > 0.0 ? records / elapsed : 0.0) << " rounds/sec)" << std::endl;
+        if (scanned < history.getSize()) {
+            std::cout << "Stopped " << (history.getSize() - scanned)
+                      << " bytes before the end at a damaged or unfinished record" << std::endl;
+        }
+
+        if (filtering) {
+            uint64_t matched = 0;
+            for (uint64_t count : taken) matched += count;
+
+            std::cout << "\nDecisions on " << query.describe() << ": " << matched << std::endl;
+            if (matched > 0) {
+                std::cout << std::left << std::setw(12) << "Action" << std::right << std::setw(14) << "Count"
+                          << std::setw(10) << "Share" << std::setw(16) << "Avg hand net" << std::endl;
+                for (size_t a = 0; a < taken.size(); ++a) {
+                    if (taken[a] == 0) continue;
+                    std::cout << std::left << std::setw(12) << actionName(static_cast<Action>(a)) << std::right
+                              << std::setw(14) << taken[a] << std::setw(9) << std::setprecision(1)
+                              << (100.0 * taken[a] / matched) << "%" << std::setw(16) << std::setprecision(4)
+                              << (takenNet[a] / taken[a]) << std::endl;
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
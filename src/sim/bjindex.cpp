@@ -0,0 +1,146 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include "IndexGenerator.h"
+#include "RuleOptions.h"
+#include "counting.h"
+
+void printUsage() {
+    std::cout << "Usage: bjindex [--system NAME] [--remaining DECKS] [--min-tc N] [--max-tc N]" << std::endl;
+    std::cout << "               [--threads N] [--out FILE] [rule options]" << std::endl;
+    std::cout << "  --system NAME      hilo, ko, hiopt1 or omega2 (default: all four)" << std::endl;
+    std::cout << "  --remaining DECKS  Decks left in the shoe the indices are solved at" << std::endl;
+    std::cout << "                     (default: half the shoe, at least one deck)" << std::endl;
+    std::cout << "  --min-tc N         Lowest true count searched (default: -8)" << std::endl;
+    std::cout << "  --max-tc N         Highest true count searched (default: 10)" << std::endl;
+    std::cout << "  --threads N        Worker threads (default: all cores)" << std::endl;
+    std::cout << "  --out FILE         Write the indices for BasicStrat::loadIndexTables" << std::endl;
+    printRuleOptions();
+}
+
+CountingSystem parseSystem(const std::string& name) {
+    if (name == "hilo") return CountingSystem::HI_LO;
+    if (name == "ko") return CountingSystem::KO;
+    if (name == "hiopt1") return CountingSystem::HI_OPT_I;
+    if (name == "omega2") return CountingSystem::OMEGA_II;
+    throw std::invalid_argument("Unknown counting system: " + name);
+}
+
+int main(int argc, char* argv[]) {
+    TableRules rules;
+    std::string outFile;
+    bool allSystems = true;
+    CountingSystem system = CountingSystem::HI_LO;
+    double remaining = 0.0;
+    int minTc = -8;
+    int maxTc = 10;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        }
+
+        try {
+            if (parseRuleOption(argc, argv, i, rules)) {
+                continue;
+            }
+        } catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+
+        if (i + 1 >= argc) {
+            std::cout << "Missing value for " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+
+        try {
+            if (arg == "--system") {
+                system = parseSystem(argv[++i]);
+                allSystems = false;
+            } else if (arg == "--remaining") {
+                remaining = std::stod(argv[++i]);
+            } else if (arg == "--min-tc") {
+                minTc = std::stoi(argv[++i]);
+            } else if (arg == "--max-tc") {
+                maxTc = std::stoi(argv[++i]);
+            } else if (arg == "--threads") {
+                threads = parseThreadCount(argv[++i]);
+            } else if (arg == "--out") {
+                outFile = argv[++i];
+            } else {
+                std::cout << "Unknown option: " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+        } catch (const std::invalid_argument& e) {
+            std::string what = e.what();
+            if (what.compare(0, 3, "sto") == 0) {
+                std::cout << "Invalid value for " << arg << ": " << argv[i] << std::endl;
+            } else {
+                std::cout << what << std::endl;
+            }
+            return 1;
+        } catch (const std::exception&) {
+            std::cout << "Invalid value for " << arg << ": " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    if (!validateRules(rules)) {
+        return 1;
+    }
+    if (remaining <= 0.0) {
+        remaining = std::max(1.0, rules.numDecks / 2.0);
+    }
+    if (remaining > rules.numDecks) {
+        std::cout << "--remaining cannot exceed the " << rules.numDecks << " deck shoe" << std::endl;
+        return 1;
+    }
+    if (minTc >= maxTc) {
+        std::cout << "--min-tc must be below --max-tc" << std::endl;
+        return 1;
+    }
+
+    const StrategyTable& baseTable = strategy_tables[strategyTableIndex(rules.dealerHitsSoft17,
+                                                                        rules.doubleAfterSplit,
+                                                                        rules.lateSurrender)];
+    IndexGenerator generator(rules, baseTable, remaining, minTc, maxTc);
+
+    Counting names(nullptr);
+    IndexTableSet tables;
+    for (int s = 0; s < index_table_systems; ++s) {
+        CountingSystem current = static_cast<CountingSystem>(s);
+        if (!allSystems && current != system) continue;
+
+        std::cout << "Generating " << names.getSystemName(current) << " indices for " << rules.describe()
+                  << " with " << std::fixed << std::setprecision(1) << remaining << " decks left..."
+                  << std::endl;
+
+        tables.present[s] = true;
+        tables.tables[s] = generator.generate(Counting::getSystemTags(current), threads);
+
+        std::cout << std::endl;
+        printIndexTable(std::cout, tables.tables[s]);
+        std::cout << std::endl;
+    }
+
+    if (!outFile.empty()) {
+        try {
+            writeIndexTables(outFile, tables, rules);
+        } catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote " << outFile << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <iostream>
+#include <string>
+#include <random>
+#include "ShoeFile.h"
+#include "RuleOptions.h"
+
+void printUsage() {
+    std::cout << "Usage: bjshoe --out FILE [--shoes N] [--seed N] [--decks N] [--cut MIN-MAX]" << std::endl;
+    std::cout << "       bjshoe --info FILE" << std::endl;
+    std::cout << "  --out FILE     Write a shoe file for bjsim --shoes and Deck::useShoeFile" << std::endl;
+    std::cout << "  --shoes N      Shoes to shuffle (accepts 1e6 style values; default: 100000)" << std::endl;
+    std::cout << "  --seed N       RNG seed; the same seed writes the same shoes" << std::endl;
+    std::cout << "  --info FILE    Print what a shoe file holds" << std::endl;
+    std::cout << "Only --decks and --cut of the rule options change the shoes." << std::endl;
+    printRuleOptions();
+}
+
+int printInfo(const std::string& path) {
+    try {
+        ShoeFile file(path);
+        std::cout << path << ": " << file.getShoeCount() << " shoes of " << file.getNumDecks()
+                  << " deck(s), cut card " << file.getCutCardMin() << "-" << file.getCutCardMax()
+                  << " from the end, seed " << file.getSeed() << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    TableRules rules;
+    std::string outFile;
+    std::string infoFile;
+    uint64_t shoes = 100000;
+    uint64_t seed = std::random_device{}();
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        }
+
+        try {
+            if (parseRuleOption(argc, argv, i, rules)) {
+                continue;
+            }
+        } catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+
+        if (i + 1 >= argc) {
+            std::cout << "Missing value for " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+
+        try {
+            if (arg == "--out") {
+                outFile = argv[++i];
+            } else if (arg == "--info") {
+                infoFile = argv[++i];
+            } else if (arg == "--shoes") {
+                shoes = parseCount(argv[++i]);
+            } else if (arg == "--seed") {
+                seed = std::stoull(argv[++i]);
+            } else {
+                std::cout << "Unknown option: " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cout << "Invalid value for " << arg << ": " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    if (!infoFile.empty()) {
+        return printInfo(infoFile);
+    }
+    if (outFile.empty()) {
+        printUsage();
+        return 1;
+    }
+    if (!validateRules(rules)) {
+        return 1;
+    }
+    if (shoes == 0) {
+        std::cout << "--shoes must be at least 1" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Shuffling " << shoes << " shoes of " << rules.numDecks << " deck(s), seed "
+              << seed << "..." << std::endl;
+    try {
+        writeShoeFile(outFile, rules, shoes, seed);
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+
+    return printInfo(outFile);
+}
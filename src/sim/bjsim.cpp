@@ -0,0 +1,385 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <memory>
+#include <string>
+#include <thread>
+#include <random>
+#include <vector>
+#include "Simulator.h"
+#include "BatchSim.h"
+#include "CompareSim.h"
+#include "CrossCheck.h"
+#include "RuleOptions.h"
+
+// Random lane sets --verify-kernel plays, alternating H17 and S17
+constexpr int verify_kernel_rounds = 100000;
+
+void printUsage() {
+    std::cout << "Usage: bjsim [--hands N] [--threads N] [--seed N] [--strategy FILE] [--batch LANES]" << std::endl;
+    std::cout << "             [--shoes FILE] [--compare TABLE]... [--progress SECONDS] [--history FILE]" << std::endl;
+    std::cout << "             [rule options]" << std::endl;
+    std::cout << "  --hands N        Rounds to simulate (accepts 1e9 style values)" << std::endl;
+    std::cout << "  --threads N      Worker threads, one shoe each (default: all cores)" << std::endl;
+    std::cout << "  --seed N         Master RNG seed; same seed and threads replay the same shoes" << std::endl;
+    std::cout << "  --strategy FILE  Play a table written by bjstrat instead of the built-in one" << std::endl;
+    std::cout << "  --shoes FILE     Deal the shoes written by bjshoe instead of shuffling; the" << std::endl;
+    std::cout << "                   deck count and cut card come from the file" << std::endl;
+    std::cout << "  --compare TABLE  Also play a bjstrat table (or \"basic\" for the built-in one)" << std::endl;
+    std::cout << "                   on the same cards and report its EV difference from the" << std::endl;
+    std::cout << "                   --strategy play; repeat to compare several" << std::endl;
+    std::cout << "  --progress SECONDS  Print hands/sec and the running EV every SECONDS while" << std::endl;
+    std::cout << "                   the simulation runs" << std::endl;
+    std::cout << "  --history FILE   Log every round, cards and decisions included, for bjhist" << std::endl;
+    std::cout << "  --batch LANES    Play LANES shoes per thread in lockstep with the batch kernel" << std::endl;
+    std::cout << "                   (0 plays one table per thread; default: 0)" << std::endl;
+    std::cout << "  --dealer-kernel NAME  Dealer draws in the batch kernel: scalar, sse or avx2" << std::endl;
+    std::cout << "                   (default: the widest this CPU runs)" << std::endl;
+    std::cout << "  --verify-kernel  Check the --dealer-kernel draws against the scalar kernel on" << std::endl;
+    std::cout << "                   random lanes, then exit" << std::endl;
+    std::cout << "  --cross-check    Replay every round through the game engine on the same cards" << std::endl;
+    std::cout << "                   and stop at the first whose net differs; one thread, so keep" << std::endl;
+    std::cout << "                   --hands small" << std::endl;
+    printRuleOptions();
+}
+
+bool parseArguments(int argc, char* argv[], SimConfig& config, std::string& strategyFile, int& batchLanes,
+                    DealerKernel& dealerKernel, std::string& shoeFile,
+                    std::vector<std::string>& compareTables, double& progressSeconds,
+                    std::string& historyFile, bool& verifyKernel, bool& crossCheck) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return false;
+        }
+        if (arg == "--verify-kernel") {
+            verifyKernel = true;
+            continue;
+        }
+        if (arg == "--cross-check") {
+            crossCheck = true;
+            continue;
+        }
+
+        try {
+            if (parseRuleOption(argc, argv, i, config.rules)) {
+                continue;
+            }
+        } catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return false;
+        }
+
+        if (i + 1 >= argc) {
+            std::cout << "Missing value for " << arg << std::endl;
+            printUsage();
+            return false;
+        }
+
+        try {
+            if (arg == "--hands") {
+                config.hands = parseCount(argv[++i]);
+            } else if (arg == "--threads") {
+                config.threads = parseThreadCount(argv[++i]);
+            } else if (arg == "--seed") {
+                config.seed = std::stoull(argv[++i]);
+            } else if (arg == "--strategy") {
+                strategyFile = argv[++i];
+            } else if (arg == "--batch") {
+                batchLanes = std::stoi(argv[++i]);
+            } else if (arg == "--compare") {
+                compareTables.push_back(argv[++i]);
+            } else if (arg == "--progress") {
+                progressSeconds = std::stod(argv[++i]);
+            } else if (arg == "--history") {
+                historyFile = argv[++i];
+            } else if (arg == "--shoes") {
+                shoeFile = argv[++i];
+            } else if (arg == "--dealer-kernel") {
+                dealerKernel = parseDealerKernel(argv[++i]);
+            } else {
+                std::cout << "Unknown option: " << arg << std::endl;
+                printUsage();
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cout << "Invalid value for " << arg << ": " << argv[i] << std::endl;
+            return false;
+        }
+    }
+
+    if (batchLanes < 0) {
+        std::cout << "--batch needs a lane count of 0 or more" << std::endl;
+        return false;
+    }
+    if (batchLanes > 0 && !shoeFile.empty()) {
+        std::cout << "--shoes cannot be used with --batch" << std::endl;
+        return false;
+    }
+    if (batchLanes > 0 && !compareTables.empty()) {
+        std::cout << "--compare cannot be used with --batch" << std::endl;
+        return false;
+    }
+    if (progressSeconds < 0.0) {
+        std::cout << "--progress needs a positive interval" << std::endl;
+        return false;
+    }
+    if (progressSeconds > 0.0 && (batchLanes > 0 || !compareTables.empty())) {
+        std::cout << "--progress cannot be used with --batch or --compare" << std::endl;
+        return false;
+    }
+    if (!historyFile.empty() && (batchLanes > 0 || !compareTables.empty())) {
+        std::cout << "--history cannot be used with --batch or --compare" << std::endl;
+        return false;
+    }
+    if (crossCheck && (batchLanes > 0 || !compareTables.empty() || progressSeconds > 0.0 ||
+                       !historyFile.empty())) {
+        std::cout << "--cross-check cannot be used with --batch, --compare, --progress or --history" << std::endl;
+        return false;
+    }
+    if (!dealerKernelSupported(dealerKernel)) {
+        std::cout << "This CPU cannot run the " << dealerKernelName(dealerKernel) << " dealer kernel" << std::endl;
+        return false;
+    }
+
+    return validateRules(config.rules);
+}
+
+// Runs the simulation on another thread and prints the workers' last
+// published stats every `interval` seconds, then the exact totals
+SimResults runWithProgress(Simulator& simulator, int threads, double interval) {
+    ShardedStats live(std::max(1, threads));
+    simulator.setStats(&live);
+
+    SimResults results;
+    std::exception_ptr failure;
+    std::atomic<bool> done(false);
+    std::thread runner([&simulator, &results, &failure, &done]() {
+        try {
+            results = simulator.run();
+        } catch (...) {
+            failure = std::current_exception();
+        }
+        done = true;
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    auto lastReport = start;
+    uint64_t lastHands = 0;
+    while (!done) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        auto now = std::chrono::steady_clock::now();
+        double sinceReport = std::chrono::duration<double>(now - lastReport).count();
+        if (sinceReport < interval) continue;
+
+        RunningStats rounds = live.snapshot().getSessionResults().getRounds();
+        std::cout << "[" << std::fixed << std::setprecision(1) << std::setw(7)
+                  << std::chrono::duration<double>(now - start).count() << " s] "
+                  << rounds.count << " hands, " << std::setprecision(0)
+                  << (rounds.count - lastHands) / sinceReport << " hands/sec, EV "
+                  << std::setprecision(4) << (rounds.mean * 100.0) << "% (+/- "
+                  << (rounds.confidence95() * 100.0) << "%)" << std::endl;
+        lastReport = now;
+        lastHands = rounds.count;
+    }
+
+    runner.join();
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    live.merged().displayPlayerStats(sim_seat_name);
+    return results;
+}
+
+int main(int argc, char* argv[]) {
+    SimConfig config;
+    config.threads = std::max(1u, std::thread::hardware_concurrency());
+    config.seed = std::random_device{}();
+
+    std::string strategyFile;
+    int batchLanes = 0;
+    DealerKernel dealerKernel = bestDealerKernel();
+    std::string shoeFile;
+    std::vector<std::string> compareTables;
+    double progressSeconds = 0.0;
+    std::string historyFile;
+    bool verifyKernel = false;
+    bool crossCheck = false;
+    if (!parseArguments(argc, argv, config, strategyFile, batchLanes, dealerKernel, shoeFile, compareTables,
+                        progressSeconds, historyFile, verifyKernel, crossCheck)) {
+        return 1;
+    }
+
+    if (verifyKernel) {
+        try {
+            uint64_t lanes = verifyDealerKernel(dealerKernel, config.seed, verify_kernel_rounds);
+            std::cout << "The " << dealerKernelName(dealerKernel) << " dealer kernel matches scalar on "
+                      << lanes << " lanes" << std::endl;
+            return 0;
+        } catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    if (!shoeFile.empty()) {
+        try {
+            config.shoes = std::make_shared<const ShoeFile>(shoeFile);
+        } catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+        // Each thread deals every threads-th shoe, so without more shoes
+        // than threads a thread would replay one shoe or share another's
+        if (config.threads > 1 && config.shoes->getShoeCount() <= static_cast<uint64_t>(config.threads)) {
+            std::cout << "Shoe file " << shoeFile << " holds " << config.shoes->getShoeCount()
+                      << " shoe(s); dealing on " << config.threads << " threads needs more" << std::endl;
+            return 1;
+        }
+        config.rules.numDecks = config.shoes->getNumDecks();
+        config.rules.cutCardMin = config.shoes->getCutCardMin();
+        config.rules.cutCardMax = config.shoes->getCutCardMax();
+    }
+
+    std::cout << "Simulating " << config.hands << " hands on "
+              << config.threads << " thread(s), seed " << config.seed << "..." << std::endl;
+
+    std::cout << "Rules: " << config.rules.describe() << std::endl;
+
+    BasicStrategyHandler policy(config.rules);
+    BasicStrat strategy(config.rules);
+    if (!strategyFile.empty()) {
+        try {
+            policy.loadStrategyTables(strategyFile);
+            strategy.loadStrategyTables(strategyFile);
+        } catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+        std::cout << "Strategy: " << strategyFile << std::endl;
+    }
+    if (config.shoes) {
+        std::cout << "Shoes: " << shoeFile << " (" << config.shoes->getShoeCount() << " shoes, seed "
+                  << config.shoes->getSeed() << ")" << std::endl;
+    }
+
+    // Variants for --compare; reserved up front so the pointers stay put
+    std::vector<BasicStrategyHandler> variants;
+    variants.reserve(compareTables.size());
+    for (const std::string& table : compareTables) {
+        variants.emplace_back(config.rules);
+        if (table == "basic") continue;
+        try {
+            variants.back().loadStrategyTables(table);
+        } catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    SimResults results;
+    ComparisonResults comparison;
+    if (crossCheck) {
+        std::cout << "Cross-checking against the game engine on one thread" << std::endl;
+        EngineCrossCheck checker(config, policy);
+        try {
+            results = checker.run();
+        } catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+        std::cout << "The game engine agrees on all " << results.hands << " rounds" << std::endl;
+    } else if (!variants.empty()) {
+        std::cout << "Comparing " << variants.size() + 1 << " strategies on common cards" << std::endl;
+        std::vector<const PlayerActionHandler*> policies = {&policy};
+        for (const BasicStrategyHandler& variant : variants) {
+            policies.push_back(&variant);
+        }
+        ComparisonSimulator simulator(config, policies);
+        try {
+            comparison = simulator.run();
+        } catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+        results = comparison.policies[0];
+    } else if (batchLanes > 0) {
+        std::cout << "Batch kernel: " << batchLanes << " lanes per thread, "
+                  << dealerKernelName(dealerKernel) << " dealer draws" << std::endl;
+        try {
+            BatchSimulator simulator(config, strategy, batchLanes, dealerKernel);
+            results = simulator.run();
+        } catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+    } else {
+        Simulator simulator(config, policy);
+        try {
+            std::unique_ptr<HandHistoryWriter> history;
+            if (!historyFile.empty()) {
+                history = std::make_unique<HandHistoryWriter>(historyFile, config.rules, config.seed);
+                simulator.setHandHistory(history.get());
+                std::cout << "History: " << historyFile << std::endl;
+            }
+            results = progressSeconds > 0.0 ? runWithProgress(simulator, config.threads, progressSeconds)
+                                            : simulator.run();
+            if (history) {
+                history->close();
+            }
+        } catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    double ev = results.expectedValue();
+    double sd = results.standardDeviation();
+    double standardError = results.hands > 0 ? sd / std::sqrt(static_cast<double>(results.hands)) : 0.0;
+
+    std::cout << "\n======== SIMULATION RESULTS ========" << std::endl;
+    std::cout << "Hands Played: " << results.hands << std::endl;
+    std::cout << "Elapsed: " << std::fixed << std::setprecision(2)
+              << results.elapsedSeconds << " s" << std::endl;
+    std::cout << "Hands/sec: " << std::fixed << std::setprecision(0)
+              << results.handsPerSecond() << std::endl;
+    std::cout << "EV per hand: " << std::fixed << std::setprecision(4)
+              << (ev * 100.0) << "% (+/- " << (1.96 * standardError * 100.0) << "%)" << std::endl;
+    std::cout << "Std Dev per hand: " << std::fixed << std::setprecision(4) << sd << std::endl;
+    std::cout << "Wins/Losses/Pushes: " << results.wins << " / " << results.losses
+              << " / " << results.pushes << std::endl;
+    std::cout << "Blackjacks: " << results.blackjacks << "  Doubles: " << results.doubles
+              << "  Splits: " << results.splits << "  Surrenders: " << results.surrenders << std::endl;
+    std::cout << "====================================" << std::endl;
+
+    if (!variants.empty()) {
+        std::cout << "\n======== PAIRED COMPARISON ========" << std::endl;
+        std::cout << "Baseline: " << (strategyFile.empty() ? "built-in basic strategy" : strategyFile)
+                  << std::endl;
+        for (size_t p = 1; p < comparison.policies.size(); ++p) {
+            const SimResults& variant = comparison.policies[p];
+            const PairedDifference& difference = comparison.differences[p];
+            double variantError = variant.hands > 0
+                ? variant.standardDeviation() / std::sqrt(static_cast<double>(variant.hands)) : 0.0;
+
+            std::cout << compareTables[p - 1] << std::endl;
+            std::cout << "  EV per hand: " << std::fixed << std::setprecision(4)
+                      << (variant.expectedValue() * 100.0) << "% (+/- " << (1.96 * variantError * 100.0)
+                      << "%)" << std::endl;
+            std::cout << "  Difference from baseline: " << std::showpos << (difference.mean() * 100.0)
+                      << std::noshowpos << "% (+/- " << (1.96 * difference.standardError() * 100.0)
+                      << "%)" << std::endl;
+            std::cout << "  Separate runs would give: +/- "
+                      << (1.96 * comparison.independentStandardError(p) * 100.0) << "%" << std::endl;
+        }
+        std::cout << "====================================" << std::endl;
+    }
+
+    return 0;
+}
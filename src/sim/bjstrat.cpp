@@ -0,0 +1,143 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include "StrategyGenerator.h"
+#include "RuleOptions.h"
+
+void printUsage() {
+    std::cout << "Usage: bjstrat [--out FILE] [--composition] [--threads N] [rule options]" << std::endl;
+    std::cout << "  --out FILE      Write the table for BasicStrat::loadStrategyTables / bjsim --strategy" << std::endl;
+    std::cout << "  --composition   Also list two-card hands whose exact cards change the play" << std::endl;
+    std::cout << "  --threads N     Worker threads (default: all cores)" << std::endl;
+    printRuleOptions();
+}
+
+std::string cardName(int value) {
+    if (value == 1) return "A";
+    if (value == 10) return "T";
+    return std::to_string(value);
+}
+
+std::string actionName(Action action) {
+    switch (action) {
+        case Action::HIT: return "Hit";
+        case Action::STAND: return "Stand";
+        case Action::DOUBLE: return "Double";
+        case Action::SPLIT: return "Split";
+        case Action::SURRENDER: return "Surrender";
+        default: return "Unknown";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    TableRules rules;
+    std::string outFile;
+    bool composition = false;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        }
+        if (arg == "--composition") {
+            composition = true;
+            continue;
+        }
+
+        try {
+            if (parseRuleOption(argc, argv, i, rules)) {
+                continue;
+            }
+        } catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+
+        if (i + 1 >= argc) {
+            std::cout << "Missing value for " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+
+        if (arg == "--out") {
+            outFile = argv[++i];
+        } else if (arg == "--threads") {
+            try {
+                threads = parseThreadCount(argv[++i]);
+            } catch (const std::exception&) {
+                std::cout << "Invalid value for " << arg << ": " << argv[i] << std::endl;
+                return 1;
+            }
+        } else {
+            std::cout << "Unknown option: " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (!validateRules(rules)) {
+        return 1;
+    }
+
+    std::cout << "Generating basic strategy for " << rules.describe() << "..." << std::endl;
+
+    StrategyGenerator generator(rules);
+    StrategyTable table = generator.generate(threads);
+
+    std::cout << std::endl;
+    printStrategyTable(std::cout, table, HandType::HARD);
+    std::cout << std::endl;
+    printStrategyTable(std::cout, table, HandType::SOFT);
+    std::cout << std::endl;
+    printStrategyTable(std::cout, table, HandType::PAIR);
+
+    // How far the hand-written chart compiled into BasicStrat is from this
+    // one. A fallback only matters behind a double or surrender.
+    const StrategyTable& builtIn = strategy_tables[strategyTableIndex(rules.dealerHitsSoft17,
+                                                                      rules.doubleAfterSplit,
+                                                                      rules.lateSurrender)];
+    int differences = 0;
+    for (int type = 0; type < StrategyTable::hand_types; ++type) {
+        for (int value = 0; value < StrategyTable::values; ++value) {
+            for (int dealer = 1; dealer < StrategyTable::dealer_cards; ++dealer) {
+                Action play = table.primary[type][value][dealer];
+                bool hasFallback = play == Action::DOUBLE || play == Action::SURRENDER;
+                if (play != builtIn.primary[type][value][dealer] ||
+                    (hasFallback && table.fallback[type][value][dealer] != builtIn.fallback[type][value][dealer])) {
+                    differences++;
+                }
+            }
+        }
+    }
+    std::cout << "\nCells that differ from the built-in table: " << differences << std::endl;
+
+    if (composition) {
+        std::vector<CompositionPlay> plays = generator.findCompositionPlays(table, threads);
+
+        std::cout << "\n--- COMPOSITION-DEPENDENT PLAYS (" << plays.size() << ") ---" << std::endl;
+        for (const CompositionPlay& play : plays) {
+            std::cout << cardName(play.card1) << "," << cardName(play.card2)
+                      << " vs " << cardName(play.dealerUp) << ": "
+                      << actionName(play.bestAction) << " instead of " << actionName(play.tableAction)
+                      << " (+" << std::fixed << std::setprecision(4) << play.evGain * 100.0 << "%)"
+                      << std::endl;
+        }
+    }
+
+    if (!outFile.empty()) {
+        try {
+            writeStrategyTable(outFile, table, rules);
+        } catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+        std::cout << "\nWrote " << outFile << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,349 @@
+#include "HandHistory.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+const char hand_history_magic[4] = {'B', 'J', 'H', 'H'};
+const uint32_t hand_history_version = 1;
+
+struct HandHistoryHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t numDecks;
+    uint16_t ruleFlags;
+    uint16_t maxSplitHands;
+    double blackjackPayout;
+    uint64_t seed;
+};
+
+static_assert(sizeof(HandHistoryHeader) == 32, "the hand history header is 32 bytes");
+static_assert(sizeof(PackedCard) == 1, "hand histories store one byte per card");
+
+enum RuleFlags : uint16_t {
+    hits_soft_17 = 1,
+    double_after_split = 2,
+    resplit_aces = 4,
+    late_surrender = 8
+};
+
+// Fixed-point value of `value` / `unit`, clamped to what T holds
+template <typename T>
+T scaled(double value, double unit) {
+    // Rounded half away from zero by hand; std::round is a library call
+    double scaledValue = value / unit;
+    scaledValue += scaledValue < 0.0 ? -0.5 : 0.5;
+    scaledValue = std::min<double>(std::numeric_limits<T>::max(),
+                                   std::max<double>(std::numeric_limits<T>::min(), scaledValue));
+    return static_cast<T>(scaledValue);
+}
+
+template <typename T>
+void put(unsigned char* at, T value) {
+    std::memcpy(at, &value, sizeof(value));
+}
+
+const size_t max_count = 255;
+
+}
+
+HandRecord::HandRecord() : stream(0), seat(0) {
+    clear();
+}
+
+void HandRecord::clear() {
+    shoe = 0;
+    round = 0;
+    shoePosition = 0;
+    counted = false;
+    trueCount = 0.0;
+    dealerBlackjack = false;
+    surrendered = false;
+    blackjackPaid = false;
+    wagered = 0.0;
+    net = 0.0;
+    dealerCards.clear();
+    decisions.clear();
+    hands.clear();
+    handCards.clear();
+}
+
+void HandRecord::insertHand(int hand) {
+    for (HandDecision& decision : decisions) {
+        if (decision.hand > hand) decision.hand++;
+    }
+}
+
+HandHistoryWriter::HandHistoryWriter(const std::string& filePath, const TableRules& rules, uint64_t seed)
+    : path(filePath), file(filePath, std::ios::binary | std::ios::trunc), closing(false), failed(false) {
+    if (!file) {
+        throw std::runtime_error("Cannot write hand history: " + path);
+    }
+
+    HandHistoryHeader header;
+    std::memcpy(header.magic, hand_history_magic, sizeof(header.magic));
+    header.version = hand_history_version;
+    header.numDecks = rules.numDecks;
+    header.ruleFlags = static_cast<uint16_t>((rules.dealerHitsSoft17 ? hits_soft_17 : 0) |
+                                             (rules.doubleAfterSplit ? double_after_split : 0) |
+                                             (rules.resplitAces ? resplit_aces : 0) |
+                                             (rules.lateSurrender ? late_surrender : 0));
+    header.maxSplitHands = static_cast<uint16_t>(rules.maxSplitHands);
+    header.blackjackPayout = rules.blackjackPayout;
+    header.seed = seed;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!file) {
+        throw std::runtime_error("Failed writing hand history: " + path);
+    }
+
+    writerThread = std::thread(&HandHistoryWriter::run, this);
+}
+
+HandHistoryWriter::~HandHistoryWriter() {
+    try {
+        close();
+    } catch (const std::exception&) {
+        // Nowhere to report it from a destructor
+    }
+}
+
+void HandHistoryWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        queued.wait(lock, [this]() { return !queue.empty() || closing; });
+        if (queue.empty()) break;
+
+        std::vector<unsigned char> batch = std::move(queue.front());
+        queue.pop_front();
+        bool skip = failed;
+
+        // The disk is the slow part; recorders keep queueing meanwhile
+        lock.unlock();
+        if (!skip) {
+            file.write(reinterpret_cast<const char*>(batch.data()), static_cast<std::streamsize>(batch.size()));
+        }
+        lock.lock();
+
+        if (!file) failed = true;
+        batch.clear();
+        spare.push_back(std::move(batch));
+        written.notify_all();
+    }
+}
+
+void HandHistoryWriter::submit(std::vector<unsigned char>& batch) {
+    std::unique_lock<std::mutex> lock(mutex);
+    written.wait(lock, [this]() { return queue.size() < max_queued_batches || failed; });
+    if (failed) {
+        throw std::runtime_error("Failed writing hand history: " + path);
+    }
+    if (closing) {
+        throw std::runtime_error("Hand history is closed: " + path);
+    }
+
+    queue.push_back(std::move(batch));
+    if (!spare.empty()) {
+        batch = std::move(spare.back());
+        spare.pop_back();
+    } else {
+        batch = std::vector<unsigned char>();
+        batch.reserve(batch_bytes);
+    }
+    queued.notify_one();
+}
+
+void HandHistoryWriter::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = true;
+    }
+    queued.notify_one();
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+
+    if (file.is_open()) {
+        file.close();
+        if (!file) failed = true;
+    }
+    if (failed) {
+        throw std::runtime_error("Failed writing hand history: " + path);
+    }
+}
+
+HandHistoryRecorder::HandHistoryRecorder(HandHistoryWriter& historyWriter) : writer(historyWriter), used(0) {
+    batch.resize(HandHistoryWriter::batch_bytes);
+}
+
+HandHistoryRecorder::~HandHistoryRecorder() {
+    try {
+        flush();
+    } catch (const std::exception&) {
+        // The writer reports the failure from close()
+    }
+}
+
+void HandHistoryRecorder::append(const HandRecord& record) {
+    const std::vector<PackedCard>& dealerCards = record.getDealerCards();
+    const std::vector<HandDecision>& decisions = record.getDecisions();
+    const std::vector<HandRecord::HandResult>& hands = record.getHands();
+    const std::vector<PackedCard>& handCards = record.getHandCards();
+
+    if (dealerCards.size() > max_count || decisions.size() > max_count || hands.size() > max_count) {
+        throw std::length_error("Round is too long for the hand history");
+    }
+
+    size_t size = HandRecordView::fixed_bytes + dealerCards.size() +
+                  decisions.size() * HandRecordView::decision_bytes +
+                  hands.size() * HandRecordView::hand_bytes + handCards.size();
+
+    if (used + size > batch.size()) {
+        flush();
+    }
+
+    unsigned char* at = batch.data() + used;
+    used += size;
+
+    uint8_t flags = (record.counted ? HandRecordView::counted_flag : 0) |
+                    (record.dealerBlackjack ? HandRecordView::dealer_blackjack_flag : 0) |
+                    (record.surrendered ? HandRecordView::surrendered_flag : 0) |
+                    (record.blackjackPaid ? HandRecordView::blackjack_paid_flag : 0);
+
+    // Offsets as read back by HandRecordView
+    put<uint16_t>(at, static_cast<uint16_t>(size));
+    put<uint16_t>(at + 2, record.stream);
+    put<uint32_t>(at + 4, static_cast<uint32_t>(record.shoe));
+    put<uint64_t>(at + 8, record.round);
+    put<uint16_t>(at + 16, static_cast<uint16_t>(record.shoePosition));
+    put<int16_t>(at + 18, record.counted ? scaled<int16_t>(record.trueCount, 0.1) : int16_t(0));
+    put<uint16_t>(at + 20, scaled<uint16_t>(record.wagered, 0.01));
+    at[22] = static_cast<unsigned char>(decisions.size());
+    at[23] = 0;
+    put<int32_t>(at + 24, scaled<int32_t>(record.net, 0.01));
+    at[28] = record.seat;
+    at[29] = flags;
+    at[30] = static_cast<unsigned char>(dealerCards.size());
+    at[31] = static_cast<unsigned char>(hands.size());
+    at += HandRecordView::fixed_bytes;
+
+    for (PackedCard card : dealerCards) {
+        *at++ = card.getBits();
+    }
+
+    for (const HandDecision& decision : decisions) {
+        at[0] = static_cast<unsigned char>(decision.hand);
+        at[1] = static_cast<unsigned char>((decision.total & 0x1F) | (decision.soft ? 0x20 : 0) |
+                                           (decision.pair ? 0x40 : 0) | (decision.twoCards ? 0x80 : 0));
+        at[2] = static_cast<unsigned char>(decision.action);
+        at += HandRecordView::decision_bytes;
+    }
+
+    const PackedCard* cards = handCards.data();
+    for (const HandRecord::HandResult& hand : hands) {
+        at[0] = static_cast<unsigned char>(hand.cardCount);
+        at[1] = static_cast<unsigned char>(hand.betUnits);
+        put<int16_t>(at + 2, scaled<int16_t>(hand.net, 0.01));
+        at += HandRecordView::hand_bytes;
+        for (int i = 0; i < hand.cardCount; ++i) {
+            *at++ = (cards++)->getBits();
+        }
+    }
+}
+
+void HandHistoryRecorder::flush() {
+    if (used == 0) return;
+
+    batch.resize(used);
+    used = 0;
+    writer.submit(batch);
+    // Spare batches come back empty; the one resize keeps append from
+    // zeroing bytes per record
+    batch.resize(HandHistoryWriter::batch_bytes);
+}
+
+HandDecision HandRecordView::getDecision(int index) const {
+    const unsigned char* at = data + fixed_bytes + getDealerCardCount() + index * decision_bytes;
+
+    HandDecision decision;
+    decision.hand = at[0];
+    decision.total = at[1] & 0x1F;
+    decision.soft = (at[1] & 0x20) != 0;
+    decision.pair = (at[1] & 0x40) != 0;
+    decision.twoCards = (at[1] & 0x80) != 0;
+    decision.action = static_cast<Action>(at[2]);
+    return decision;
+}
+
+HandRecordView::LoggedHand HandRecordView::getHand(int index) const {
+    size_t offset = fixed_bytes + getDealerCardCount() + getDecisionCount() * decision_bytes;
+    for (int i = 0; i < index; ++i) {
+        offset += hand_bytes + data[offset];
+    }
+
+    LoggedHand hand;
+    hand.cards = reinterpret_cast<const PackedCard*>(data + offset + hand_bytes);
+    hand.cardCount = data[offset];
+    hand.betUnits = data[offset + 1];
+    hand.net = field<int16_t>(offset + 2) / 100.0;
+    return hand;
+}
+
+bool HandRecordView::isWellFormed(const unsigned char* record, size_t available) {
+    if (available < fixed_bytes) return false;
+
+    HandRecordView view(record);
+    size_t size = view.getSize();
+    int handCount = view.getHandCount();
+    if (size < fixed_bytes || size > available || view.getDealerCardCount() < 1 || handCount < 1) {
+        return false;
+    }
+
+    size_t offset = fixed_bytes + view.getDealerCardCount();
+    if (offset + view.getDecisionCount() * decision_bytes > size) return false;
+    for (int i = 0; i < view.getDecisionCount(); ++i) {
+        if (record[offset] >= handCount) return false;
+        offset += decision_bytes;
+    }
+    for (int i = 0; i < handCount; ++i) {
+        if (offset + hand_bytes > size) return false;
+        offset += hand_bytes + record[offset];
+    }
+    return offset == size;
+}
+
+HandHistoryFile::HandHistoryFile(const std::string& filePath) : file(filePath, "hand history"), seed(0) {
+    if (file.getSize() < sizeof(HandHistoryHeader)) {
+        throw std::runtime_error("Not a hand history: " + file.getPath());
+    }
+
+    HandHistoryHeader header;
+    std::memcpy(&header, file.getData(), sizeof(header));
+    if (std::memcmp(header.magic, hand_history_magic, sizeof(header.magic)) != 0 ||
+        header.version != hand_history_version) {
+        throw std::runtime_error("Not a hand history: " + file.getPath());
+    }
+    if (header.numDecks < 1 || header.numDecks > TableRules::max_decks || header.maxSplitHands < 1 ||
+        header.maxSplitHands > TableRules::max_split_hands) {
+        throw std::runtime_error("Hand history is damaged: " + file.getPath());
+    }
+
+    rules.numDecks = header.numDecks;
+    rules.dealerHitsSoft17 = (header.ruleFlags & hits_soft_17) != 0;
+    rules.doubleAfterSplit = (header.ruleFlags & double_after_split) != 0;
+    rules.resplitAces = (header.ruleFlags & resplit_aces) != 0;
+    rules.lateSurrender = (header.ruleFlags & late_surrender) != 0;
+    rules.maxSplitHands = header.maxSplitHands;
+    rules.blackjackPayout = header.blackjackPayout;
+    seed = header.seed;
+}
+
+HandHistoryFile::Iterator HandHistoryFile::begin() const {
+    return Iterator(file.getData() + sizeof(HandHistoryHeader), file.getData() + file.getSize());
+}
+
+HandHistoryFile::Iterator HandHistoryFile::end() const {
+    const unsigned char* last = file.getData() + file.getSize();
+    return Iterator(last, last);
+}
@@ -0,0 +1,320 @@
+#ifndef HANDHISTORY_H
+#define HANDHISTORY_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "card.h"
+#include "MappedFile.h"
+#include "StrategyTables.h"
+#include "TableRules.h"
+
+// A log of every round played, one record per seat, for questions the
+// running totals cannot answer afterwards ("how did hard 16 against a ten
+// do at a true count of 0 or more?"). The file is a 32-byte header with the
+// rules and seed, then records back to back, each:
+//
+//   32-byte fixed part (see HandRecordView for the fields)
+//   the dealer's cards, up card first, one PackedCard byte each
+//   3 bytes per decision: hand index, hand state, Action
+//   per hand: card count, bet units, int16 net in hundredths, the cards
+//
+// Multi-byte fields are little-endian on the machines we build for and are
+// read with memcpy, so records need no alignment. Decisions come before the
+// hands so a scan can reach any decision without walking the hands.
+
+// A decision as logged: the hand it was made on and what that hand was
+struct HandDecision {
+    int hand;           // index into the round's hands, in settlement order
+    int total;
+    bool soft;
+    bool pair;          // two cards that may be split
+    bool twoCards;
+    Action action;
+
+    HandDecision() : hand(0), total(0), soft(false), pair(false), twoCards(false), action(Action::STAND) {}
+};
+
+// One seat's round, filled in as it is played and handed to a
+// HandHistoryRecorder. clear() keeps the storage, so a table can stage
+// every round in the same HandRecord without allocating.
+class HandRecord {
+public:
+    struct HandResult {
+        int cardCount;
+        int betUnits;
+        double net;
+    };
+
+    uint16_t stream;        // table or worker that played it
+    uint8_t seat;
+    uint64_t shoe;          // Deck::getShoeNumber
+    uint64_t round;
+    int shoePosition;       // cards dealt from the shoe before the round
+    bool counted;
+    double trueCount;       // at the deal; only when counted
+    bool dealerBlackjack;
+    bool surrendered;
+    bool blackjackPaid;
+    double wagered;         // units
+    double net;
+
+private:
+    std::vector<PackedCard> dealerCards;
+    std::vector<HandDecision> decisions;
+    std::vector<HandResult> hands;
+    std::vector<PackedCard> handCards;
+
+public:
+    HandRecord();
+
+    // Empties the round; stream and seat are kept
+    void clear();
+
+    // `Cards` is a Player, Dealer or Hand
+    template <typename Cards>
+    void setDealer(const Cards& dealer) {
+        dealerCards.clear();
+        for (size_t i = 0; i < dealer.getCardCount(); ++i) {
+            dealerCards.push_back(dealer.getPackedCard(static_cast<int>(i)));
+        }
+    }
+
+    // `action` as played on `cards`, before it changed them
+    template <typename Cards>
+    void addDecision(int hand, const Cards& cards, Action action) {
+        HandDecision decision;
+        decision.hand = hand;
+        decision.total = cards.getTotalValue();
+        decision.soft = cards.isSoft();
+        decision.twoCards = cards.getCardCount() == 2;
+        if (decision.twoCards) {
+            // Any two ten-valued cards count, as they split
+            int value1 = std::min(cards.getPackedCard(0).getValue(), 10);
+            int value2 = std::min(cards.getPackedCard(1).getValue(), 10);
+            decision.pair = value1 == value2;
+        }
+        decision.action = action;
+        decisions.push_back(decision);
+    }
+
+    // A split put a new hand right after `hand`; decisions already made on
+    // later hands move up one
+    void insertHand(int hand);
+
+    // Hands in settlement order, once the round is over
+    template <typename Cards>
+    void addHand(const Cards& cards, int betUnits, double handNet) {
+        HandResult result;
+        result.cardCount = static_cast<int>(cards.getCardCount());
+        result.betUnits = betUnits;
+        result.net = handNet;
+        hands.push_back(result);
+        for (size_t i = 0; i < cards.getCardCount(); ++i) {
+            handCards.push_back(cards.getPackedCard(static_cast<int>(i)));
+        }
+    }
+
+    const std::vector<PackedCard>& getDealerCards() const { return dealerCards; }
+    const std::vector<HandDecision>& getDecisions() const { return decisions; }
+    const std::vector<HandResult>& getHands() const { return hands; }
+    const std::vector<PackedCard>& getHandCards() const { return handCards; }
+};
+
+// Owns the log file and a thread that writes it. Recorders fill batches on
+// their own threads and hand them over whole, so a table pays for a memcpy
+// per round and a lock per batch; the disk is only waited on when it falls
+// max_queued_batches behind.
+class HandHistoryWriter {
+public:
+    static constexpr size_t batch_bytes = 1 << 16;
+    static constexpr size_t max_queued_batches = 16;
+
+private:
+    std::string path;
+    std::ofstream file;
+    std::thread writerThread;
+    std::mutex mutex;
+    std::condition_variable queued;     // a batch arrived, or closing
+    std::condition_variable written;    // a batch left the queue
+    std::deque<std::vector<unsigned char>> queue;
+    std::vector<std::vector<unsigned char>> spare;  // written batches, for reuse
+    bool closing;
+    bool failed;
+
+    void run();
+
+public:
+    // Creates or truncates `filePath` and writes the header. Throws
+    // std::runtime_error if the file cannot be written.
+    HandHistoryWriter(const std::string& filePath, const TableRules& rules, uint64_t seed);
+    // Closes the file; close() first to hear about write errors
+    ~HandHistoryWriter();
+
+    HandHistoryWriter(const HandHistoryWriter&) = delete;
+    HandHistoryWriter& operator=(const HandHistoryWriter&) = delete;
+
+    // Queues `batch` and leaves an empty buffer in its place. Thread-safe.
+    // Throws std::runtime_error once a write has failed or after close().
+    void submit(std::vector<unsigned char>& batch);
+
+    // Writes everything queued and closes the file. Throws
+    // std::runtime_error if any write failed.
+    void close();
+
+    const std::string& getPath() const { return path; }
+};
+
+// Encodes records into batches for a HandHistoryWriter. One per thread:
+// a recorder is not synchronised, the writer is.
+class HandHistoryRecorder {
+private:
+    HandHistoryWriter& writer;
+    std::vector<unsigned char> batch;   // kept at batch_bytes; the first `used` are records
+    size_t used;
+
+public:
+    explicit HandHistoryRecorder(HandHistoryWriter& historyWriter);
+    // Submits what is left; errors are dropped, so flush() first to see them
+    ~HandHistoryRecorder();
+
+    HandHistoryRecorder(const HandHistoryRecorder&) = delete;
+    HandHistoryRecorder& operator=(const HandHistoryRecorder&) = delete;
+
+    // Throws std::length_error for a round with more than 255 hands,
+    // decisions or dealer cards, and what submit throws
+    void append(const HandRecord& record);
+    void flush();
+};
+
+// A record in a mapped log. Reads the bytes in place; nothing is decoded
+// until asked for.
+class HandRecordView {
+public:
+    static constexpr size_t fixed_bytes = 32;
+    static constexpr size_t decision_bytes = 3;
+    static constexpr size_t hand_bytes = 4;     // before the hand's cards
+
+    enum Flags : uint8_t {
+        counted_flag = 1,
+        dealer_blackjack_flag = 2,
+        surrendered_flag = 4,
+        blackjack_paid_flag = 8
+    };
+
+    struct LoggedHand {
+        const PackedCard* cards;
+        int cardCount;
+        int betUnits;
+        double net;
+    };
+
+private:
+    const unsigned char* data;
+
+    template <typename T>
+    T field(size_t offset) const {
+        T value;
+        std::memcpy(&value, data + offset, sizeof(value));
+        return value;
+    }
+
+public:
+    explicit HandRecordView(const unsigned char* record) : data(record) {}
+
+    // The fixed part, by byte offset
+    size_t getSize() const { return field<uint16_t>(0); }
+    int getStream() const { return field<uint16_t>(2); }
+    uint32_t getShoe() const { return field<uint32_t>(4); }
+    uint64_t getRound() const { return field<uint64_t>(8); }
+    int getShoePosition() const { return field<uint16_t>(16); }
+    double getTrueCount() const { return field<int16_t>(18) / 10.0; }
+    double getWagered() const { return field<uint16_t>(20) / 100.0; }
+    int getDecisionCount() const { return data[22]; }
+    // 23 is reserved
+    double getNet() const { return field<int32_t>(24) / 100.0; }
+    int getSeat() const { return data[28]; }
+    uint8_t getFlags() const { return data[29]; }
+    int getDealerCardCount() const { return data[30]; }
+    int getHandCount() const { return data[31]; }
+
+    bool isCounted() const { return (getFlags() & counted_flag) != 0; }
+    bool dealerHasBlackjack() const { return (getFlags() & dealer_blackjack_flag) != 0; }
+    bool isSurrendered() const { return (getFlags() & surrendered_flag) != 0; }
+    bool isBlackjackPaid() const { return (getFlags() & blackjack_paid_flag) != 0; }
+
+    const PackedCard* getDealerCards() const {
+        return reinterpret_cast<const PackedCard*>(data + fixed_bytes);
+    }
+    PackedCard getUpCard() const { return getDealerCards()[0]; }
+
+    HandDecision getDecision(int index) const;
+    // Walks the hands before it; there are at most a handful
+    LoggedHand getHand(int index) const;
+
+    // Whether the counts inside the record fit in `size` bytes, so every
+    // getter above stays in it
+    static bool isWellFormed(const unsigned char* record, size_t available);
+};
+
+// A hand-history log mapped read-only. Iterating visits each record in
+// file order without copying; the scan stops early at a record that was
+// cut short (a run that died mid-write) or does not add up.
+class HandHistoryFile {
+private:
+    MappedFile file;
+    TableRules rules;
+    uint64_t seed;
+
+public:
+    class Iterator {
+    private:
+        const unsigned char* at;
+        const unsigned char* end;
+        bool stopped;   // at a bad record; compares equal to end()
+
+        void check() {
+            stopped = at != end && !HandRecordView::isWellFormed(at, static_cast<size_t>(end - at));
+        }
+        const unsigned char* current() const { return stopped ? end : at; }
+
+    public:
+        Iterator(const unsigned char* position, const unsigned char* last)
+            : at(position), end(last), stopped(false) {
+            check();
+        }
+
+        HandRecordView operator*() const { return HandRecordView(at); }
+        Iterator& operator++() {
+            at += HandRecordView(at).getSize();
+            check();
+            return *this;
+        }
+        bool operator!=(const Iterator& other) const { return current() != other.current(); }
+        // Where the scan is, or where it stopped short of the end
+        const unsigned char* position() const { return at; }
+    };
+
+    // Throws std::runtime_error if the file is missing or not a hand history
+    explicit HandHistoryFile(const std::string& filePath);
+
+    const std::string& getPath() const { return file.getPath(); }
+    size_t getSize() const { return file.getSize(); }
+    // Cut card placement is not logged and stays at its default
+    const TableRules& getRules() const { return rules; }
+    uint64_t getSeed() const { return seed; }
+
+    Iterator begin() const;
+    Iterator end() const;
+    // Bytes from the start of the file to `at`; the file size at the end
+    size_t getOffset(const Iterator& at) const { return static_cast<size_t>(at.position() - file.getData()); }
+};
+
+#endif
@@ -0,0 +1,88 @@
+#include "LogHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+LogHistogram::LogHistogram() : count(0), minimum(0), maximum(0), sum(0.0) {}
+
+uint64_t LogHistogram::lowestIn(int bucket) {
+    if (bucket < 2 * sub_buckets) {
+        return static_cast<uint64_t>(bucket);
+    }
+    int shift = bucket / sub_buckets - 1;
+    uint64_t top = static_cast<uint64_t>(sub_buckets + bucket % sub_buckets);
+    return top << shift;
+}
+
+uint64_t LogHistogram::highestIn(int bucket) {
+    if (bucket < 2 * sub_buckets) {
+        return static_cast<uint64_t>(bucket);
+    }
+    int shift = bucket / sub_buckets - 1;
+    uint64_t top = static_cast<uint64_t>(sub_buckets + bucket % sub_buckets);
+    // Wraps to the largest uint64_t for the very last bucket, as it should
+    return ((top + 1) << shift) - 1;
+}
+
+void LogHistogram::merge(const LogHistogram& other) {
+    if (other.count == 0) return;
+
+    if (!other.positive.empty()) {
+        if (positive.empty()) positive.assign(bucket_count, 0);
+        for (int i = 0; i < bucket_count; ++i) positive[i] += other.positive[i];
+    }
+    if (!other.negative.empty()) {
+        if (negative.empty()) negative.assign(bucket_count, 0);
+        for (int i = 0; i < bucket_count; ++i) negative[i] += other.negative[i];
+    }
+
+    minimum = count > 0 ? std::min(minimum, other.minimum) : other.minimum;
+    maximum = count > 0 ? std::max(maximum, other.maximum) : other.maximum;
+    count += other.count;
+    sum += other.sum;
+}
+
+void LogHistogram::reset() {
+    positive.clear();
+    negative.clear();
+    count = 0;
+    minimum = 0;
+    maximum = 0;
+    sum = 0.0;
+}
+
+int64_t LogHistogram::valueAtPercentile(double percentile) const {
+    if (count == 0) return 0;
+
+    double fraction = std::min(100.0, std::max(0.0, percentile)) / 100.0;
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(count))));
+
+    // Negative values run from the largest magnitude up to -1, then zero
+    // and the positive buckets; the top of a bucket is its value nearest
+    // +infinity, the lowest magnitude for a negative one
+    uint64_t seen = 0;
+    int64_t value = maximum;
+    bool found = false;
+    if (!negative.empty()) {
+        for (int i = bucket_count - 1; i >= 0 && !found; --i) {
+            seen += negative[i];
+            if (seen >= rank) {
+                uint64_t magnitude = lowestIn(i);
+                value = magnitude > static_cast<uint64_t>(INT64_MAX) ? INT64_MIN
+                                                                     : -static_cast<int64_t>(magnitude);
+                found = true;
+            }
+        }
+    }
+    if (!positive.empty()) {
+        for (int i = 0; i < bucket_count && !found; ++i) {
+            seen += positive[i];
+            if (seen >= rank) {
+                value = static_cast<int64_t>(std::min<uint64_t>(highestIn(i), static_cast<uint64_t>(INT64_MAX)));
+                found = true;
+            }
+        }
+    }
+
+    return std::min(maximum, std::max(minimum, value));
+}
@@ -0,0 +1,78 @@
+#ifndef LOGHISTOGRAM_H
+#define LOGHISTOGRAM_H
+
+#include <cstdint>
+#include <vector>
+
+// Counts of integer values in log-spaced buckets, in the manner of an HDR
+// histogram: exact below 64, then 32 buckets per power of two, so a value
+// read back is within about 3% of the one recorded. Recording is a few
+// bit operations; memory is fixed at 15 KB per sign, taken on the first
+// value of that sign. Histograms from several threads add with merge().
+class LogHistogram {
+public:
+    static constexpr int sub_bucket_bits = 5;
+    static constexpr int sub_buckets = 1 << sub_bucket_bits;
+    static constexpr int bucket_count = sub_buckets * (64 - sub_bucket_bits + 1);
+
+private:
+    std::vector<uint64_t> positive;     // zero and up, by bucketFor
+    std::vector<uint64_t> negative;     // by bucketFor of the magnitude
+    uint64_t count;
+    int64_t minimum;
+    int64_t maximum;
+    double sum;
+
+public:
+    LogHistogram();
+
+    static int bucketFor(uint64_t magnitude) {
+        if (magnitude < 2 * static_cast<uint64_t>(sub_buckets)) {
+            return static_cast<int>(magnitude);
+        }
+        int shift = highestBit(magnitude) - sub_bucket_bits;
+        return sub_buckets * (shift + 1) + static_cast<int>(magnitude >> shift) - sub_buckets;
+    }
+    // Smallest and largest magnitudes that land in `bucket`
+    static uint64_t lowestIn(int bucket);
+    static uint64_t highestIn(int bucket);
+
+    void record(int64_t value) {
+        if (value >= 0) {
+            if (positive.empty()) positive.assign(bucket_count, 0);
+            positive[bucketFor(static_cast<uint64_t>(value))]++;
+        } else {
+            if (negative.empty()) negative.assign(bucket_count, 0);
+            negative[bucketFor(0 - static_cast<uint64_t>(value))]++;
+        }
+        if (count == 0 || value < minimum) minimum = value;
+        if (count == 0 || value > maximum) maximum = value;
+        count++;
+        sum += static_cast<double>(value);
+    }
+
+    void merge(const LogHistogram& other);
+    void reset();
+
+    uint64_t getCount() const { return count; }
+    int64_t getMin() const { return minimum; }
+    int64_t getMax() const { return maximum; }
+    double getMean() const { return count > 0 ? sum / static_cast<double>(count) : 0.0; }
+
+    // Value at or below which `percentile` percent (0-100) of the recorded
+    // values fall, reported as the top of its bucket; 0 when empty
+    int64_t valueAtPercentile(double percentile) const;
+
+private:
+    static int highestBit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(value);
+#else
+        int bit = 0;
+        while (value >>= 1) bit++;
+        return bit;
+#endif
+    }
+};
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef RUNNINGSTATS_H
+#define RUNNINGSTATS_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+// Welford's running mean and variance. Stable over billions of samples,
+// where summing squares loses the variance to rounding. Two accumulators
+// combine exactly with merge(), so each thread can keep its own.
+struct RunningStats {
+    uint64_t count;
+    double mean;
+    double m2;      // sum of squared distances from the mean
+
+    RunningStats() : count(0), mean(0.0), m2(0.0) {}
+
+    void add(double value) {
+        count++;
+        double delta = value - mean;
+        mean += delta / static_cast<double>(count);
+        m2 += delta * (value - mean);
+    }
+
+    void merge(const RunningStats& other) {
+        if (other.count == 0) return;
+        if (count == 0) {
+            *this = other;
+            return;
+        }
+        double total = static_cast<double>(count + other.count);
+        double delta = other.mean - mean;
+        mean += delta * static_cast<double>(other.count) / total;
+        m2 += other.m2 + delta * delta * static_cast<double>(count) * static_cast<double>(other.count) / total;
+        count += other.count;
+    }
+
+    double sum() const { return mean * static_cast<double>(count); }
+    double variance() const { return count > 1 ? m2 / static_cast<double>(count - 1) : 0.0; }
+    double standardDeviation() const { return std::sqrt(variance()); }
+    double standardError() const { return count > 0 ? std::sqrt(variance() / static_cast<double>(count)) : 0.0; }
+    double confidence95() const { return 1.96 * standardError(); }
+};
+
+// Units won per round, overall and by the true count the round was dealt
+// at, plus the units put at risk for EV per unit wagered. Meant to be
+// filled by one thread and merged afterwards; nothing here locks.
+class ResultAccumulator {
+public:
+    // Counts past either end share the last bucket
+    static constexpr int min_true_count = -10;
+    static constexpr int max_true_count = 10;
+    static constexpr int bucket_count = max_true_count - min_true_count + 1;
+
+private:
+    RunningStats rounds;
+    std::array<RunningStats, bucket_count> byTrueCount;
+    double wagered;
+
+public:
+    ResultAccumulator() : wagered(0.0) {}
+
+    // Bucket a true count falls in: floor, so +2 holds 2.0 up to 3.0
+    static int bucketFor(double trueCount) {
+        int count = static_cast<int>(std::floor(trueCount));
+        return std::clamp(count, min_true_count, max_true_count) - min_true_count;
+    }
+
+    void add(double unitsWon, double unitsWagered) {
+        rounds.add(unitsWon);
+        wagered += unitsWagered;
+    }
+
+    void add(double unitsWon, double unitsWagered, double trueCount) {
+        add(unitsWon, unitsWagered);
+        byTrueCount[bucketFor(trueCount)].add(unitsWon);
+    }
+
+    void merge(const ResultAccumulator& other) {
+        rounds.merge(other.rounds);
+        for (int i = 0; i < bucket_count; ++i) {
+            byTrueCount[i].merge(other.byTrueCount[i]);
+        }
+        wagered += other.wagered;
+    }
+
+    const RunningStats& getRounds() const { return rounds; }
+    const RunningStats& getTrueCountBucket(int trueCount) const {
+        return byTrueCount[bucketFor(trueCount)];
+    }
+    double getWagered() const { return wagered; }
+
+    // Money-weighted: what each unit bet returned, doubles and splits included
+    double evPerUnitWagered() const { return wagered > 0.0 ? rounds.sum() / wagered : 0.0; }
+};
+
+#endif
@@ -0,0 +1,72 @@
+#include "ShardedStats.h"
+
+#include <stdexcept>
+#include <string>
+
+ShardedStats::ShardedStats(int count, std::shared_ptr<PlayerRegistry> playerRegistry)
+    : registry(std::move(playerRegistry)), shardCount(count) {
+    if (shardCount < 1) {
+        throw std::invalid_argument("ShardedStats needs at least one shard");
+    }
+    if (!registry) {
+        throw std::invalid_argument("ShardedStats needs a player registry");
+    }
+
+    // Records are allocated on first use, by the worker that owns them
+    shards.reset(new Shard[shardCount]);
+    for (int s = 0; s < shardCount; ++s) {
+        Shard& shard = shards[s];
+        shard.working.usePlayerRegistry(registry);
+        for (Stats& buffer : shard.published) {
+            buffer.usePlayerRegistry(registry);
+        }
+    }
+}
+
+ShardedStats::ShardedStats(int count)
+    : ShardedStats(count, std::make_shared<PlayerRegistry>()) {}
+
+ShardedStats::Shard& ShardedStats::shardAt(int shard) const {
+    if (shard < 0 || shard >= shardCount) {
+        throw std::out_of_range("No stats shard " + std::to_string(shard));
+    }
+    return shards[shard];
+}
+
+Stats& ShardedStats::getShard(int shard) {
+    return shardAt(shard).working;
+}
+
+void ShardedStats::publish(int shard) {
+    Shard& target = shardAt(shard);
+
+    // Reuses the buffer's storage once the player count settles
+    target.published[target.back] = target.working;
+    int previous = target.middle.exchange(target.back | fresh_buffer, std::memory_order_acq_rel);
+    target.back = previous & buffer_index;
+}
+
+Stats ShardedStats::snapshot() {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+
+    Stats total;
+    total.usePlayerRegistry(registry);
+    for (int s = 0; s < shardCount; ++s) {
+        Shard& shard = shards[s];
+        if (shard.middle.load(std::memory_order_relaxed) & fresh_buffer) {
+            int previous = shard.middle.exchange(shard.front, std::memory_order_acq_rel);
+            shard.front = previous & buffer_index;
+        }
+        total.merge(shard.published[shard.front]);
+    }
+    return total;
+}
+
+Stats ShardedStats::merged() const {
+    Stats total;
+    total.usePlayerRegistry(registry);
+    for (int s = 0; s < shardCount; ++s) {
+        total.merge(shards[s].working);
+    }
+    return total;
+}
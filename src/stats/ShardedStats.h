@@ -0,0 +1,78 @@
+#ifndef SHARDEDSTATS_H
+#define SHARDEDSTATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include "PlayerRegistry.h"
+#include "Stats.h"
+
+// Stats for many worker threads with nothing shared on the hot path. Each
+// worker owns a shard and updates it with plain stores; every so often it
+// publishes a copy through a triple buffer, and a monitoring thread merges
+// the latest copies while the run goes on. Workers never wait for the
+// monitor, and the monitor never waits for a worker.
+//
+// Intern every player before the workers start: shards index by PlayerId
+// and the registry is not synchronised.
+class ShardedStats {
+public:
+    static constexpr size_t cache_line_size = 64;
+
+private:
+    // The three groups sit on their own cache lines so a worker counting
+    // hands never shares a line with the monitor
+    struct alignas(cache_line_size) Shard {
+        // Worker side: live tallies, and the buffer the next publish fills
+        alignas(cache_line_size) Stats working;
+        int back;
+
+        // Buffer index handed between the sides; fresh_buffer is set while
+        // it holds a copy the monitor has not taken yet
+        alignas(cache_line_size) std::atomic<int> middle;
+
+        // Monitor side: the buffer it last took
+        alignas(cache_line_size) int front;
+
+        Stats published[3];
+
+        Shard() : back(0), middle(1), front(2) {}
+    };
+
+    static constexpr int fresh_buffer = 4;
+    static constexpr int buffer_index = 3;
+
+    std::shared_ptr<PlayerRegistry> registry;
+    std::unique_ptr<Shard[]> shards;
+    int shardCount;
+    std::mutex snapshotMutex;   // between monitoring threads only
+
+    Shard& shardAt(int shard) const;
+
+public:
+    // Throws std::invalid_argument for fewer than one shard
+    ShardedStats(int count, std::shared_ptr<PlayerRegistry> playerRegistry);
+    explicit ShardedStats(int count);
+
+    ShardedStats(const ShardedStats&) = delete;
+    ShardedStats& operator=(const ShardedStats&) = delete;
+
+    int getShardCount() const { return shardCount; }
+    PlayerRegistry& getPlayerRegistry() const { return *registry; }
+
+    // For the worker that owns `shard` only. Both throw std::out_of_range
+    // for a shard past the end.
+    Stats& getShard(int shard);
+    void publish(int shard);
+
+    // Any thread, while the workers run: each shard as of its last publish,
+    // merged. The display methods of Stats work on the result.
+    Stats snapshot();
+
+    // Exact totals, including rounds since the last publish; only once
+    // every worker has stopped
+    Stats merged() const;
+};
+
+#endif
@@ -1,27 +1,162 @@
 #include "Stats.h"
 #include <iostream>
 #include <iomanip>
+#include <cmath>
+#include <stdexcept>
 
-Stats::Stats() : totalGamesPlayed(0) {}
+namespace {
+
+// Rows of the session percentile tables; 100 is the worst case seen
+const double session_percentiles[] = {1.0, 5.0, 10.0, 25.0, 50.0, 75.0, 90.0, 95.0, 99.0, 99.9, 100.0};
+
+int64_t hundredthsOf(double units) {
+    return static_cast<int64_t>(std::llround(units * SessionHistograms::hundredths_per_unit));
+}
+
+double unitsOf(int64_t hundredths) {
+    return static_cast<double>(hundredths) / SessionHistograms::hundredths_per_unit;
+}
+
+// EV per round with its 95% interval, then per unit wagered
+void printExpectedValue(const ResultAccumulator& results, const std::string& indent) {
+    const RunningStats& rounds = results.getRounds();
+    std::cout << indent << "EV per Round: " << std::showpos << std::fixed << std::setprecision(4)
+              << rounds.mean << std::noshowpos << " units (+/- " << rounds.confidence95() << ")" << std::endl;
+    std::cout << indent << "EV per Unit Wagered: " << std::showpos << std::fixed << std::setprecision(2)
+              << (results.evPerUnitWagered() * 100.0) << std::noshowpos << "%" << std::endl;
+}
+
+}
+
+void SessionHistograms::record(const SessionOutcome& session) {
+    netResult.record(hundredthsOf(session.netUnits));
+    maxDrawdown.record(hundredthsOf(session.maxDrawdown));
+    losingStreak.record(static_cast<int64_t>(session.longestLosingStreak));
+    if (session.ruined) {
+        handsToRuin.record(static_cast<int64_t>(session.hands));
+    }
+}
+
+void SessionHistograms::merge(const SessionHistograms& other) {
+    netResult.merge(other.netResult);
+    maxDrawdown.merge(other.maxDrawdown);
+    handsToRuin.merge(other.handsToRuin);
+    losingStreak.merge(other.losingStreak);
+}
+
+void SessionHistograms::reset() {
+    netResult.reset();
+    maxDrawdown.reset();
+    handsToRuin.reset();
+    losingStreak.reset();
+}
+
+Stats::Stats() : registry(std::make_shared<PlayerRegistry>()), totalGamesPlayed(0) {}
+
+Stats::PlayerRecord& Stats::recordFor(PlayerId id) {
+    if (id < 0 || id >= registry->size()) {
+        throw std::out_of_range("Player id " + std::to_string(id) + " is not registered");
+    }
+    if (id >= static_cast<PlayerId>(players.size())) {
+        players.resize(id + 1);
+    }
+    // Listed like any other player even before a counted hand
+    PlayerRecord& record = players[id];
+    record.listed = true;
+    return record;
+}
+
+const Stats::PlayerRecord* Stats::findRecord(const std::string& playerName) const {
+    PlayerId id = registry->find(playerName);
+    if (id == no_player || id >= static_cast<PlayerId>(players.size()) || !players[id].listed) {
+        return nullptr;
+    }
+    return &players[id];
+}
+
+void Stats::usePlayerRegistry(std::shared_ptr<PlayerRegistry> playerRegistry) {
+    if (!playerRegistry) {
+        throw std::invalid_argument("Stats needs a player registry");
+    }
+    std::vector<PlayerRecord> recorded;
+    recorded.swap(players);
+    std::shared_ptr<PlayerRegistry> previous = registry;
+    registry = std::move(playerRegistry);
+
+    for (PlayerId id = 0; id < static_cast<PlayerId>(recorded.size()); ++id) {
+        if (recorded[id].listed) {
+            recordFor(registry->intern(previous->getName(id))) = recorded[id];
+        }
+    }
+}
 
 void Stats::updatePlayerStats(const std::string& playerName, GameResult result) {
+    updatePlayerStats(registry->intern(playerName), result);
+}
+
+void Stats::updatePlayerStats(PlayerId id, GameResult result) {
+    PlayerRecord& record = recordFor(id);
+
     switch (result) {
         case GameResult::WIN:
-            playerWins[playerName]++;
+            record.wins++;
             break;
         case GameResult::LOSS:
-            playerLosses[playerName]++;
+            record.losses++;
             break;
         case GameResult::PUSH:
-            playerPushes[playerName]++;
+            record.pushes++;
             break;
         case GameResult::BLACKJACK:
-            playerBlackjacks[playerName]++;
-            playerWins[playerName]++;  // Blackjack also counts as a win
+            record.blackjacks++;
+            record.wins++;  // Blackjack also counts as a win
+            break;
+        case GameResult::SURRENDER:
+            record.surrenders++;
             break;
     }
 }
 
+void Stats::recordRound(const std::string& playerName, double unitsWon, double unitsWagered) {
+    recordRound(registry->intern(playerName), unitsWon, unitsWagered);
+}
+
+void Stats::recordRound(const std::string& playerName, double unitsWon, double unitsWagered, double trueCount) {
+    recordRound(registry->intern(playerName), unitsWon, unitsWagered, trueCount);
+}
+
+void Stats::recordRound(PlayerId id, double unitsWon, double unitsWagered) {
+    recordFor(id).results.add(unitsWon, unitsWagered);
+}
+
+void Stats::recordRound(PlayerId id, double unitsWon, double unitsWagered, double trueCount) {
+    recordFor(id).results.add(unitsWon, unitsWagered, trueCount);
+}
+
+void Stats::recordSession(const SessionOutcome& session) {
+    sessions.record(session);
+}
+
+void Stats::merge(const Stats& other) {
+    for (PlayerId otherId = 0; otherId < static_cast<PlayerId>(other.players.size()); ++otherId) {
+        const PlayerRecord& theirs = other.players[otherId];
+        if (!theirs.listed) continue;
+
+        // Copies sharing a registry agree on IDs; otherwise match by name
+        PlayerId id = (other.registry == registry) ? otherId
+                                                   : registry->intern(other.registry->getName(otherId));
+        PlayerRecord& mine = recordFor(id);
+        mine.wins += theirs.wins;
+        mine.losses += theirs.losses;
+        mine.pushes += theirs.pushes;
+        mine.blackjacks += theirs.blackjacks;
+        mine.surrenders += theirs.surrenders;
+        mine.results.merge(theirs.results);
+    }
+    totalGamesPlayed += other.totalGamesPlayed;
+    sessions.merge(other.sessions);
+}
+
 void Stats::incrementGamesPlayed() {
     totalGamesPlayed++;
 }
@@ -41,28 +176,24 @@ return;
 std::cout << "Total Games Played: " << totalGamesPlayed << std::endl;
 std::cout << "======================================" << std::endl;
 
+std::vector<std::string> names = getAllPlayerNames();
+
 // Display stats for each player who has played
-for (const auto& pair : playerWins) {
-const std::string& name = pair.first;
+for (const std::string& name : names) {
 displayPlayerStats(name);
 }
 
 // Overall session statistics
-int totalWins = 0, totalLosses = 0, totalPushes = 0, totalBlackjacks = 0;
-for (const auto& pair : playerWins) {
-totalWins += pair.second;
-}
-for (const auto& pair : playerLosses) {
-totalLosses += pair.second;
-}
-for (const auto& pair : playerPushes) {
-totalPushes += pair.second;
-}
-for (const auto& pair : playerBlackjacks) {
-totalBlackjacks += pair.second;
+uint64_t totalWins = 0, totalLosses = 0, totalPushes = 0, totalBlackjacks = 0, totalSurrenders = 0;
+for (const PlayerRecord& record : players) {
+totalWins += record.wins;
+totalLosses += record.losses;
+totalPushes += record.pushes;
+totalBlackjacks += record.blackjacks;
+totalSurrenders += record.surrenders;
 }
 
-int totalHands = totalWins + totalLosses + totalPushes;
+uint64_t totalHands = totalWins + totalLosses + totalPushes + totalSurrenders;
 
 std::cout << "\nSESSION TOTALS:" << std::endl;
 std::cout << "  Total Hands Played: " << totalHands << std::endl;
@@ -70,8 +201,27 @@ std::cout << "  Total Wins: " << totalWins << std::endl;
 std::cout << "  Total Losses: " << totalLosses << std::endl;
 std::cout << "  Total Pushes: " << totalPushes << std::endl;
 std::cout << "  Total Blackjacks: " << totalBlackjacks << std::endl;
+std::cout << "  Total Surrenders: " << totalSurrenders << std::endl;
+
+ResultAccumulator session = getSessionResults();
+if (session.getRounds().count > 0) {
+printExpectedValue(session, "  ");
 
-if (totalHands > 0) {
+// Only rounds dealt with counting on land in a bucket
+bool hasCountData = false;
+for (int tc = ResultAccumulator::min_true_count; tc <= ResultAccumulator::max_true_count; ++tc) {
+const RunningStats& bucket = session.getTrueCountBucket(tc);
+if (bucket.count == 0) continue;
+if (!hasCountData) {
+std::cout << "\nEV BY TRUE COUNT:" << std::endl;
+hasCountData = true;
+}
+std::string label = tc == ResultAccumulator::min_true_count ? "<=" : (tc == ResultAccumulator::max_true_count ? ">=" : "  ");
+std::cout << "  TC " << label << std::showpos << std::setw(3) << tc << std::noshowpos << ": "
+<< std::setw(6) << bucket.count << " rounds, " << std::showpos << std::fixed << std::setprecision(4)
+<< bucket.mean << std::noshowpos << " units (+/- " << bucket.confidence95() << ")" << std::endl;
+}
+} else if (totalHands > 0) {
 double overallWinRate = (static_cast<double>(totalWins) / totalHands) * 100.0;
 std::cout << "  Overall Win Rate: " << std::fixed << std::setprecision(1) 
 << overallWinRate << "%" << std::endl;
@@ -89,8 +239,7 @@ std::cout << "Final Betting Advice: " << countingSystem->getBettingAdvice() << s
 
 // Display counting accuracy for each player
 std::cout << "\nCOUNTING ACCURACY:" << std::endl;
-for (const auto& pair : playerWins) {
-const std::string& playerName = pair.first;
+for (const std::string& playerName : names) {
 double accuracy = countingSystem->getCountingAccuracy(playerName);
 if (accuracy > 0) {
 std::cout << "  " << playerName << ": " << std::fixed << std::setprecision(1) 
@@ -109,8 +258,7 @@ if (basicStrategy) {
 std::cout << "\n======== BASIC STRATEGY ANALYSIS ========" << std::endl;
 
 bool hasStrategyData = false;
-for (const auto& pair : playerWins) {
-const std::string& playerName = pair.first;
+for (const std::string& playerName : names) {
 double accuracy = basicStrategy->getAccuracyRate(playerName);
 if (accuracy > 0) {
 hasStrategyData = true;
@@ -156,19 +304,18 @@ void Stats::displayQuickStats() const {
     std::cout << "Games Played: " << totalGamesPlayed << std::endl;
     
     // Quick summary of all players
-    int totalWins = 0, totalLosses = 0, totalPushes = 0;
-    for (const auto& pair : playerWins) {
-        totalWins += pair.second;
-    }
-    for (const auto& pair : playerLosses) {
-        totalLosses += pair.second;
-    }
-    for (const auto& pair : playerPushes) {
-        totalPushes += pair.second;
+    uint64_t totalWins = 0, totalLosses = 0, totalPushes = 0;
+    for (const PlayerRecord& record : players) {
+        totalWins += record.wins;
+        totalLosses += record.losses;
+        totalPushes += record.pushes;
     }
     
-    int totalHands = totalWins + totalLosses + totalPushes;
-    if (totalHands > 0) {
+    uint64_t totalHands = totalWins + totalLosses + totalPushes;
+    ResultAccumulator session = getSessionResults();
+    if (session.getRounds().count > 0) {
+        printExpectedValue(session, "");
+    } else if (totalHands > 0) {
         double winRate = (static_cast<double>(totalWins) / totalHands) * 100.0;
         std::cout << "Overall Win Rate: " << std::fixed << std::setprecision(1) 
                   << winRate << "%" << std::endl;
@@ -177,11 +324,9 @@ void Stats::displayQuickStats() const {
 }
 
 void Stats::resetStats() {
-    playerWins.clear();
-    playerLosses.clear();
-    playerPushes.clear();
-    playerBlackjacks.clear();
+    players.clear();
     totalGamesPlayed = 0;
+    sessions.reset();
     std::cout << "Game statistics have been reset!" << std::endl;
 }
 
@@ -191,11 +336,13 @@ void Stats::displayPlayerStats(const std::string& playerName) const {
         return;
     }
     
-    int wins = getPlayerWins(playerName);
-    int losses = getPlayerLosses(playerName);
-    int pushes = getPlayerPushes(playerName);
-    int blackjacks = getPlayerBlackjacks(playerName);
-    int totalHands = getPlayerTotalHands(playerName);
+    uint64_t wins = getPlayerWins(playerName);
+    uint64_t losses = getPlayerLosses(playerName);
+    uint64_t pushes = getPlayerPushes(playerName);
+    uint64_t blackjacks = getPlayerBlackjacks(playerName);
+    uint64_t surrenders = getPlayerSurrenders(playerName);
+    uint64_t totalHands = getPlayerTotalHands(playerName);
+    const ResultAccumulator* results = getPlayerResults(playerName);
     
     std::cout << "\n" << playerName << ":" << std::endl;
     std::cout << "  Wins: " << wins;
@@ -206,12 +353,17 @@ void Stats::displayPlayerStats(const std::string& playerName) const {
     std::cout << std::endl;
     std::cout << "  Losses: " << losses << std::endl;
     std::cout << "  Pushes: " << pushes << std::endl;
+    std::cout << "  Surrenders: " << surrenders << std::endl;
     std::cout << "  Total Hands: " << totalHands << std::endl;
     
     if (totalHands > 0) {
-        double winRate = getPlayerWinRate(playerName);
-        std::cout << "  Win Rate: " << std::fixed << std::setprecision(1) 
-                  << winRate << "%" << std::endl;
+        if (results && results->getRounds().count > 0) {
+            printExpectedValue(*results, "  ");
+        } else {
+            double winRate = getPlayerWinRate(playerName);
+            std::cout << "  Win Rate: " << std::fixed << std::setprecision(1) 
+                      << winRate << "%" << std::endl;
+        }
         
         if (blackjacks > 0) {
             double blackjackRate = (static_cast<double>(blackjacks) / totalHands) * 100.0;
@@ -222,51 +374,121 @@ void Stats::displayPlayerStats(const std::string& playerName) const {
     std::cout << "  ------------------" << std::endl;
 }
 
+void Stats::displaySessionPercentiles() const {
+    std::cout << "\n======== SESSION PERCENTILES ========" << std::endl;
+    if (sessions.netResult.getCount() == 0) {
+        std::cout << "No sessions recorded." << std::endl;
+        std::cout << "=====================================" << std::endl;
+        return;
+    }
+
+    std::cout << "Sessions: " << sessions.netResult.getCount() << " (" << sessions.handsToRuin.getCount()
+              << " ruined)" << std::endl;
+    std::cout << "Mean Net: " << std::fixed << std::setprecision(2)
+              << sessions.netResult.getMean() / SessionHistograms::hundredths_per_unit << " units, Mean Drawdown: "
+              << sessions.maxDrawdown.getMean() / SessionHistograms::hundredths_per_unit << " units" << std::endl;
+    std::cout << "  Pctl     Net Units  Max Drawdown  Hands to Ruin  Losing Streak" << std::endl;
+    for (double percentile : session_percentiles) {
+        if (percentile == 100.0) {
+            std::cout << "   max";
+        } else {
+            std::cout << std::setw(5) << std::setprecision(percentile == std::floor(percentile) ? 0 : 1)
+                      << percentile << "%";
+        }
+        std::cout << std::setprecision(2)
+                  << std::setw(14) << unitsOf(sessions.netResult.valueAtPercentile(percentile))
+                  << std::setw(14) << unitsOf(sessions.maxDrawdown.valueAtPercentile(percentile));
+        if (sessions.handsToRuin.getCount() > 0) {
+            std::cout << std::setw(15) << sessions.handsToRuin.valueAtPercentile(percentile);
+        } else {
+            std::cout << std::setw(15) << "-";
+        }
+        std::cout << std::setw(15) << sessions.losingStreak.valueAtPercentile(percentile) << std::endl;
+    }
+    std::cout << "=====================================" << std::endl;
+}
+
+void Stats::writeSessionPercentiles(std::ostream& out) const {
+    out << "percentile,net_units,max_drawdown_units,hands_to_ruin,longest_losing_streak" << std::endl;
+    if (sessions.netResult.getCount() == 0) return;
+
+    for (double percentile : session_percentiles) {
+        out << percentile << ","
+            << unitsOf(sessions.netResult.valueAtPercentile(percentile)) << ","
+            << unitsOf(sessions.maxDrawdown.valueAtPercentile(percentile)) << ",";
+        if (sessions.handsToRuin.getCount() > 0) {
+            out << sessions.handsToRuin.valueAtPercentile(percentile);
+        }
+        out << "," << sessions.losingStreak.valueAtPercentile(percentile) << std::endl;
+    }
+}
+
 // Getter methods
-int Stats::getTotalGamesPlayed() const {
+uint64_t Stats::getTotalGamesPlayed() const {
     return totalGamesPlayed;
 }
 
-int Stats::getPlayerWins(const std::string& playerName) const {
-    auto it = playerWins.find(playerName);
-    return (it != playerWins.end()) ? it->second : 0;
+uint64_t Stats::getPlayerWins(const std::string& playerName) const {
+    const PlayerRecord* record = findRecord(playerName);
+    return record ? record->wins : 0;
+}
+
+uint64_t Stats::getPlayerLosses(const std::string& playerName) const {
+    const PlayerRecord* record = findRecord(playerName);
+    return record ? record->losses : 0;
+}
+
+uint64_t Stats::getPlayerPushes(const std::string& playerName) const {
+    const PlayerRecord* record = findRecord(playerName);
+    return record ? record->pushes : 0;
 }
 
-int Stats::getPlayerLosses(const std::string& playerName) const {
-    auto it = playerLosses.find(playerName);
-    return (it != playerLosses.end()) ? it->second : 0;
+uint64_t Stats::getPlayerBlackjacks(const std::string& playerName) const {
+    const PlayerRecord* record = findRecord(playerName);
+    return record ? record->blackjacks : 0;
 }
 
-int Stats::getPlayerPushes(const std::string& playerName) const {
-    auto it = playerPushes.find(playerName);
-    return (it != playerPushes.end()) ? it->second : 0;
+uint64_t Stats::getPlayerSurrenders(const std::string& playerName) const {
+    const PlayerRecord* record = findRecord(playerName);
+    return record ? record->surrenders : 0;
 }
 
-int Stats::getPlayerBlackjacks(const std::string& playerName) const {
-    auto it = playerBlackjacks.find(playerName);
-    return (it != playerBlackjacks.end()) ? it->second : 0;
+const ResultAccumulator* Stats::getPlayerResults(const std::string& playerName) const {
+    const PlayerRecord* record = findRecord(playerName);
+    return (record && record->results.getRounds().count > 0) ? &record->results : nullptr;
+}
+
+ResultAccumulator Stats::getSessionResults() const {
+    ResultAccumulator session;
+    for (const PlayerRecord& record : players) {
+        session.merge(record.results);
+    }
+    return session;
 }
 
 double Stats::getPlayerWinRate(const std::string& playerName) const {
-    int totalHands = getPlayerTotalHands(playerName);
+    uint64_t totalHands = getPlayerTotalHands(playerName);
     if (totalHands == 0) return 0.0;
     
-    int wins = getPlayerWins(playerName);
+    uint64_t wins = getPlayerWins(playerName);
     return (static_cast<double>(wins) / totalHands) * 100.0;
 }
 
 std::vector<std::string> Stats::getAllPlayerNames() const {
     std::vector<std::string> names;
-    for (const auto& pair : playerWins) {
-        names.push_back(pair.first);
+    for (PlayerId id = 0; id < static_cast<PlayerId>(players.size()); ++id) {
+        if (players[id].listed) {
+            names.push_back(registry->getName(id));
+        }
     }
     return names;
 }
 
 bool Stats::hasPlayerData(const std::string& playerName) const {
-    return playerWins.find(playerName) != playerWins.end();
+    return findRecord(playerName) != nullptr;
 }
 
-int Stats::getPlayerTotalHands(const std::string& playerName) const {
-    return getPlayerWins(playerName) + getPlayerLosses(playerName) + getPlayerPushes(playerName);
+uint64_t Stats::getPlayerTotalHands(const std::string& playerName) const {
+    return getPlayerWins(playerName) + getPlayerLosses(playerName) + getPlayerPushes(playerName) +
+           getPlayerSurrenders(playerName);
 }
\ No newline at end of file
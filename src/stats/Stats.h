@@ -1,11 +1,15 @@
 #ifndef STATS_H
 #define STATS_H
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
-#include <map>
+#include <memory>
 #include <string>
 
+#include "LogHistogram.h"
+#include "PlayerRegistry.h"
+#include "RunningStats.h"
 #include "counting.h"
 #include "basicStrag.h"
 
@@ -17,43 +21,116 @@ enum class GameResult {
     WIN,
     LOSS,
     PUSH,
-    BLACKJACK
+    BLACKJACK,
+    SURRENDER
+};
+
+// One whole session at the table, e.g. a bankroll trial
+struct SessionOutcome {
+    double netUnits;
+    double maxDrawdown;             // units, deepest fall below the session's high point
+    uint64_t hands;
+    uint64_t longestLosingStreak;   // most hands lost in a row
+    bool ruined;                    // ended early for want of a minimum bet
+
+    SessionOutcome() : netUnits(0.0), maxDrawdown(0.0), hands(0), longestLosingStreak(0), ruined(false) {}
+};
+
+// How session outcomes are spread. Units are counted in hundredths so the
+// integer buckets still tell fractional Kelly bets apart.
+struct SessionHistograms {
+    static constexpr int hundredths_per_unit = 100;
+
+    LogHistogram netResult;
+    LogHistogram maxDrawdown;
+    LogHistogram handsToRuin;   // ruined sessions only
+    LogHistogram losingStreak;
+
+    void record(const SessionOutcome& session);
+    void merge(const SessionHistograms& other);
+    void reset();
 };
 
 class Stats {
 private:
-    std::map<std::string, int> playerWins;
-    std::map<std::string, int> playerLosses;
-    std::map<std::string, int> playerPushes;
-    std::map<std::string, int> playerBlackjacks;
-    int totalGamesPlayed;
+    // One player's tallies, kept at their PlayerId
+    struct PlayerRecord {
+        bool listed;    // anything recorded since the last reset
+        uint64_t wins;
+        uint64_t losses;
+        uint64_t pushes;
+        uint64_t blackjacks;
+        uint64_t surrenders;
+        ResultAccumulator results;
+
+        PlayerRecord() : listed(false), wins(0), losses(0), pushes(0), blackjacks(0), surrenders(0) {}
+    };
+
+    std::shared_ptr<PlayerRegistry> registry;
+    std::vector<PlayerRecord> players;     // by PlayerId
+    uint64_t totalGamesPlayed;
+    SessionHistograms sessions;
+
+    PlayerRecord& recordFor(PlayerId id);
+    const PlayerRecord* findRecord(const std::string& playerName) const;   // nullptr if not listed
 
 public:
     Stats();
     
-    // Core functionality
+    // Player names are interned here; the table shares its registry so
+    // the IDs from GameEngine::addPlayer index these arrays directly.
+    // Players already recorded keep their numbers under the new IDs.
+    void usePlayerRegistry(std::shared_ptr<PlayerRegistry> playerRegistry);
+    PlayerRegistry& getPlayerRegistry() const { return *registry; }
+
+    // Core functionality. The PlayerId overloads skip the name lookup and
+    // throw std::out_of_range for an ID the registry never handed out.
     void updatePlayerStats(const std::string& playerName, GameResult result);
+    void updatePlayerStats(PlayerId id, GameResult result);
     void incrementGamesPlayed();
+
+    // Money results of one round for a seat: net units won (1.5 for a 3:2
+    // blackjack, -0.5 for a surrender, -2 for a lost double, all split
+    // hands together) and the units put at risk. Pass the true count the
+    // round was dealt at to fill the per-count buckets.
+    void recordRound(const std::string& playerName, double unitsWon, double unitsWagered);
+    void recordRound(const std::string& playerName, double unitsWon, double unitsWagered, double trueCount);
+    void recordRound(PlayerId id, double unitsWon, double unitsWagered);
+    void recordRound(PlayerId id, double unitsWon, double unitsWagered, double trueCount);
+
+    // A finished session, for the percentile tables below
+    void recordSession(const SessionOutcome& session);
+
+    // Adds another Stats' counts and results, e.g. one kept per thread
+    void merge(const Stats& other);
     
     // Display methods
     void displayFinalResults(const Counting* countingSystem = nullptr, 
         const BasicStrat* basicStrategy = nullptr) const;
     void displayQuickStats() const;
     void displayPlayerStats(const std::string& playerName) const;
+    // Net result, max drawdown, hands to ruin and longest losing streak at
+    // the 1st to 99.9th percentiles and the maximum; the write version is CSV
+    void displaySessionPercentiles() const;
+    void writeSessionPercentiles(std::ostream& out) const;
     void resetStats();
     
     // Getter methods
-    int getTotalGamesPlayed() const;
-    int getPlayerWins(const std::string& playerName) const;
-    int getPlayerLosses(const std::string& playerName) const;
-    int getPlayerPushes(const std::string& playerName) const;
-    int getPlayerBlackjacks(const std::string& playerName) const;
+    uint64_t getTotalGamesPlayed() const;
+    uint64_t getPlayerWins(const std::string& playerName) const;
+    uint64_t getPlayerLosses(const std::string& playerName) const;
+    uint64_t getPlayerPushes(const std::string& playerName) const;
+    uint64_t getPlayerBlackjacks(const std::string& playerName) const;
+    uint64_t getPlayerSurrenders(const std::string& playerName) const;
+    const ResultAccumulator* getPlayerResults(const std::string& playerName) const;  // nullptr if none
+    ResultAccumulator getSessionResults() const;    // every player merged
+    const SessionHistograms& getSessionHistograms() const { return sessions; }
     double getPlayerWinRate(const std::string& playerName) const;
-    std::vector<std::string> getAllPlayerNames() const;
+    std::vector<std::string> getAllPlayerNames() const;    // in PlayerId order
     
     // Utility methods
     bool hasPlayerData(const std::string& playerName) const;
-    int getPlayerTotalHands(const std::string& playerName) const;
+    uint64_t getPlayerTotalHands(const std::string& playerName) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "DealerProbabilities.h"
+
+#include <stdexcept>
+
+size_t hashComposition(const ShoeComposition& counts, uint64_t salt) {
+    // Counts never exceed 255 for any realistic shoe, so fold them a byte
+    // at a time and finish with a splitmix64 mix
+    uint64_t h = salt;
+    for (int count : counts) {
+        h = h * 0x100000001b3ULL ^ static_cast<uint64_t>(count);
+    }
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return static_cast<size_t>(h);
+}
+
+size_t DealerProbabilities::CacheKeyHash::operator()(const CacheKey& key) const {
+    return hashComposition(key.counts, static_cast<uint64_t>(key.upcard) | (key.peeked ? 0x10 : 0));
+}
+
+DealerProbabilities::DealerProbabilities(const TableRules& tableRules, size_t cacheLimit)
+    : hitsSoft17(tableRules.dealerHitsSoft17), maxCacheEntries(cacheLimit) {}
+
+const DealerOutcome& DealerProbabilities::getOutcome(int upcard, const ShoeComposition& counts,
+                                                     bool peeked) {
+    CacheKey key{counts, upcard, peeked};
+
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    // A full cache is simply dropped; the working set of one shoe refills it quickly
+    if (cache.size() >= maxCacheEntries) {
+        cache.clear();
+    }
+
+    return cache.emplace(key, computeOutcome(upcard, counts, peeked)).first->second;
+}
+
+DealerOutcome DealerProbabilities::computeOutcome(int upcard, const ShoeComposition& counts,
+                                                  bool peeked) const {
+    if (upcard < 1 || upcard > 10) {
+        throw std::out_of_range("Dealer upcard must be between 1 and 10");
+    }
+
+    ShoeComposition remaining = counts;
+    int cardsLeft = 0;
+    for (int count : remaining) {
+        if (count < 0) {
+            throw std::out_of_range("Shoe composition cannot have negative counts");
+        }
+        cardsLeft += count;
+    }
+
+    DealerOutcome outcome;
+    drawDealer(remaining, cardsLeft, upcard, upcard == 1, 1, peeked, 1.0, outcome);
+    return outcome;
+}
+
+void DealerProbabilities::drawDealer(ShoeComposition& counts, int cardsLeft, int hardTotal,
+                                     bool hasAce, int cardCount, bool peeked,
+                                     double probability, DealerOutcome& outcome) const {
+    if (hardTotal > 21) {
+        outcome.probability[DealerOutcome::bust] += probability;
+        return;
+    }
+
+    bool soft = hasAce && hardTotal <= 11;
+    int total = soft ? hardTotal + 10 : hardTotal;
+
+    if (cardCount == 2 && total == 21) {
+        outcome.probability[DealerOutcome::blackjack] += probability;
+        return;
+    }
+
+    if (total > 17 || (total == 17 && !(soft && hitsSoft17))) {
+        outcome.probability[total - 17] += probability;
+        return;
+    }
+
+    // After a peek the hole card cannot complete a blackjack, so that rank
+    // is taken out of the draw and the rest renormalised
+    int excluded = -1;
+    int drawable = cardsLeft;
+    if (peeked && cardCount == 1) {
+        if (hardTotal == 1) excluded = PackedCard::rank_count - 1;
+        else if (hardTotal == 10) excluded = 0;
+        if (excluded >= 0) drawable -= counts[excluded];
+    }
+
+    // A shoe too thin to finish the hand contributes nothing
+    if (drawable <= 0) return;
+
+    for (int rank = 0; rank < PackedCard::rank_count; ++rank) {
+        if (rank == excluded || counts[rank] == 0) continue;
+
+        double drawProbability = probability * counts[rank] / drawable;
+        counts[rank]--;
+        drawDealer(counts, cardsLeft - 1, hardTotal + rank + 1, hasAce || rank == 0,
+                   cardCount + 1, peeked, drawProbability, outcome);
+        counts[rank]++;
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef DEALERPROBABILITIES_H
+#define DEALERPROBABILITIES_H
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include "card.h"
+#include "TableRules.h"
+
+// Cards left per rank, indexed like PackedCard::getRankIndex()
+// (0 = ace, 1-8 = twos to nines, 9 = ten-valued). Deck::getRankCounts()
+// returns exactly this.
+typedef std::array<int, PackedCard::rank_count> ShoeComposition;
+
+// Hash of a composition mixed with a few bits of caller state, for caches
+// keyed on what is left in the shoe
+size_t hashComposition(const ShoeComposition& counts, uint64_t salt);
+
+// Final dealer hand probabilities for one upcard and shoe composition
+struct DealerOutcome {
+    static const int bust = 5;
+    static const int blackjack = 6;
+    static const int outcomes = 7;
+
+    // [0]-[4] = stands on 17-21, then bust and blackjack
+    double probability[outcomes];
+
+    DealerOutcome() : probability() {}
+
+    double ofTotal(int total) const { return probability[total - 17]; }
+    double ofBust() const { return probability[bust]; }
+    double ofBlackjack() const { return probability[blackjack]; }
+};
+
+// Exact dealer outcome distributions. Every drawing sequence is walked
+// without replacement from the given composition. Results are cached per
+// (upcard, composition, peek) so a repeated query is a single hash lookup.
+class DealerProbabilities {
+private:
+    struct CacheKey {
+        ShoeComposition counts;
+        int upcard;
+        bool peeked;
+
+        bool operator==(const CacheKey& other) const {
+            return upcard == other.upcard && peeked == other.peeked && counts == other.counts;
+        }
+    };
+
+    struct CacheKeyHash {
+        size_t operator()(const CacheKey& key) const;
+    };
+
+    bool hitsSoft17;
+    size_t maxCacheEntries;
+    std::unordered_map<CacheKey, DealerOutcome, CacheKeyHash> cache;
+
+    void drawDealer(ShoeComposition& counts, int cardsLeft, int hardTotal, bool hasAce,
+                    int cardCount, bool peeked, double probability,
+                    DealerOutcome& outcome) const;
+
+public:
+    explicit DealerProbabilities(const TableRules& tableRules = TableRules(),
+                                 size_t cacheLimit = 1 << 16);
+
+    // upcard is 1 (ace) to 10. counts are the cards the dealer can still
+    // draw, so the upcard must already be removed. With peeked set, the
+    // dealer is known not to have blackjack (the hole card was checked) and
+    // the blackjack probability is zero.
+    const DealerOutcome& getOutcome(int upcard, const ShoeComposition& counts, bool peeked = false);
+
+    // Uncached version, for callers that want to manage memory themselves
+    DealerOutcome computeOutcome(int upcard, const ShoeComposition& counts, bool peeked = false) const;
+
+    void clearCache() { cache.clear(); }
+    size_t getCacheSize() const { return cache.size(); }
+};
+
+#endif
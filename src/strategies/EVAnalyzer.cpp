@@ -0,0 +1,247 @@
+#include "EVAnalyzer.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "player.h"
+
+double ActionEV::getEV(Action action) const {
+    switch (action) {
+        case Action::HIT: return hit;
+        case Action::STAND: return stand;
+        case Action::DOUBLE: return canDouble ? doubleDown : hit;
+        case Action::SPLIT: return canSplit ? split : hit;
+        case Action::SURRENDER: return canSurrender ? surrender : stand;
+        default: return stand;
+    }
+}
+
+Action ActionEV::getBestAction() const {
+    Action best = Action::STAND;
+    double bestEV = stand;
+
+    if (hit > bestEV) { best = Action::HIT; bestEV = hit; }
+    if (canDouble && doubleDown > bestEV) { best = Action::DOUBLE; bestEV = doubleDown; }
+    if (canSplit && split > bestEV) { best = Action::SPLIT; bestEV = split; }
+    if (canSurrender && surrender > bestEV) { best = Action::SURRENDER; }
+
+    return best;
+}
+
+EVAnalyzer::EVAnalyzer(const TableRules& tableRules, size_t cacheLimit)
+    : rules(tableRules), dealerProbabilities(tableRules), maxCacheEntries(cacheLimit) {}
+
+ShoeComposition EVAnalyzer::fullShoe(int numDecks) {
+    ShoeComposition counts;
+    for (int rank = 0; rank < PackedCard::rank_count - 1; ++rank) {
+        counts[rank] = 4 * numDecks;
+    }
+    counts[PackedCard::rank_count - 1] = 16 * numDecks;
+    return counts;
+}
+
+void EVAnalyzer::clearCache() {
+    playCache.clear();
+    resultCache.clear();
+    dealerProbabilities.clearCache();
+}
+
+ActionEV EVAnalyzer::analyze(const Player& hand, int dealerUp, const ShoeComposition& unseen,
+                             bool canDouble, bool canSurrender, bool canSplit, int handsInPlay) {
+    if (dealerUp < 1 || dealerUp > 10) {
+        throw std::out_of_range("Dealer upcard must be between 1 and 10");
+    }
+
+    int hardTotal = 0;
+    bool hasAce = false;
+    for (size_t i = 0; i < hand.getCardCount(); ++i) {
+        int value = std::min(hand.getCard(i).getValue(), 10);
+        hardTotal += value;
+        if (value == 1) hasAce = true;
+    }
+
+    bool twoCards = hand.getCardCount() == 2;
+    int pairValue = 0;
+    if (twoCards) {
+        int value1 = std::min(hand.getCard(0).getValue(), 10);
+        int value2 = std::min(hand.getCard(1).getValue(), 10);
+        if (value1 == value2) pairValue = value1;
+    }
+
+    ActionEV result;
+    result.canDouble = canDouble && twoCards;
+    result.canSurrender = canSurrender && twoCards && handsInPlay == 1 && rules.lateSurrender;
+    result.canSplit = canSplit && pairValue > 0 && handsInPlay < rules.maxSplitHands;
+
+    if (hardTotal > 21) {
+        result.stand = result.hit = result.doubleDown = result.split = -1.0;
+        result.surrender = -0.5;
+        return result;
+    }
+
+    StateKey key{unseen, static_cast<uint32_t>(hardTotal) |
+                         (hasAce ? 1u << 5 : 0) |
+                         (static_cast<uint32_t>(pairValue) << 6) |
+                         (static_cast<uint32_t>(dealerUp) << 10) |
+                         (result.canDouble ? 1u << 14 : 0) |
+                         (result.canSurrender ? 1u << 15 : 0) |
+                         (result.canSplit ? 1u << 16 : 0) |
+                         (static_cast<uint32_t>(std::min(handsInPlay, 255)) << 17)};
+
+    auto it = resultCache.find(key);
+    if (it != resultCache.end()) {
+        return it->second;
+    }
+
+    ShoeComposition counts = unseen;
+    int total = (hasAce && hardTotal <= 11) ? hardTotal + 10 : hardTotal;
+
+    result.stand = standEV(total, dealerUp, counts);
+    result.hit = hitEV(hardTotal, hasAce, dealerUp, counts);
+    result.surrender = -0.5;
+    if (result.canDouble) {
+        result.doubleDown = doubleEV(hardTotal, hasAce, dealerUp, counts);
+    }
+    if (result.canSplit) {
+        result.split = splitPairEV(pairValue, rules.maxSplitHands - handsInPlay - 1, dealerUp, counts);
+    }
+
+    if (resultCache.size() >= maxCacheEntries) {
+        resultCache.clear();
+    }
+    resultCache.emplace(key, result);
+
+    return result;
+}
+
+double EVAnalyzer::standEV(int total, int dealerUp, const ShoeComposition& counts) {
+    if (total > 21) return -1.0;
+
+    const DealerOutcome& dealer = dealerProbabilities.getOutcome(dealerUp, counts, true);
+
+    double ev = dealer.ofBust();
+    for (int dealerTotal = 17; dealerTotal <= 21; ++dealerTotal) {
+        if (total > dealerTotal) ev += dealer.ofTotal(dealerTotal);
+        else if (total < dealerTotal) ev -= dealer.ofTotal(dealerTotal);
+    }
+    return ev;
+}
+
+double EVAnalyzer::hitEV(int hardTotal, bool hasAce, int dealerUp, ShoeComposition& counts) {
+    int cardsLeft = 0;
+    for (int count : counts) cardsLeft += count;
+    if (cardsLeft == 0) return -1.0;
+
+    double ev = 0.0;
+    for (int rank = 0; rank < PackedCard::rank_count; ++rank) {
+        if (counts[rank] == 0) continue;
+
+        double probability = static_cast<double>(counts[rank]) / cardsLeft;
+        int newHardTotal = hardTotal + rank + 1;
+
+        if (newHardTotal > 21) {
+            ev -= probability;
+            continue;
+        }
+
+        counts[rank]--;
+        ev += probability * bestPlayEV(newHardTotal, hasAce || rank == 0, dealerUp, counts);
+        counts[rank]++;
+    }
+    return ev;
+}
+
+double EVAnalyzer::bestPlayEV(int hardTotal, bool hasAce, int dealerUp, ShoeComposition& counts) {
+    StateKey key{counts, static_cast<uint32_t>(hardTotal) | (hasAce ? 1u << 5 : 0) |
+                         (static_cast<uint32_t>(dealerUp) << 6)};
+
+    auto it = playCache.find(key);
+    if (it != playCache.end()) {
+        return it->second;
+    }
+
+    int total = (hasAce && hardTotal <= 11) ? hardTotal + 10 : hardTotal;
+    double ev = standEV(total, dealerUp, counts);
+    if (total < 21) {
+        ev = std::max(ev, hitEV(hardTotal, hasAce, dealerUp, counts));
+    }
+
+    if (playCache.size() >= maxCacheEntries) {
+        playCache.clear();
+    }
+    playCache.emplace(key, ev);
+
+    return ev;
+}
+
+double EVAnalyzer::doubleEV(int hardTotal, bool hasAce, int dealerUp, ShoeComposition& counts) {
+    int cardsLeft = 0;
+    for (int count : counts) cardsLeft += count;
+    if (cardsLeft == 0) return -2.0;
+
+    double ev = 0.0;
+    for (int rank = 0; rank < PackedCard::rank_count; ++rank) {
+        if (counts[rank] == 0) continue;
+
+        double probability = static_cast<double>(counts[rank]) / cardsLeft;
+        int newHardTotal = hardTotal + rank + 1;
+        bool newHasAce = hasAce || rank == 0;
+        int total = (newHasAce && newHardTotal <= 11) ? newHardTotal + 10 : newHardTotal;
+
+        counts[rank]--;
+        ev += probability * standEV(total, dealerUp, counts);
+        counts[rank]++;
+    }
+    return 2.0 * ev;
+}
+
+double EVAnalyzer::splitPairEV(int pairValue, int spareSplits, int dealerUp, ShoeComposition& counts) {
+    // The first hand played gets the odd resplit
+    int firstSpare = (spareSplits + 1) / 2;
+    int secondSpare = spareSplits - firstSpare;
+
+    double first = splitHandEV(pairValue, firstSpare, dealerUp, counts);
+    if (secondSpare == firstSpare) return 2.0 * first;
+    return first + splitHandEV(pairValue, secondSpare, dealerUp, counts);
+}
+
+double EVAnalyzer::splitHandEV(int pairValue, int spareSplits, int dealerUp, ShoeComposition& counts) {
+    int cardsLeft = 0;
+    for (int count : counts) cardsLeft += count;
+    if (cardsLeft == 0) return -1.0;
+
+    bool splittingAces = pairValue == 1;
+    bool canResplit = spareSplits > 0 && (!splittingAces || rules.resplitAces);
+
+    double ev = 0.0;
+    for (int rank = 0; rank < PackedCard::rank_count; ++rank) {
+        if (counts[rank] == 0) continue;
+
+        double probability = static_cast<double>(counts[rank]) / cardsLeft;
+        int hardTotal = pairValue + rank + 1;
+        bool hasAce = splittingAces || rank == 0;
+
+        counts[rank]--;
+
+        double value;
+        if (splittingAces) {
+            // One card each, and a split ace with a ten is 21, not blackjack
+            int total = (hasAce && hardTotal <= 11) ? hardTotal + 10 : hardTotal;
+            value = standEV(total, dealerUp, counts);
+        } else {
+            value = bestPlayEV(hardTotal, hasAce, dealerUp, counts);
+            if (rules.doubleAfterSplit) {
+                value = std::max(value, doubleEV(hardTotal, hasAce, dealerUp, counts));
+            }
+        }
+
+        // Drawing another pair card: resplitting turns this hand into two
+        if (canResplit && rank + 1 == pairValue) {
+            value = std::max(value, splitPairEV(pairValue, spareSplits - 1, dealerUp, counts));
+        }
+
+        counts[rank]++;
+        ev += probability * value;
+    }
+    return ev;
+}
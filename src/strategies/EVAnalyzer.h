@@ -0,0 +1,95 @@
+#ifndef EVANALYZER_H
+#define EVANALYZER_H
+
+#include <cstdint>
+#include <unordered_map>
+#include "DealerProbabilities.h"
+#include "StrategyTables.h"
+#include "TableRules.h"
+
+class Player;
+
+// Expected value of every action for one decision, in units of the
+// original bet. EVs are conditional on the dealer not having blackjack,
+// since the dealer peeks before anyone acts.
+struct ActionEV {
+    double stand;
+    double hit;
+    double doubleDown;
+    double split;
+    double surrender;
+    bool canDouble;
+    bool canSplit;
+    bool canSurrender;
+
+    ActionEV() : stand(0.0), hit(0.0), doubleDown(0.0), split(0.0), surrender(0.0),
+                 canDouble(false), canSplit(false), canSurrender(false) {}
+
+    // EV of taking an action. An action that is not allowed is scored as
+    // what the table does instead: a double or split becomes a hit, and a
+    // surrender becomes a stand.
+    double getEV(Action action) const;
+    Action getBestAction() const;
+    double getBestEV() const { return getEV(getBestAction()); }
+};
+
+// Combinatorial EV for stand, hit, double, split and surrender against a
+// known shoe composition, with every player and dealer card drawn without
+// replacement. Hit EVs assume the player plays each later card the best
+// way (hit or stand), which makes them exact for one hand.
+//
+// Split EV is an approximation. Each split hand is valued on its own from
+// the composition left after the split, and it follows maxSplitHands, DAS
+// and the ace rules in TableRules. The two hands of a split share the
+// resplits still allowed, so a seat never passes maxSplitHands. Split aces
+// get one card each.
+class EVAnalyzer {
+private:
+    struct StateKey {
+        ShoeComposition counts;
+        uint32_t state;
+
+        bool operator==(const StateKey& other) const {
+            return state == other.state && counts == other.counts;
+        }
+    };
+
+    struct StateKeyHash {
+        size_t operator()(const StateKey& key) const { return hashComposition(key.counts, key.state); }
+    };
+
+    TableRules rules;
+    DealerProbabilities dealerProbabilities;
+    size_t maxCacheEntries;
+
+    // Best of hit/stand per (composition, hand state); the bulk of the work
+    std::unordered_map<StateKey, double, StateKeyHash> playCache;
+    // Full answers per query, so a repeated question is one lookup
+    std::unordered_map<StateKey, ActionEV, StateKeyHash> resultCache;
+
+    double standEV(int total, int dealerUp, const ShoeComposition& counts);
+    double hitEV(int hardTotal, bool hasAce, int dealerUp, ShoeComposition& counts);
+    double bestPlayEV(int hardTotal, bool hasAce, int dealerUp, ShoeComposition& counts);
+    double doubleEV(int hardTotal, bool hasAce, int dealerUp, ShoeComposition& counts);
+    // spareSplits is how many more times the hand's pair may be split
+    double splitHandEV(int pairValue, int spareSplits, int dealerUp, ShoeComposition& counts);
+    double splitPairEV(int pairValue, int spareSplits, int dealerUp, ShoeComposition& counts);
+
+public:
+    explicit EVAnalyzer(const TableRules& tableRules = TableRules(), size_t cacheLimit = 1 << 18);
+
+    // dealerUp is 1 (ace) to 10. unseen holds every card the player cannot
+    // see, so the player's cards and the dealer upcard are already removed
+    // and the hole card is still included. handsInPlay counts the hands
+    // the seat already holds, for the maxSplitHands limit.
+    ActionEV analyze(const Player& hand, int dealerUp, const ShoeComposition& unseen,
+                     bool canDouble = true, bool canSurrender = true, bool canSplit = true,
+                     int handsInPlay = 1);
+
+    // A freshly shuffled shoe of numDecks decks
+    static ShoeComposition fullShoe(int numDecks);
+
+    void clearCache();
+};
+
+#endif
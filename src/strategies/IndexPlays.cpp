@@ -0,0 +1,245 @@
+#include "IndexPlays.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char index_file_magic[4] = {'B', 'J', 'I', 'X'};
+const uint32_t index_file_version = 1;
+
+// Same rule fields as a strategy table file
+struct IndexFileHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t numDecks;
+    int32_t maxSplitHands;
+    uint8_t dealerHitsSoft17;
+    uint8_t doubleAfterSplit;
+    uint8_t resplitAces;
+    uint8_t lateSurrender;
+    uint32_t systemCount;
+};
+
+// One stored entry; layer 0 is plays, 1 is surrender
+struct IndexFileEntry {
+    uint8_t layer;
+    uint8_t handType;
+    uint8_t value;
+    uint8_t dealerUp;
+    float index;
+    uint8_t atOrAbove;
+    uint8_t below;
+    uint8_t padding[2];
+};
+
+struct IndexFileSystem {
+    uint32_t system;
+    uint32_t entryCount;
+    float insuranceIndex;
+};
+
+IndexFileHeader makeHeader(const TableRules& rules) {
+    IndexFileHeader header;
+    std::memcpy(header.magic, index_file_magic, sizeof(header.magic));
+    header.version = index_file_version;
+    header.numDecks = rules.numDecks;
+    header.maxSplitHands = rules.maxSplitHands;
+    header.dealerHitsSoft17 = rules.dealerHitsSoft17;
+    header.doubleAfterSplit = rules.doubleAfterSplit;
+    header.resplitAces = rules.resplitAces;
+    header.lateSurrender = rules.lateSurrender;
+    header.systemCount = 0;
+    return header;
+}
+
+std::vector<IndexFileEntry> activeEntries(const IndexTable& table) {
+    std::vector<IndexFileEntry> entries;
+
+    for (int layer = 0; layer < 2; ++layer) {
+        const auto& cells = layer == 0 ? table.plays : table.surrender;
+        for (int type = 0; type < StrategyTable::hand_types; ++type) {
+            for (int value = 0; value < StrategyTable::values; ++value) {
+                for (int dealer = 1; dealer < StrategyTable::dealer_cards; ++dealer) {
+                    const IndexEntry& cell = cells[type][value][dealer];
+                    if (!cell.active) continue;
+
+                    IndexFileEntry entry = {};
+                    entry.layer = static_cast<uint8_t>(layer);
+                    entry.handType = static_cast<uint8_t>(type);
+                    entry.value = static_cast<uint8_t>(value);
+                    entry.dealerUp = static_cast<uint8_t>(dealer);
+                    entry.index = cell.index;
+                    entry.atOrAbove = static_cast<uint8_t>(cell.atOrAbove);
+                    entry.below = static_cast<uint8_t>(cell.below);
+                    entries.push_back(entry);
+                }
+            }
+        }
+    }
+    return entries;
+}
+
+std::string actionName(Action action) {
+    switch (action) {
+        case Action::HIT: return "Hit";
+        case Action::STAND: return "Stand";
+        case Action::DOUBLE: return "Double";
+        case Action::SPLIT: return "Split";
+        case Action::SURRENDER: return "Surrender";
+        default: return "Unknown";
+    }
+}
+
+std::string cellName(int type, int value, int dealerUp) {
+    auto card = [](int cardValue) {
+        return cardValue == 1 ? std::string("A") : (cardValue == 10 ? std::string("T") : std::to_string(cardValue));
+    };
+
+    std::string hand;
+    if (type == static_cast<int>(HandType::PAIR)) {
+        hand = card(value) + "," + card(value);
+    } else {
+        hand = (type == static_cast<int>(HandType::SOFT) ? "Soft " : "") + std::to_string(value);
+    }
+    return hand + " vs " + card(dealerUp);
+}
+
+std::string countName(float index) {
+    long whole = std::lround(index);
+    return (whole >= 0 ? "+" : "") + std::to_string(whole);
+}
+
+}
+
+void writeIndexTables(const std::string& path, const IndexTableSet& tables, const TableRules& rules) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot write index table: " + path);
+    }
+
+    IndexFileHeader header = makeHeader(rules);
+    for (int system = 0; system < index_table_systems; ++system) {
+        if (tables.present[system]) header.systemCount++;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (int system = 0; system < index_table_systems; ++system) {
+        if (!tables.present[system]) continue;
+
+        std::vector<IndexFileEntry> entries = activeEntries(tables.tables[system]);
+        IndexFileSystem section = {static_cast<uint32_t>(system), static_cast<uint32_t>(entries.size()),
+                                   tables.tables[system].insuranceIndex};
+        file.write(reinterpret_cast<const char*>(&section), sizeof(section));
+        file.write(reinterpret_cast<const char*>(entries.data()),
+                   static_cast<std::streamsize>(entries.size() * sizeof(IndexFileEntry)));
+    }
+
+    if (!file) {
+        throw std::runtime_error("Failed writing index table: " + path);
+    }
+}
+
+IndexTableSet readIndexTables(const std::string& path, const TableRules& rules) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open index table: " + path);
+    }
+
+    IndexFileHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || std::memcmp(header.magic, index_file_magic, sizeof(header.magic)) != 0 ||
+        header.version != index_file_version) {
+        throw std::runtime_error("Not an index table file: " + path);
+    }
+
+    IndexFileHeader expected = makeHeader(rules);
+    if (header.numDecks != expected.numDecks || header.maxSplitHands != expected.maxSplitHands ||
+        header.dealerHitsSoft17 != expected.dealerHitsSoft17 ||
+        header.doubleAfterSplit != expected.doubleAfterSplit ||
+        header.resplitAces != expected.resplitAces ||
+        header.lateSurrender != expected.lateSurrender) {
+        throw std::runtime_error("Index table " + path + " was generated for other rules than " +
+                                 rules.describe());
+    }
+    if (header.systemCount > static_cast<uint32_t>(index_table_systems)) {
+        throw std::runtime_error("Index table is damaged: " + path);
+    }
+
+    const uint32_t max_entries = 2 * StrategyTable::hand_types * StrategyTable::values *
+                                 StrategyTable::dealer_cards;
+    const uint8_t last_action = static_cast<uint8_t>(Action::SURRENDER);
+
+    IndexTableSet tables;
+    for (uint32_t s = 0; s < header.systemCount; ++s) {
+        IndexFileSystem section;
+        file.read(reinterpret_cast<char*>(&section), sizeof(section));
+        if (!file) {
+            throw std::runtime_error("Index table is truncated: " + path);
+        }
+        if (section.system >= static_cast<uint32_t>(index_table_systems) || section.entryCount > max_entries) {
+            throw std::runtime_error("Index table is damaged: " + path);
+        }
+
+        IndexTable table;
+        table.insuranceIndex = section.insuranceIndex;
+
+        for (uint32_t i = 0; i < section.entryCount; ++i) {
+            IndexFileEntry entry;
+            file.read(reinterpret_cast<char*>(&entry), sizeof(entry));
+            if (!file) {
+                throw std::runtime_error("Index table is truncated: " + path);
+            }
+
+            // Reject anything that does not name a real cell and actions
+            if (entry.layer > 1 || entry.handType >= StrategyTable::hand_types ||
+                entry.value >= StrategyTable::values || entry.dealerUp < 1 ||
+                entry.dealerUp >= StrategyTable::dealer_cards ||
+                entry.atOrAbove > last_action || entry.below > last_action) {
+                throw std::runtime_error("Index table is damaged: " + path);
+            }
+
+            HandType type = static_cast<HandType>(entry.handType);
+            if (entry.layer == 0) {
+                table.setPlay(type, entry.value, entry.dealerUp, entry.index,
+                              static_cast<Action>(entry.atOrAbove), static_cast<Action>(entry.below));
+            } else {
+                table.setSurrender(type, entry.value, entry.dealerUp, entry.index);
+            }
+        }
+
+        tables.present[section.system] = true;
+        tables.tables[section.system] = table;
+    }
+
+    return tables;
+}
+
+void printIndexTable(std::ostream& out, const IndexTable& table) {
+    out << "Insurance: take at TC " << countName(table.insuranceIndex) << " or more" << std::endl;
+
+    for (int type = 0; type < StrategyTable::hand_types; ++type) {
+        for (int value = StrategyTable::values - 1; value >= 0; --value) {
+            for (int dealer = 1; dealer < StrategyTable::dealer_cards; ++dealer) {
+                const IndexEntry& play = table.plays[type][value][dealer];
+                if (play.active) {
+                    out << cellName(type, value, dealer) << ": " << actionName(play.atOrAbove)
+                        << " at TC " << countName(play.index) << " or more, otherwise "
+                        << actionName(play.below) << std::endl;
+                }
+
+                const IndexEntry& surrender = table.surrender[type][value][dealer];
+                if (surrender.active) {
+                    out << cellName(type, value, dealer) << ": Surrender at TC "
+                        << countName(surrender.index) << " or more" << std::endl;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,136 @@
+#ifndef INDEXPLAYS_H
+#define INDEXPLAYS_H
+
+#include <iosfwd>
+#include <string>
+#include "StrategyTables.h"
+#include "TableRules.h"
+
+// A count-based change to one strategy cell. When active, the cell plays
+// `atOrAbove` once the true count reaches `index` and `below` under it.
+struct IndexEntry {
+    bool active;
+    float index;
+    Action atOrAbove;
+    Action below;
+
+    constexpr IndexEntry() : active(false), index(0.0f), atOrAbove(Action::HIT), below(Action::HIT) {}
+};
+
+// Playing deviations for one counting system, laid out like StrategyTable
+// so a lookup is one array access and one compare on the true count.
+// `plays` replaces the hit/stand/double/split decision of a cell.
+// `surrender` entries decide late surrender for their cell on the count
+// alone, overriding whatever the basic table says about surrendering.
+struct IndexTable {
+    IndexEntry plays[StrategyTable::hand_types][StrategyTable::values][StrategyTable::dealer_cards];
+    IndexEntry surrender[StrategyTable::hand_types][StrategyTable::values][StrategyTable::dealer_cards];
+    float insuranceIndex;   // take insurance at or above this true count
+
+    constexpr IndexTable() : plays(), surrender(), insuranceIndex(3.0f) {}
+
+    constexpr void setPlay(HandType type, int value, int dealerUp, float index,
+                           Action atOrAbove, Action below) {
+        IndexEntry& entry = plays[static_cast<int>(type)][value][dealerUp];
+        entry.active = true;
+        entry.index = index;
+        entry.atOrAbove = atOrAbove;
+        entry.below = below;
+    }
+
+    constexpr void setSurrender(HandType type, int value, int dealerUp, float index) {
+        IndexEntry& entry = surrender[static_cast<int>(type)][value][dealerUp];
+        entry.active = true;
+        entry.index = index;
+        entry.atOrAbove = Action::SURRENDER;
+        entry.below = Action::HIT;
+    }
+
+    bool takesInsurance(double trueCount) const { return trueCount >= insuranceIndex; }
+};
+
+// The Hi-Lo Illustrious 18 and Fab 4 surrenders for a multi-deck shoe
+constexpr IndexTable buildIllustrious18(bool dealerHitsSoft17) {
+    IndexTable table;
+    const Action H = Action::HIT, S = Action::STAND, D = Action::DOUBLE, P = Action::SPLIT;
+    const HandType HARD = HandType::HARD, PAIR = HandType::PAIR;
+
+    table.insuranceIndex = 3.0f;
+    table.setPlay(HARD, 16, 10, 0.0f, S, H);
+    table.setPlay(HARD, 15, 10, 4.0f, S, H);
+    table.setPlay(PAIR, 10, 5, 5.0f, P, S);
+    table.setPlay(PAIR, 10, 6, 4.0f, P, S);
+    table.setPlay(HARD, 10, 10, 4.0f, D, H);
+    table.setPlay(PAIR, 5, 10, 4.0f, D, H);
+    table.setPlay(HARD, 12, 3, 2.0f, S, H);
+    table.setPlay(HARD, 12, 2, 3.0f, S, H);
+    table.setPlay(HARD, 11, 1, dealerHitsSoft17 ? -1.0f : 1.0f, D, H);
+    table.setPlay(HARD, 9, 2, 1.0f, D, H);
+    table.setPlay(HARD, 10, 1, dealerHitsSoft17 ? 3.0f : 4.0f, D, H);
+    table.setPlay(PAIR, 5, 1, dealerHitsSoft17 ? 3.0f : 4.0f, D, H);
+    table.setPlay(HARD, 9, 7, 3.0f, D, H);
+    table.setPlay(HARD, 16, 9, 5.0f, S, H);
+    table.setPlay(HARD, 13, 2, -1.0f, S, H);
+    table.setPlay(HARD, 12, 4, 0.0f, S, H);
+    table.setPlay(HARD, 12, 5, -2.0f, S, H);
+    table.setPlay(HARD, 12, 6, -1.0f, S, H);
+    table.setPlay(HARD, 13, 3, -2.0f, S, H);
+
+    table.setSurrender(HARD, 14, 10, 3.0f);
+    table.setSurrender(HARD, 15, 10, 0.0f);
+    table.setSurrender(HARD, 15, 9, 2.0f);
+    table.setSurrender(HARD, 15, 1, dealerHitsSoft17 ? -1.0f : 1.0f);
+
+    return table;
+}
+
+// Moves every index to another count's scale, rounded to whole counts
+constexpr IndexTable scaleIndexTable(IndexTable table, float factor) {
+    auto scale = [factor](float index) {
+        float scaled = index * factor;
+        return static_cast<float>(static_cast<int>(scaled + (scaled < 0.0f ? -0.5f : 0.5f)));
+    };
+
+    for (int type = 0; type < StrategyTable::hand_types; ++type) {
+        for (int value = 0; value < StrategyTable::values; ++value) {
+            for (int dealer = 0; dealer < StrategyTable::dealer_cards; ++dealer) {
+                table.plays[type][value][dealer].index = scale(table.plays[type][value][dealer].index);
+                table.surrender[type][value][dealer].index = scale(table.surrender[type][value][dealer].index);
+            }
+        }
+    }
+    table.insuranceIndex = scale(table.insuranceIndex);
+    return table;
+}
+
+// Built-in indices per counting system, in CountingSystem order (Hi-Lo, KO,
+// Hi-Opt I, Omega II), then [dealerHitsSoft17]. Only Hi-Lo is the published
+// set; the others are Hi-Lo scaled by how far each system's tags spread
+// (the root of the summed squared tags per deck, relative to Hi-Lo).
+inline constexpr int index_table_systems = 4;
+inline constexpr IndexTable index_tables[index_table_systems][2] = {
+    {buildIllustrious18(false), buildIllustrious18(true)},
+    {scaleIndexTable(buildIllustrious18(false), 1.05f), scaleIndexTable(buildIllustrious18(true), 1.05f)},
+    {scaleIndexTable(buildIllustrious18(false), 0.89f), scaleIndexTable(buildIllustrious18(true), 0.89f)},
+    {scaleIndexTable(buildIllustrious18(false), 1.79f), scaleIndexTable(buildIllustrious18(true), 1.79f)}
+};
+
+// Index tables for some or all counting systems, as kept in an index file
+struct IndexTableSet {
+    bool present[index_table_systems];
+    IndexTable tables[index_table_systems];
+
+    IndexTableSet() : present() {}
+};
+
+// Binary index files, as written by the bjindex generator. Only active
+// entries are stored. Like strategy table files they record the rules
+// they were generated for; reading one for other rules, or a missing or
+// damaged file, throws std::runtime_error.
+void writeIndexTables(const std::string& path, const IndexTableSet& tables, const TableRules& rules);
+IndexTableSet readIndexTables(const std::string& path, const TableRules& rules);
+
+// Lists the active indices, one cell per line
+void printIndexTable(std::ostream& out, const IndexTable& table);
+
+#endif
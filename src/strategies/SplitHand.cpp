@@ -1,10 +1,13 @@
 #include <iostream>
-#include <cctype>
 #include "SplitHand.h"
 #include "deck.h"
+#include "counting.h"
+#include "Dealer.h"
+#include "PlayerActionHandler.h"
 
-SplitHand::SplitHand(std::vector<Player>& gamePlayers, Deck& gameDeck, int maxSplitsAllowed) 
-    : players(gamePlayers), deck(gameDeck), maxSplits(maxSplitsAllowed) {}
+SplitHand::SplitHand(std::vector<Player>& gamePlayers, Deck& gameDeck, const TableRules& rules) 
+    : players(gamePlayers), deck(gameDeck), counting(nullptr), listener(nullptr),
+      maxSplits(rules.maxSplitHands), doubleAfterSplit(rules.doubleAfterSplit), resplitAces(rules.resplitAces) {}
 
 bool SplitHand::canPlayerSplit(int playerIndex) {
     if(playerIndex < 0 || playerIndex >= static_cast<int>(players.size())) {
@@ -22,11 +25,13 @@ bool SplitHand::canPlayerSplit(int playerIndex) {
     int value1 = card1.getValue();
     int value2 = card2.getValue();
 
-    // Check if player already has maximum splits
+    // Check if player already has maximum splits; an unsplit seat holds one hand
+    size_t handsHeld = 1;
     if (playerSplitHands.find(playerIndex) != playerSplitHands.end()) {
-        if (playerSplitHands[playerIndex].size() >= static_cast<size_t>(maxSplits)) {
-            return false;
-        }
+        handsHeld = playerSplitHands[playerIndex].size();
+    }
+    if (handsHeld >= static_cast<size_t>(maxSplits)) {
+        return false;
     }
 
     if(value1 == value2) return true;
@@ -37,95 +42,129 @@ bool SplitHand::canPlayerSplit(int playerIndex) {
     return card1isFaceCard && card2isFaceCard;
 }
 
-void SplitHand::playSplitHands(int playerIndex) {
+void SplitHand::playSplitHands(int playerIndex, PlayerActionHandler& handler, const Dealer& dealer) {
     Player& player = players[playerIndex];
     auto& splitHands = playerSplitHands[playerIndex];
     
     for (size_t handIndex = 0; handIndex < splitHands.size(); ++handIndex) {
-        SplitHands& currentHand = splitHands[handIndex];
-        
         std::cout << "\n--- " << player.getName() << "'s Hand " << (handIndex + 1) << " ---" << std::endl;
         
         // Special case: Aces are split and get only one card each
-        if (currentHand.isAceSplit) {
+        if (splitHands[handIndex].isAceSplit) {
             displaySplitHand(playerIndex, handIndex);
-            if (currentHand.is21()) {
+            // With RSA a split ace that catches another ace may split again,
+            // and after a resplit this hand's new card is decided on in
+            // turn; any answer but split stands
+            while (canPlayerResplit(playerIndex, handIndex)) {
+                Action action = handler.decide(handAsPlayer(playerIndex, handIndex), dealer, false, true, false);
+                if (action != Action::SPLIT || !reSplit(playerIndex, handIndex)) {
+                    break;
+                }
+            }
+            if (splitHands[handIndex].is21()) {
                 std::cout << "21! (Note: Split hands cannot have 'blackjack')" << std::endl;
             }
             continue;  // No further action allowed on split aces
         }
         
-        playSingleSplitHand(playerIndex, handIndex);
+        playSingleSplitHand(playerIndex, handIndex, handler, dealer);
     }
 }
 
-void SplitHand::playSingleSplitHand(int playerIndex, int handIndex) {
+void SplitHand::playSingleSplitHand(int playerIndex, int handIndex, PlayerActionHandler& handler,
+                                    const Dealer& dealer) {
     auto& splitHands = playerSplitHands[playerIndex];
-    SplitHands& currentHand = splitHands[handIndex];
     
     displaySplitHand(playerIndex, handIndex);
     
     // Check for 21 (not blackjack on splits)
-    if (currentHand.is21()) {
+    if (splitHands[handIndex].is21()) {
         std::cout << "21 on hand " << (handIndex + 1) << "!" << std::endl;
         return;
     }
     
     bool handActive = true;
     
-    while (!currentHand.isBusted() && handActive && currentHand.isActive) {
-        // Determine available actions
-        bool canDouble = currentHand.canDouble();
+    // A resplit inserts into splitHands, so index it afresh every pass. It
+    // also leaves this hand with a fresh second card to decide on again.
+    while (handActive && !splitHands[handIndex].isBusted() && !splitHands[handIndex].is21() &&
+           splitHands[handIndex].isActive) {
+        bool canDouble = splitHands[handIndex].canDouble();
         bool canResplit = canPlayerResplit(playerIndex, handIndex);
         
-        std::cout << "Hand " << (handIndex + 1) << " - Choose action: (h)it, (s)tand";
-        if (canDouble) std::cout << ", (d)ouble down";
-        if (canResplit) std::cout << ", s(p)lit again";
-        std::cout << ": ";
+        Action action = handler.decide(handAsPlayer(playerIndex, handIndex), dealer,
+                                       canDouble, canResplit, false);
         
-        char choice;
-        std::cin >> choice;
-        choice = std::tolower(choice);
-        
-        if (choice == 'h') {
-            Card newCard = deck.dealCard();
-            currentHand.addCard(newCard);
-            std::cout << "Drew: " << newCard.toString() << std::endl;
-            
-            displaySplitHand(playerIndex, handIndex);
-            
-            if (currentHand.isBusted()) {
-                std::cout << "Hand " << (handIndex + 1) << " busts!" << std::endl;
-                handActive = false;
-            }
-            
-        } else if (choice == 's') {
-            std::cout << "Standing on hand " << (handIndex + 1) << std::endl;
-            handActive = false;
-            
-        } else if (choice == 'd' && canDouble) {
-            if (playerDoublesDownSplit(playerIndex, handIndex)) {
+        switch (legalAction(action, canDouble, canResplit, false)) {
+            case Action::HIT:
+                handActive = hitSplitHand(playerIndex, handIndex);
+                break;
+                
+            case Action::DOUBLE:
+                playerDoublesDownSplit(playerIndex, handIndex);
                 handActive = false;
-            }
-            
-        } else if (choice == 'p' && canResplit) {
-            if (reSplit(playerIndex, handIndex)) {
-                handActive = false;  // Current hand is done, will continue with next hands
+                break;
                 
-                // Note: After re-splitting, the playSplitHands loop will handle the new hands
-                // since we inserted the new hand into the vector, it will be processed
-                // in the main loop in playSplitHands()
-            }
-            
-        } else {
-            std::cout << "Invalid choice. Available options: h, s";
-            if (canDouble) std::cout << ", d";
-            if (canResplit) std::cout << ", p";
-            std::cout << std::endl;
+            case Action::SPLIT:
+                // The new hand is inserted after this one, and the
+                // playSplitHands loop plays it once this one is done
+                handActive = reSplit(playerIndex, handIndex);
+                break;
+                
+            default:
+                standSplitHand(playerIndex, handIndex);
+                handActive = false;
+                break;
         }
     }
 }
 
+bool SplitHand::hitSplitHand(int playerIndex, int handIndex) {
+    auto& splitHands = playerSplitHands[playerIndex];
+    if (handIndex < 0 || handIndex >= static_cast<int>(splitHands.size())) {
+        return false;
+    }
+    
+    notifyDecision(playerIndex, handIndex, Action::HIT);
+
+    SplitHands& currentHand = splitHands[handIndex];
+    Card newCard = dealCard();
+    currentHand.addCard(newCard);
+    std::cout << "Drew: " << newCard.toString() << std::endl;
+    
+    displaySplitHand(playerIndex, handIndex);
+    
+    if (currentHand.isBusted()) {
+        std::cout << "Hand " << (handIndex + 1) << " busts!" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+Card SplitHand::dealCard() {
+    Card card = deck.dealCard();
+    if (counting && counting->isCountingEnabled()) {
+        counting->updateCount(card);
+    }
+    return card;
+}
+
+Player SplitHand::handAsPlayer(int playerIndex, int handIndex) const {
+    const SplitHands& hand = playerSplitHands.at(playerIndex)[handIndex];
+    Player view(players[playerIndex].getName());
+    for (size_t i = 0; i < hand.getCardCount(); ++i) {
+        view.addCard(hand.cards.getCard(i));
+    }
+    return view;
+}
+
+void SplitHand::notifyDecision(int playerIndex, int handIndex, Action action) {
+    if (listener) {
+        listener->onSplitHandDecision(playerIndex, handIndex, playerSplitHands[playerIndex][handIndex].cards,
+                                      action);
+    }
+}
+
 bool SplitHand::canPlayerResplit(int playerIndex, int handIndex) {
     if (playerSplitHands.find(playerIndex) == playerSplitHands.end()) {
         return false;
@@ -147,12 +186,12 @@ bool SplitHand::canPlayerResplit(int playerIndex, int handIndex) {
         return false;
     }
     
-    if (hand.isAceSplit) {
+    if (hand.isAceSplit && !resplitAces) {
         return false;
     }
     
-    Card card1 = hand.cards[0];
-    Card card2 = hand.cards[1];
+    Card card1 = hand.cards.getCard(0);
+    Card card2 = hand.cards.getCard(1);
     
     int value1 = card1.getValue();
     int value2 = card2.getValue();
@@ -184,6 +223,8 @@ bool SplitHand::reSplit(int playerIndex, int handIndex) {
     if (!canPlayerResplit(playerIndex, handIndex)) {
         return false;
     }
+
+    notifyDecision(playerIndex, handIndex, Action::SPLIT);
     
     Player& player = players[playerIndex];
     SplitHands& handToSplit = splitHands[handIndex];
@@ -191,22 +232,22 @@ bool SplitHand::reSplit(int playerIndex, int handIndex) {
     std::cout << player.getName() << " re-splits hand " << (handIndex + 1) << "." << std::endl;
     
     // Get the two cards from the hand being split
-    Card card1 = handToSplit.cards[0];
-    Card card2 = handToSplit.cards[1];
+    Card card1 = handToSplit.cards.getCard(0);
+    Card card2 = handToSplit.cards.getCard(1);
     
     // Check if splitting Aces (special rules)
     bool splittingAces = (card1.getValue() == 1 && card2.getValue() == 1);
     
     // Create a new hand with the second card
-    SplitHands newHand(splittingAces);
+    SplitHands newHand(splittingAces, doubleAfterSplit);
     newHand.addCard(card2);
     
     // Remove the second card from the original hand
-    handToSplit.cards.pop_back();  // Remove the second card
+    handToSplit.cards.removeCard(1);  // Remove the second card
     
     // Deal one new card to each hand
-    handToSplit.addCard(deck.dealCard());
-    newHand.addCard(deck.dealCard());
+    handToSplit.addCard(dealCard());
+    newHand.addCard(dealCard());
     
     // Insert the new hand right after the current hand to maintain order
     splitHands.insert(splitHands.begin() + handIndex + 1, newHand);
@@ -232,8 +273,10 @@ bool SplitHand::playerDoublesDownSplit(int playerIndex, int handIndex) {
     if (!currentHand.canDouble()) {
         return false;
     }
+
+    notifyDecision(playerIndex, handIndex, Action::DOUBLE);
     
-    Card newCard = deck.dealCard();
+    Card newCard = dealCard();
     currentHand.addCard(newCard);
     currentHand.doubleDown();
     
@@ -251,6 +294,19 @@ bool SplitHand::playerDoublesDownSplit(int playerIndex, int handIndex) {
     return true;
 }
 
+bool SplitHand::standSplitHand(int playerIndex, int handIndex) {
+    auto found = playerSplitHands.find(playerIndex);
+    if (found == playerSplitHands.end() || handIndex < 0 ||
+        handIndex >= static_cast<int>(found->second.size())) {
+        return false;
+    }
+
+    notifyDecision(playerIndex, handIndex, Action::STAND);
+    found->second[handIndex].isActive = false;
+    std::cout << "Standing on hand " << (handIndex + 1) << std::endl;
+    return true;
+}
+
 void SplitHand::displaySplitHand(int playerIndex, int handIndex) const {
     const Player& player = players[playerIndex];
     const auto& splitHands = playerSplitHands.at(playerIndex);
@@ -264,9 +320,9 @@ void SplitHand::displaySplitHand(int playerIndex, int handIndex) const {
     
     std::cout << ": ";
     
-    for (size_t i = 0; i < currentHand.cards.size(); ++i) {
+    for (size_t i = 0; i < currentHand.cards.getCardCount(); ++i) {
         if (i > 0) std::cout << ", ";
-        std::cout << currentHand.cards[i].toString();
+        std::cout << currentHand.cards.getCard(i).toString();
     }
     
     std::cout << " (Total: " << currentHand.getTotalValue() << ")";
@@ -277,7 +333,7 @@ void SplitHand::displaySplitHand(int playerIndex, int handIndex) const {
         std::cout << " - BUST!";
     }
     
-    if (currentHand.isAceSplit && currentHand.cards.size() == 2) {
+    if (currentHand.isAceSplit && currentHand.cards.getCardCount() == 2) {
         std::cout << " [Aces split - no more cards]";
     }
     
@@ -308,18 +364,16 @@ bool SplitHand::playerSplits(int playerIndex) {
     }
     
     // Create split hands
-    std::vector<SplitHands> splitHands(2, SplitHands(splittingAces));
+    std::vector<SplitHands> splitHands(2, SplitHands(splittingAces, doubleAfterSplit));
     splitHands[0].addCard(card1);
     splitHands[1].addCard(card2);
     
     // Deal one card to each split hand
-    splitHands[0].addCard(deck.dealCard());
-    splitHands[1].addCard(deck.dealCard());
+    splitHands[0].addCard(dealCard());
+    splitHands[1].addCard(dealCard());
     
     // Store split hands
     playerSplitHands[playerIndex] = splitHands;
     
-    playSplitHands(playerIndex);
-    
     return true;
 }
\ No newline at end of file
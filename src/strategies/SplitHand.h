@@ -5,57 +5,54 @@
 #include <map>
 #include <vector>
 #include "card.h"
+#include "hand.h"
 #include "player.h"
+#include "StrategyTables.h"
+#include "TableRules.h"
 
 class Deck;
+class Dealer;
+class Counting;
+class PlayerActionHandler;
+
+// Hears about each decision on a split hand, made before it is carried
+// out. A resplit of `handIndex` puts the new hand at handIndex + 1.
+class SplitHandListener {
+public:
+    virtual ~SplitHandListener() = default;
+    virtual void onSplitHandDecision(int playerIndex, int handIndex, const Hand& cards, Action action) = 0;
+};
 
 class SplitHand {
 private:
     struct SplitHands {
-        std::vector<Card> cards;
+        Hand cards;
         bool isActive;
         bool canDoubleDown;   
         bool isAceSplit;      
         int betMultiplier;      
 
-        SplitHands(bool acesSplit = false) 
-            : isActive(true), canDoubleDown(true), isAceSplit(acesSplit), betMultiplier(1) {}
+        SplitHands(bool acesSplit = false, bool doubleAllowed = true) 
+            : isActive(true), canDoubleDown(doubleAllowed), isAceSplit(acesSplit), betMultiplier(1) {}
         
         void addCard(const Card& card) {
-            cards.push_back(card);
+            cards.addCard(card);
             // after you split aces you cant hit again
-            if (isAceSplit && cards.size() >= 2) {
+            if (isAceSplit && cards.getCardCount() >= 2) {
                 isActive = false;
             }
             // only double on the firsthit
-            if (cards.size() > 2) {
+            if (cards.getCardCount() > 2) {
                 canDoubleDown = false;
             }
         }
         
         int getTotalValue() const {
-            int totalVal = 0;
-            int aceCount = 0;
-            for (const auto& card : cards) {
-                int cardValue = card.getValue();
-                if (cardValue == 1) {
-                    aceCount++;
-                    totalVal += 11;
-                } else if (cardValue > 10) {
-                    totalVal += 10;
-                } else {
-                    totalVal += cardValue;
-                }
-            }
-            while(totalVal > 21 && aceCount > 0) {
-                totalVal -= 10;
-                aceCount--;
-            }
-            return totalVal;
+            return cards.getTotalValue();
         }
         
         bool isBusted() const {
-            return getTotalValue() > 21;
+            return cards.isBusted();
         }
         
         bool isBlackjack() const {
@@ -69,11 +66,11 @@ private:
         }
         
         size_t getCardCount() const {
-            return cards.size();
+            return cards.getCardCount();
         }
         
         bool canDouble() const {
-            return canDoubleDown && cards.size() == 2 && !isBusted();
+            return canDoubleDown && cards.getCardCount() == 2 && !isBusted();
         }
         
         void doubleDown() {
@@ -89,18 +86,38 @@ private:
     std::map<int, std::vector<SplitHands>> playerSplitHands;
     std::vector<Player>& players;
     Deck& deck;
+    Counting* counting;
+    SplitHandListener* listener;
     int maxSplits; 
+    bool doubleAfterSplit;
+    bool resplitAces;
+
+    // Deals from the shoe and counts the card when counting is on
+    Card dealCard();
+
+    // The split hand as a Player, for the action handler
+    Player handAsPlayer(int playerIndex, int handIndex) const;
+
+    void notifyDecision(int playerIndex, int handIndex, Action action);
 
 public:
-    SplitHand(std::vector<Player>& gamePlayers, Deck& gameDeck, int maxSplitsAllowed = 4);
+    SplitHand(std::vector<Player>& gamePlayers, Deck& gameDeck, const TableRules& rules = TableRules());
     
+    // Splits the pair into two hands of one card plus one dealt card each;
+    // the hands are then played by playSplitHands or one action at a time
     bool playerSplits(int playerIndex);
-    void playSplitHands(int playerIndex);
-    void playSingleSplitHand(int playerIndex, int handIndex);
+    void clearSplitHands() { playerSplitHands.clear(); }
+    void setCounting(Counting* countingSystem) { counting = countingSystem; }
+    // Pass nullptr to unsubscribe
+    void setListener(SplitHandListener* splitListener) { listener = splitListener; }
+    void playSplitHands(int playerIndex, PlayerActionHandler& handler, const Dealer& dealer);
+    void playSingleSplitHand(int playerIndex, int handIndex, PlayerActionHandler& handler, const Dealer& dealer);
     void displaySplitHand(int playerIndex, int handIndex) const;
     bool canPlayerSplit(int playerIndex);
     bool canPlayerResplit(int playerIndex, int handIndex);  
+    bool hitSplitHand(int playerIndex, int handIndex);  // false once the hand busts
     bool playerDoublesDownSplit(int playerIndex, int handIndex);  
+    bool standSplitHand(int playerIndex, int handIndex);
     bool reSplit(int playerIndex, int handIndex);
     
     const std::map<int, std::vector<SplitHands>>& getPlayerSplitHands() const {
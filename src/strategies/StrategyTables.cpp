@@ -0,0 +1,145 @@
+#include "StrategyTables.h"
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+
+const char strategy_file_magic[4] = {'B', 'J', 'S', 'T'};
+const uint32_t strategy_file_version = 1;
+
+// Rule fields a table depends on; the cut card and payout do not change play
+struct StrategyFileHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t numDecks;
+    int32_t maxSplitHands;
+    uint8_t dealerHitsSoft17;
+    uint8_t doubleAfterSplit;
+    uint8_t resplitAces;
+    uint8_t lateSurrender;
+};
+
+StrategyFileHeader makeHeader(const TableRules& rules) {
+    StrategyFileHeader header;
+    std::memcpy(header.magic, strategy_file_magic, sizeof(header.magic));
+    header.version = strategy_file_version;
+    header.numDecks = rules.numDecks;
+    header.maxSplitHands = rules.maxSplitHands;
+    header.dealerHitsSoft17 = rules.dealerHitsSoft17;
+    header.doubleAfterSplit = rules.doubleAfterSplit;
+    header.resplitAces = rules.resplitAces;
+    header.lateSurrender = rules.lateSurrender;
+    return header;
+}
+
+const int cells_per_table = StrategyTable::hand_types * StrategyTable::values * StrategyTable::dealer_cards;
+
+}
+
+void writeStrategyTable(const std::string& path, const StrategyTable& table, const TableRules& rules) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot write strategy table: " + path);
+    }
+
+    StrategyFileHeader header = makeHeader(rules);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(table.primary), cells_per_table);
+    file.write(reinterpret_cast<const char*>(table.fallback), cells_per_table);
+
+    if (!file) {
+        throw std::runtime_error("Failed writing strategy table: " + path);
+    }
+}
+
+StrategyTable readStrategyTable(const std::string& path, const TableRules& rules) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open strategy table: " + path);
+    }
+
+    StrategyFileHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || std::memcmp(header.magic, strategy_file_magic, sizeof(header.magic)) != 0 ||
+        header.version != strategy_file_version) {
+        throw std::runtime_error("Not a strategy table file: " + path);
+    }
+
+    StrategyFileHeader expected = makeHeader(rules);
+    if (header.numDecks != expected.numDecks || header.maxSplitHands != expected.maxSplitHands ||
+        header.dealerHitsSoft17 != expected.dealerHitsSoft17 ||
+        header.doubleAfterSplit != expected.doubleAfterSplit ||
+        header.resplitAces != expected.resplitAces ||
+        header.lateSurrender != expected.lateSurrender) {
+        throw std::runtime_error("Strategy table " + path + " was generated for other rules than " +
+                                 rules.describe());
+    }
+
+    StrategyTable table;
+    file.read(reinterpret_cast<char*>(table.primary), cells_per_table);
+    file.read(reinterpret_cast<char*>(table.fallback), cells_per_table);
+    if (!file) {
+        throw std::runtime_error("Strategy table is truncated: " + path);
+    }
+
+    // Reject bytes that are not actions rather than trusting the file
+    const uint8_t* cells[2] = {reinterpret_cast<const uint8_t*>(table.primary),
+                               reinterpret_cast<const uint8_t*>(table.fallback)};
+    for (const uint8_t* cell : cells) {
+        for (int i = 0; i < cells_per_table; ++i) {
+            if (cell[i] > static_cast<uint8_t>(Action::SURRENDER)) {
+                throw std::runtime_error("Strategy table is damaged: " + path);
+            }
+        }
+    }
+
+    return table;
+}
+
+std::string strategyCellCode(Action primary, Action fallback) {
+    std::string backup = fallback == Action::STAND ? "s" : "h";
+    switch (primary) {
+        case Action::HIT: return "H";
+        case Action::STAND: return "S";
+        case Action::SPLIT: return "P";
+        case Action::DOUBLE: return "D" + backup;
+        case Action::SURRENDER: return "R" + backup;
+        default: return "?";
+    }
+}
+
+void printStrategyTable(std::ostream& out, const StrategyTable& table, HandType handType) {
+    int row = static_cast<int>(handType);
+    int first = handType == HandType::PAIR ? 1 : (handType == HandType::SOFT ? 13 : 5);
+    int last = handType == HandType::PAIR ? 10 : 21;
+    const char* title = handType == HandType::PAIR ? "Pairs" : (handType == HandType::SOFT ? "Soft" : "Hard");
+
+    out << std::left << std::setw(7) << title;
+    for (int dealer = 2; dealer <= 11; ++dealer) {
+        out << std::setw(4) << (dealer == 11 ? std::string("A") : std::to_string(dealer));
+    }
+    out << std::endl;
+
+    for (int value = first; value <= last; ++value) {
+        std::string label;
+        if (handType == HandType::PAIR) {
+            std::string card = value == 1 ? "A" : (value == 10 ? "T" : std::to_string(value));
+            label = card + "," + card;
+        } else {
+            label = std::to_string(value);
+        }
+
+        out << std::setw(7) << label;
+        for (int dealer = 2; dealer <= 11; ++dealer) {
+            int column = dealer == 11 ? 1 : dealer;
+            out << std::setw(4) << strategyCellCode(table.primary[row][value][column],
+                                                    table.fallback[row][value][column]);
+        }
+        out << std::endl;
+    }
+    out << std::right;
+}
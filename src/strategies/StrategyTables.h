@@ -0,0 +1,152 @@
+#ifndef STRATEGYTABLES_H
+#define STRATEGYTABLES_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include "TableRules.h"
+
+enum class Action : uint8_t {
+    HIT,
+    STAND,
+    DOUBLE,
+    SPLIT,
+    SURRENDER
+};
+
+enum class HandType : uint8_t {
+    HARD,
+    SOFT,
+    PAIR
+};
+
+// Dense basic strategy, indexed [handType][value][dealerUp].
+//   HARD/SOFT rows are indexed by hand total (0-21)
+//   PAIR rows are indexed by the pair's card value (1 = aces, 10 = tens)
+//   dealerUp is 1 (ace) to 10; column 0 is unused
+// `primary` is the best play. `fallback` is what to do when that play is
+// not allowed: the hit/stand behind a double or surrender. A split that is
+// not allowed is looked up again under the pair's plain total.
+struct StrategyTable {
+    static const int hand_types = 3;
+    static const int values = 22;
+    static const int dealer_cards = 11;
+
+    Action primary[hand_types][values][dealer_cards];
+    Action fallback[hand_types][values][dealer_cards];
+
+    constexpr StrategyTable() : primary(), fallback() {}
+
+    constexpr void set(HandType type, int value, int dealerUp, Action play, Action otherwise) {
+        primary[static_cast<int>(type)][value][dealerUp] = play;
+        fallback[static_cast<int>(type)][value][dealerUp] = otherwise;
+    }
+};
+
+// Builds the table for one rule variant. The base chart is multi-deck S17
+// with double after split and no surrender; the flags layer the usual
+// H17, no-DAS and late surrender changes on top.
+constexpr StrategyTable buildStrategyTable(bool dealerHitsSoft17, bool doubleAfterSplit,
+                                           bool lateSurrender) {
+    StrategyTable table;
+    const Action H = Action::HIT, S = Action::STAND, D = Action::DOUBLE,
+                 P = Action::SPLIT, R = Action::SURRENDER;
+
+    for (int dealer = 1; dealer <= 10; ++dealer) {
+        bool vs2to6 = dealer >= 2 && dealer <= 6;
+        bool vs3to6 = dealer >= 3 && dealer <= 6;
+        bool vs4to6 = dealer >= 4 && dealer <= 6;
+        bool vs5to6 = dealer >= 5 && dealer <= 6;
+
+        // Hard totals
+        for (int total = 0; total <= 8; ++total) table.set(HandType::HARD, total, dealer, H, H);
+        table.set(HandType::HARD, 9, dealer, vs3to6 ? D : H, H);
+        table.set(HandType::HARD, 10, dealer, (dealer >= 2 && dealer <= 9) ? D : H, H);
+        table.set(HandType::HARD, 11, dealer, (dealer != 1 || dealerHitsSoft17) ? D : H, H);
+        table.set(HandType::HARD, 12, dealer, vs4to6 ? S : H, H);
+        for (int total = 13; total <= 16; ++total) {
+            table.set(HandType::HARD, total, dealer, vs2to6 ? S : H, vs2to6 ? S : H);
+        }
+        for (int total = 17; total <= 21; ++total) table.set(HandType::HARD, total, dealer, S, S);
+
+        // Soft totals (an ace counted as 11)
+        for (int total = 0; total <= 11; ++total) table.set(HandType::SOFT, total, dealer, H, H);
+        table.set(HandType::SOFT, 12, dealer, dealer == 6 ? D : H, H); // A,A not split
+        table.set(HandType::SOFT, 13, dealer, vs5to6 ? D : H, H); // A,2
+        table.set(HandType::SOFT, 14, dealer, vs5to6 ? D : H, H); // A,3
+        table.set(HandType::SOFT, 15, dealer, vs4to6 ? D : H, H); // A,4
+        table.set(HandType::SOFT, 16, dealer, vs4to6 ? D : H, H); // A,5
+        table.set(HandType::SOFT, 17, dealer, vs3to6 ? D : H, H); // A,6
+        {
+            // A,7: stand vs 2,7,8; double vs 3-6; hit vs 9,10,A
+            bool doubleSoft18 = vs3to6 || (dealer == 2 && dealerHitsSoft17);
+            bool standSoft18 = dealer == 2 || dealer == 7 || dealer == 8;
+            table.set(HandType::SOFT, 18, dealer, doubleSoft18 ? D : (standSoft18 ? S : H),
+                      (standSoft18 || vs3to6) ? S : H);
+        }
+        table.set(HandType::SOFT, 19, dealer, (dealer == 6 && dealerHitsSoft17) ? D : S, S); // A,8
+        table.set(HandType::SOFT, 20, dealer, S, S);
+        table.set(HandType::SOFT, 21, dealer, S, S);
+
+        // Pairs; the fallback is only used for 5,5 which doubles as hard 10
+        bool splitLowPairs = doubleAfterSplit ? (dealer >= 2 && dealer <= 7) : (dealer >= 4 && dealer <= 7);
+        bool splitSixes = doubleAfterSplit ? vs2to6 : vs3to6;
+        table.set(HandType::PAIR, 1, dealer, P, H);
+        table.set(HandType::PAIR, 2, dealer, splitLowPairs ? P : H, H);
+        table.set(HandType::PAIR, 3, dealer, splitLowPairs ? P : H, H);
+        table.set(HandType::PAIR, 4, dealer, (doubleAfterSplit && vs5to6) ? P : H, H);
+        table.set(HandType::PAIR, 5, dealer, (dealer >= 2 && dealer <= 9) ? D : H, H);
+        table.set(HandType::PAIR, 6, dealer, splitSixes ? P : H, H);
+        table.set(HandType::PAIR, 7, dealer, (dealer >= 2 && dealer <= 7) ? P : H, H);
+        table.set(HandType::PAIR, 8, dealer, P, H);
+        table.set(HandType::PAIR, 9, dealer, (dealer == 7 || dealer == 10 || dealer == 1) ? S : P, S);
+        table.set(HandType::PAIR, 10, dealer, S, S);
+    }
+
+    if (lateSurrender) {
+        table.set(HandType::HARD, 16, 9, R, H);
+        table.set(HandType::HARD, 16, 10, R, H);
+        table.set(HandType::HARD, 16, 1, R, H);
+        table.set(HandType::HARD, 15, 10, R, H);
+        if (dealerHitsSoft17) {
+            table.set(HandType::HARD, 15, 1, R, H);
+            table.set(HandType::HARD, 17, 1, R, S);
+        }
+    }
+
+    return table;
+}
+
+// Index of a rule variant in strategy_tables
+constexpr int strategyTableIndex(bool dealerHitsSoft17, bool doubleAfterSplit, bool lateSurrender) {
+    return (dealerHitsSoft17 ? 1 : 0) | (doubleAfterSplit ? 2 : 0) | (lateSurrender ? 4 : 0);
+}
+
+// Every rule variant, built at compile time
+inline constexpr StrategyTable strategy_tables[8] = {
+    buildStrategyTable(false, false, false), buildStrategyTable(true, false, false),
+    buildStrategyTable(false, true, false),  buildStrategyTable(true, true, false),
+    buildStrategyTable(false, false, true),  buildStrategyTable(true, false, true),
+    buildStrategyTable(false, true, true),   buildStrategyTable(true, true, true)
+};
+
+// Compile-time selection for code that fixes its rules as template arguments
+template <bool DealerHitsSoft17, bool DoubleAfterSplit, bool LateSurrender>
+constexpr const StrategyTable& strategyTableFor() {
+    return strategy_tables[strategyTableIndex(DealerHitsSoft17, DoubleAfterSplit, LateSurrender)];
+}
+
+// Binary table files, as written by the bjstrat generator. The file records
+// the rules it was generated for, and reading it for different rules throws
+// std::runtime_error, as does a missing or damaged file.
+void writeStrategyTable(const std::string& path, const StrategyTable& table, const TableRules& rules);
+StrategyTable readStrategyTable(const std::string& path, const TableRules& rules);
+
+// Short chart code for a cell: "H", "S", "P", or "Dh"/"Ds"/"Rh"/"Rs" for a
+// double or surrender with its fallback
+std::string strategyCellCode(Action primary, Action fallback);
+
+// Prints one section of the chart with dealer upcards 2-10 and A across
+void printStrategyTable(std::ostream& out, const StrategyTable& table, HandType handType);
+
+#endif
@@ -2,243 +2,52 @@
 
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <stdexcept>
 
 #include "player.h"
 #include "Dealer.h"
 
 
-BasicStrat::BasicStrat() {
-    initializeStrategyTables();
+BasicStrat::BasicStrat(const TableRules& tableRules)
+    : rules(tableRules),
+      table(&strategy_tables[strategyTableIndex(tableRules.dealerHitsSoft17,
+                                                tableRules.doubleAfterSplit,
+                                                tableRules.lateSurrender)]),
+      registry(std::make_shared<PlayerRegistry>()),
+      evAnalyzer(tableRules) {}
+
+void BasicStrat::loadStrategyTables(const std::string& path) {
+    loadedTable = std::make_shared<const StrategyTable>(readStrategyTable(path, rules));
+    table = loadedTable.get();
 }
 
-void BasicStrat::initializeStrategyTables() {
-    // Hard totals strategy table (player total, dealer up card) -> action
-    // Dealer up cards: A=1, 2-9=face value, T/J/Q/K=10
-    
-    // Hard totals (no aces counted as 11)
-    // 8 and below: always hit
-    for (int total = 5; total <= 8; ++total) {
-        for (int dealer = 1; dealer <= 10; ++dealer) {
-            hardTotalsTable[{total, dealer}] = Action::HIT;
-        }
-    }
-    
-    // 9: Double vs 3-6, otherwise hit
-    for (int dealer = 1; dealer <= 10; ++dealer) {
-        if (dealer >= 3 && dealer <= 6) {
-            hardTotalsTable[{9, dealer}] = Action::DOUBLE;
-        } else {
-            hardTotalsTable[{9, dealer}] = Action::HIT;
-        }
-    }
-    
-    // 10: Double vs 2-9, otherwise hit
-    for (int dealer = 1; dealer <= 10; ++dealer) {
-        if (dealer >= 2 && dealer <= 9) {
-            hardTotalsTable[{10, dealer}] = Action::DOUBLE;
-        } else {
-            hardTotalsTable[{10, dealer}] = Action::HIT;
-        }
-    }
-    
-    // 11: Double vs 2-10, hit vs ace
-    for (int dealer = 1; dealer <= 10; ++dealer) {
-        if (dealer == 1) {
-            hardTotalsTable[{11, dealer}] = Action::HIT;
-        } else {
-            hardTotalsTable[{11, dealer}] = Action::DOUBLE;
-        }
-    }
-    
-    // 12: Stand vs 4-6, otherwise hit
-    for (int dealer = 1; dealer <= 10; ++dealer) {
-        if (dealer >= 4 && dealer <= 6) {
-            hardTotalsTable[{12, dealer}] = Action::STAND;
-        } else {
-            hardTotalsTable[{12, dealer}] = Action::HIT;
-        }
-    }
-    
-    // 13-16: Stand vs 2-6, otherwise hit
-    for (int total = 13; total <= 16; ++total) {
-        for (int dealer = 1; dealer <= 10; ++dealer) {
-            if (dealer >= 2 && dealer <= 6) {
-                hardTotalsTable[{total, dealer}] = Action::STAND;
-            } else {
-                hardTotalsTable[{total, dealer}] = Action::HIT;
-            }
-        }
-    }
-    
-    // 17 and above: always stand
-    for (int total = 17; total <= 21; ++total) {
-        for (int dealer = 1; dealer <= 10; ++dealer) {
-            hardTotalsTable[{total, dealer}] = Action::STAND;
-        }
-    }
-    
-    // Soft totals strategy table (ace counted as 11)
-    // A,2 and A,3: Double vs 5-6, otherwise hit
-    for (int dealer = 1; dealer <= 10; ++dealer) {
-        if (dealer >= 5 && dealer <= 6) {
-            softTotalsTable[{13, dealer}] = Action::DOUBLE; // A,2
-            softTotalsTable[{14, dealer}] = Action::DOUBLE; // A,3
-        } else {
-            softTotalsTable[{13, dealer}] = Action::HIT;
-            softTotalsTable[{14, dealer}] = Action::HIT;
-        }
-    }
-    
-    // A,4 and A,5: Double vs 4-6, otherwise hit
-    for (int dealer = 1; dealer <= 10; ++dealer) {
-        if (dealer >= 4 && dealer <= 6) {
-            softTotalsTable[{15, dealer}] = Action::DOUBLE; // A,4
-            softTotalsTable[{16, dealer}] = Action::DOUBLE; // A,5
-        } else {
-            softTotalsTable[{15, dealer}] = Action::HIT;
-            softTotalsTable[{16, dealer}] = Action::HIT;
-        }
-    }
-    
-    // A,6: Double vs 3-6, otherwise hit
-    for (int dealer = 1; dealer <= 10; ++dealer) {
-        if (dealer >= 3 && dealer <= 6) {
-            softTotalsTable[{17, dealer}] = Action::DOUBLE; // A,6
-        } else {
-            softTotalsTable[{17, dealer}] = Action::HIT;
-        }
-    }
-    
-    // A,7: Stand vs 2,7,8; Double vs 3-6; Hit vs 9,10,A
-    for (int dealer = 1; dealer <= 10; ++dealer) {
-        if (dealer == 2 || dealer == 7 || dealer == 8) {
-            softTotalsTable[{18, dealer}] = Action::STAND; // A,7
-        } else if (dealer >= 3 && dealer <= 6) {
-            softTotalsTable[{18, dealer}] = Action::DOUBLE;
-        } else {
-            softTotalsTable[{18, dealer}] = Action::HIT;
-        }
-    }
-    
-    // A,8 and A,9: Always stand
-    for (int dealer = 1; dealer <= 10; ++dealer) {
-        softTotalsTable[{19, dealer}] = Action::STAND; // A,8
-        softTotalsTable[{20, dealer}] = Action::STAND; // A,9
-    }
-    
-    // Pairs strategy table
-    // A,A: Always split
-    for (int dealer = 1; dealer <= 10; ++dealer) {
-        pairsTable[{1, dealer}] = Action::SPLIT;
-    }
-    
-    // 2,2 and 3,3: Split vs 2-7, otherwise hit
-    for (int dealer = 1; dealer <= 10; ++dealer) {
-        if (dealer >= 2 && dealer <= 7) {
-            pairsTable[{2, dealer}] = Action::SPLIT;
-            pairsTable[{3, dealer}] = Action::SPLIT;
-        } else {
-            pairsTable[{2, dealer}] = Action::HIT;
-            pairsTable[{3, dealer}] = Action::HIT;
-        }
-    }
-    
-    // 4,4: Hit vs all (some variations split vs 5-6)
-    for (int dealer = 1; dealer <= 10; ++dealer) {
-        pairsTable[{4, dealer}] = Action::HIT;
-    }
-    
-    // 5,5: Never split, treat as hard 10
-    for (int dealer = 1; dealer <= 10; ++dealer) {
-        if (dealer >= 2 && dealer <= 9) {
-            pairsTable[{5, dealer}] = Action::DOUBLE;
-        } else {
-            pairsTable[{5, dealer}] = Action::HIT;
-        }
-    }
-    
-    // 6,6: Split vs 2-6, otherwise hit
-    for (int dealer = 1; dealer <= 10; ++dealer) {
-        if (dealer >= 2 && dealer <= 6) {
-            pairsTable[{6, dealer}] = Action::SPLIT;
-        } else {
-            pairsTable[{6, dealer}] = Action::HIT;
-        }
-    }
-    
-    // 7,7: Split vs 2-7, otherwise hit
-    for (int dealer = 1; dealer <= 10; ++dealer) {
-        if (dealer >= 2 && dealer <= 7) {
-            pairsTable[{7, dealer}] = Action::SPLIT;
-        } else {
-            pairsTable[{7, dealer}] = Action::HIT;
-        }
-    }
-    
-    // 8,8: Always split
-    for (int dealer = 1; dealer <= 10; ++dealer) {
-        pairsTable[{8, dealer}] = Action::SPLIT;
-    }
-    
-    // 9,9: Split vs 2-9 except 7, stand vs 7,10,A
-    for (int dealer = 1; dealer <= 10; ++dealer) {
-        if (dealer == 7 || dealer == 10 || dealer == 1) {
-            pairsTable[{9, dealer}] = Action::STAND;
-        } else {
-            pairsTable[{9, dealer}] = Action::SPLIT;
-        }
+void BasicStrat::loadIndexTables(const std::string& path) {
+    loadedIndices = std::make_shared<const IndexTableSet>(readIndexTables(path, rules));
+}
+
+const IndexTable& BasicStrat::getIndexTable(int system) const {
+    if (system < 0 || system >= index_table_systems) {
+        throw std::out_of_range("Counting system index out of range");
     }
-    
-    // 10,10: Never split, always stand
-    for (int dealer = 1; dealer <= 10; ++dealer) {
-        pairsTable[{10, dealer}] = Action::STAND;
+    if (loadedIndices && loadedIndices->present[system]) {
+        return loadedIndices->tables[system];
     }
+    return index_tables[system][rules.dealerHitsSoft17 ? 1 : 0];
 }
 
 HandType BasicStrat::determineHandType(const Player& player) const {
-    if (player.getCardCount() != 2) {
-        // For hands with more than 2 cards, check if we have a soft total
-        int aces = 0;
-        int total = 0;
-        
-        for (size_t i = 0; i < player.getCardCount(); ++i) {
-            int value = player.getCard(i).getValue();
-            if (value == 1) aces++;
-            else if (value > 10) total += 10;
-            else total += value;
-        }
-        
-        // Check if we can count an ace as 11 without busting
-        if (aces > 0 && (total + 11 + (aces - 1)) <= 21) {
-            return HandType::SOFT;
+    if (player.getCardCount() == 2) {
+        int value1 = player.getCard(0).getValue();
+        int value2 = player.getCard(1).getValue();
+
+        // Any two ten-valued cards count as a pair
+        if (value1 == value2 || (value1 >= 10 && value2 >= 10)) {
+            return HandType::PAIR;
         }
-        return HandType::HARD;
-    }
-    
-    // For 2-card hands
-    Card card1 = player.getCard(0);
-    Card card2 = player.getCard(1);
-    int value1 = card1.getValue();
-    int value2 = card2.getValue();
-    
-    // Check for pairs first
-    if (value1 == value2) {
-        return HandType::PAIR;
-    }
-    
-    // Check for face card pairs (both worth 10)
-    bool card1IsFace = (value1 >= 10);
-    bool card2IsFace = (value2 >= 10);
-    if (card1IsFace && card2IsFace) {
-        return HandType::PAIR;
-    }
-    
-    // Check for soft totals (ace + another card)
-    if (value1 == 1 || value2 == 1) {
-        return HandType::SOFT;
     }
-    
-    return HandType::HARD;
+
+    return player.isSoft() ? HandType::SOFT : HandType::HARD;
 }
 
 int BasicStrat::getHandValue(const Player& player, HandType& handType) const {
@@ -258,44 +67,81 @@ int BasicStrat::getDealerUpValue(const Dealer& dealer) const {
 }
 
 Action BasicStrat::getOptimalAction(const Player& player, const Dealer& dealer, 
-                                   bool canDouble, bool canSurrender) const {
+                                   bool canDouble, bool canSurrender, bool canSplit) const {
     HandType handType = determineHandType(player);
     int handValue = getHandValue(player, handType);
     int dealerUp = getDealerUpValue(dealer);
-    
-    Action action;
-    
-    switch (handType) {
-        case HandType::PAIR: {
-            auto it = pairsTable.find({handValue, dealerUp});
-            action = (it != pairsTable.end()) ? it->second : Action::HIT;
-            break;
-        }
-        case HandType::SOFT: {
-            auto it = softTotalsTable.find({handValue, dealerUp});
-            action = (it != softTotalsTable.end()) ? it->second : Action::STAND;
-            break;
-        }
-        case HandType::HARD: {
-            auto it = hardTotalsTable.find({handValue, dealerUp});
-            action = (it != hardTotalsTable.end()) ? it->second : Action::STAND;
-            break;
-        }
+
+    return lookupAction(handType, handValue, dealerUp, canDouble, canSurrender, canSplit);
+}
+
+Action BasicStrat::lookupAction(HandType handType, int value, int dealerUp,
+                                bool canDouble, bool canSurrender, bool canSplit) const {
+    value = std::min(value, StrategyTable::values - 1);
+
+    int row = static_cast<int>(handType);
+    Action action = table->primary[row][value][dealerUp];
+
+    // A pair we are not allowed to split plays as its plain total
+    if (action == Action::SPLIT && !canSplit) {
+        bool aces = value == 1;
+        row = static_cast<int>(aces ? HandType::SOFT : HandType::HARD);
+        value = aces ? 12 : value * 2;
+        action = table->primary[row][value][dealerUp];
     }
-    
-    // Adjust for game constraints
-    if (action == Action::DOUBLE && !canDouble) {
-        action = Action::HIT;
+
+    if ((action == Action::DOUBLE && !canDouble) ||
+        (action == Action::SURRENDER && !canSurrender)) {
+        action = table->fallback[row][value][dealerUp];
     }
-    if (action == Action::SURRENDER && !canSurrender) {
-        // Fall back to basic strategy without surrender
-        if (handValue >= 15 && handValue <= 16 && (dealerUp == 9 || dealerUp == 10 || dealerUp == 1)) {
-            action = Action::HIT;
-        } else {
-            action = Action::STAND;
-        }
+
+    return action;
+}
+
+Action BasicStrat::getOptimalAction(const Player& player, const Dealer& dealer,
+                                   const IndexTable& indices, double trueCount,
+                                   bool canDouble, bool canSurrender, bool canSplit) const {
+    HandType handType = determineHandType(player);
+    int handValue = getHandValue(player, handType);
+    int dealerUp = getDealerUpValue(dealer);
+
+    return lookupAction(handType, handValue, dealerUp, indices, trueCount,
+                        canDouble, canSurrender, canSplit);
+}
+
+Action BasicStrat::lookupAction(HandType handType, int value, int dealerUp,
+                                const IndexTable& indices, double trueCount,
+                                bool canDouble, bool canSurrender, bool canSplit) const {
+    value = std::min(value, StrategyTable::values - 1);
+
+    int row = static_cast<int>(handType);
+
+    // A surrender index decides surrendering for its cell on the count alone
+    const IndexEntry& surrender = indices.surrender[row][value][dealerUp];
+    if (surrender.active) {
+        if (canSurrender && trueCount >= surrender.index) return Action::SURRENDER;
+        canSurrender = false;
     }
-    
+    if (canSurrender && table->primary[row][value][dealerUp] == Action::SURRENDER) {
+        return Action::SURRENDER;
+    }
+
+    const IndexEntry& entry = indices.plays[row][value][dealerUp];
+    Action action = entry.active ? (trueCount >= entry.index ? entry.atOrAbove : entry.below)
+                                 : table->primary[row][value][dealerUp];
+
+    // A pair we are not allowed to split plays as its plain total, which
+    // may have an index of its own
+    if (action == Action::SPLIT && !canSplit) {
+        bool aces = value == 1;
+        return lookupAction(aces ? HandType::SOFT : HandType::HARD, aces ? 12 : value * 2, dealerUp,
+                            indices, trueCount, canDouble, canSurrender, false);
+    }
+
+    if ((action == Action::DOUBLE && !canDouble) || action == Action::SURRENDER) {
+        action = table->fallback[row][value][dealerUp];
+    }
+
     return action;
 }
 
@@ -326,28 +172,106 @@ void BasicStrat::suggestAction(const Player& player, const Dealer& dealer,
 
 void BasicStrat::recordPlayerAction(const std::string& playerName, const Player& player, 
                                    const Dealer& dealer, Action takenAction,
-                                   bool canDouble, bool canSurrender) {
-    Action optimalAction = getOptimalAction(player, dealer, canDouble, canSurrender);
+                                   bool canDouble, bool canSurrender, bool canSplit,
+                                   const ShoeComposition* unseen,
+                                   const IndexTable* indices, double trueCount) {
+    recordPlayerAction(registry->intern(playerName), player, dealer, takenAction, canDouble, canSurrender,
+                       canSplit, unseen, indices, trueCount);
+}
+
+void BasicStrat::recordPlayerAction(PlayerId id, const Player& player,
+                                   const Dealer& dealer, Action takenAction,
+                                   bool canDouble, bool canSurrender, bool canSplit,
+                                   const ShoeComposition* unseen,
+                                   const IndexTable* indices, double trueCount) {
+    if (id < 0 || id >= registry->size()) {
+        throw std::out_of_range("Player id " + std::to_string(id) + " is not registered");
+    }
+    if (id >= static_cast<PlayerId>(playerRecords.size())) {
+        playerRecords.resize(id + 1);
+    }
+    StrategyRecord& record = playerRecords[id];
+
+    // Mask as EVAnalyzer::analyze does, so a play graded a deviation below
+    // is also the one that loses EV
+    bool twoCards = player.getCardCount() == 2;
+    canDouble = canDouble && twoCards;
+    canSurrender = canSurrender && twoCards && rules.lateSurrender;
+
+    Action optimalAction = indices ? getOptimalAction(player, dealer, *indices, trueCount,
+                                                      canDouble, canSurrender, canSplit)
+                                   : getOptimalAction(player, dealer, canDouble, canSurrender, canSplit);
     
-    totalActions[playerName]++;
+    record.totalActions++;
     
     if (takenAction == optimalAction) {
-        correctActions[playerName]++;
+        record.correctActions++;
+        return;
+    }
+
+    record.deviations++;
+
+    int dealerUp = getDealerUpValue(dealer);
+    if (dealerUp == 0 || player.isBusted()) return;
+
+    ShoeComposition counts;
+    if (unseen) {
+        counts = *unseen;
     } else {
-        deviations[playerName]++;
+        counts = EVAnalyzer::fullShoe(rules.numDecks);
+        for (size_t i = 0; i < player.getCardCount(); ++i) {
+            int rank = player.getCard(i).getPacked().getRankIndex();
+            counts[rank] = std::max(0, counts[rank] - 1);
+        }
+        counts[dealerUp - 1] = std::max(0, counts[dealerUp - 1] - 1);
+    }
+
+    ActionEV ev = evAnalyzer.analyze(player, dealerUp, counts, canDouble, canSurrender, canSplit);
+    record.evLost += std::max(0.0, ev.getBestEV() - ev.getEV(takenAction));
+}
+
+void BasicStrat::displayStrategyTable(HandType handType) const {
+    std::cout << "\n--- BASIC STRATEGY: " << rules.describe() << " ---" << std::endl;
+    printStrategyTable(std::cout, *table, handType);
+}
+
+const BasicStrat::StrategyRecord* BasicStrat::findRecord(const std::string& playerName) const {
+    PlayerId id = registry->find(playerName);
+    if (id == no_player || id >= static_cast<PlayerId>(playerRecords.size()) ||
+        playerRecords[id].totalActions == 0) {
+        return nullptr;
+    }
+    return &playerRecords[id];
+}
+
+void BasicStrat::usePlayerRegistry(std::shared_ptr<PlayerRegistry> playerRegistry) {
+    if (!playerRegistry) {
+        throw std::invalid_argument("BasicStrat needs a player registry");
+    }
+    std::vector<StrategyRecord> recorded;
+    recorded.swap(playerRecords);
+    std::shared_ptr<PlayerRegistry> previous = registry;
+    registry = std::move(playerRegistry);
+
+    for (PlayerId id = 0; id < static_cast<PlayerId>(recorded.size()); ++id) {
+        if (recorded[id].totalActions == 0) continue;
+        PlayerId newId = registry->intern(previous->getName(id));
+        if (newId >= static_cast<PlayerId>(playerRecords.size())) {
+            playerRecords.resize(newId + 1);
+        }
+        playerRecords[newId] = recorded[id];
     }
 }
 
 void BasicStrat::displayPlayerStats(const std::string& playerName) const {
-    auto totalIt = totalActions.find(playerName);
-    if (totalIt == totalActions.end() || totalIt->second == 0) {
+    const StrategyRecord* record = findRecord(playerName);
+    if (!record) {
         std::cout << "No strategy data for " << playerName << std::endl;
         return;
     }
     
-    int total = totalIt->second;
-    int correct = (correctActions.find(playerName) != correctActions.end()) ? 
-                  correctActions.at(playerName) : 0;
+    int total = record->totalActions;
+    int correct = record->correctActions;
     int incorrect = total - correct;
     double accuracy = (static_cast<double>(correct) / total) * 100.0;
     
@@ -357,6 +281,8 @@ void BasicStrat::displayPlayerStats(const std::string& playerName) const {
     std::cout << "Incorrect Actions: " << incorrect << std::endl;
     std::cout << "Accuracy Rate: " << std::fixed << std::setprecision(1) 
               << accuracy << "%" << std::endl;
+    std::cout << "EV Lost to Deviations: " << std::setprecision(3) << getEVLost(playerName)
+              << " bets (" << getEVLost(playerName) / total * 100.0 << "% per decision)" << std::endl;
     
     if (accuracy >= 90.0) {
         std::cout << "Rating: EXCELLENT! You're following basic strategy very well!" << std::endl;
@@ -373,40 +299,41 @@ void BasicStrat::displayPlayerStats(const std::string& playerName) const {
 void BasicStrat::displayAllStats() const {
     std::cout << "\n======== BASIC STRATEGY OVERVIEW ========" << std::endl;
     
-    if (totalActions.empty()) {
-        std::cout << "No strategy data recorded yet." << std::endl;
-        std::cout << "=========================================" << std::endl;
-        return;
+    bool hasData = false;
+    for (PlayerId id = 0; id < static_cast<PlayerId>(playerRecords.size()); ++id) {
+        if (playerRecords[id].totalActions == 0) continue;
+        displayPlayerStats(registry->getName(id));
+        hasData = true;
     }
     
-    for (const auto& pair : totalActions) {
-        displayPlayerStats(pair.first);
+    if (!hasData) {
+        std::cout << "No strategy data recorded yet." << std::endl;
+        std::cout << "=========================================" << std::endl;
     }
 }
 
 void BasicStrat::resetStats() {
-    correctActions.clear();
-    totalActions.clear();
-    deviations.clear();
+    playerRecords.clear();
     std::cout << "Basic strategy statistics have been reset!" << std::endl;
 }
 
 double BasicStrat::getAccuracyRate(const std::string& playerName) const {
-    auto totalIt = totalActions.find(playerName);
-    if (totalIt == totalActions.end() || totalIt->second == 0) {
+    const StrategyRecord* record = findRecord(playerName);
+    if (!record) {
         return 0.0;
     }
     
-    int total = totalIt->second;
-    int correct = (correctActions.find(playerName) != correctActions.end()) ? 
-                  correctActions.at(playerName) : 0;
-    
-    return (static_cast<double>(correct) / total) * 100.0;
+    return (static_cast<double>(record->correctActions) / record->totalActions) * 100.0;
 }
 
 int BasicStrat::getDeviationCount(const std::string& playerName) const {
-    auto it = deviations.find(playerName);
-    return (it != deviations.end()) ? it->second : 0;
+    const StrategyRecord* record = findRecord(playerName);
+    return record ? record->deviations : 0;
+}
+
+double BasicStrat::getEVLost(const std::string& playerName) const {
+    const StrategyRecord* record = findRecord(playerName);
+    return record ? record->evLost : 0.0;
 }
 
 bool BasicStrat::isPlayerFollowingStrategy(const std::string& playerName, double threshold) const {
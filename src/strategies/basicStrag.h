@@ -2,57 +2,115 @@
 #define BASICSTRAT_H
 
 #include <string>
-#include <map>
+#include <memory>
+#include <vector>
+#include "TableRules.h"
+#include "StrategyTables.h"
+#include "IndexPlays.h"
+#include "EVAnalyzer.h"
+#include "PlayerRegistry.h"
 
 class Player;
 class Dealer;
 
-enum class Action {
-    HIT,
-    STAND,
-    DOUBLE,
-    SPLIT,
-    SURRENDER
-};
-
-enum class HandType {
-    HARD,    
-    SOFT,    
-    PAIR     
-};
 class BasicStrat {
 private:
-    // Strategy tables for different hand types
-    std::map<std::pair<int, int>, Action> hardTotalsTable;
-    std::map<std::pair<int, int>, Action> softTotalsTable;
-    std::map<std::pair<int, int>, Action> pairsTable;
+    TableRules rules;
+
+    // Compiled table for this rule set, picked from strategy_tables, or
+    // the one from loadStrategyTables()
+    const StrategyTable* table;
+    std::shared_ptr<const StrategyTable> loadedTable;
+
+    // Index plays from loadIndexTables(), for the systems the file covers
+    std::shared_ptr<const IndexTableSet> loadedIndices;
     
-    // Statistics tracking
-    std::map<std::string, int> correctActions;
-    std::map<std::string, int> totalActions;
-    std::map<std::string, int> deviations;
+    // Statistics tracking, one entry per PlayerId
+    struct StrategyRecord {
+        int correctActions;
+        int totalActions;
+        int deviations;
+        double evLost;      // units given up by deviating
+
+        StrategyRecord() : correctActions(0), totalActions(0), deviations(0), evLost(0.0) {}
+    };
+
+    std::shared_ptr<PlayerRegistry> registry;
+    std::vector<StrategyRecord> playerRecords;
+
+    const StrategyRecord* findRecord(const std::string& playerName) const;   // nullptr if no actions
+
+    EVAnalyzer evAnalyzer;
     
-    void initializeStrategyTables();
     HandType determineHandType(const Player& player) const;
     int getHandValue(const Player& player, HandType& handType) const;
     int getDealerUpValue(const Dealer& dealer) const;
     
 public:
-    BasicStrat();
+    explicit BasicStrat(const TableRules& tableRules = TableRules());
     
     // Strategy lookup
     Action getOptimalAction(const Player& player, const Dealer& dealer, 
-                           bool canDouble = true, bool canSurrender = true) const;
+                           bool canDouble = true, bool canSurrender = true,
+                           bool canSplit = true) const;
+
+    // Table lookup on an already classified hand. For PAIR, value is the
+    // card value of the pair (1-10); otherwise it is the hand total.
+    Action lookupAction(HandType handType, int value, int dealerUp,
+                        bool canDouble = true, bool canSurrender = true,
+                        bool canSplit = true) const;
+
+    // The same lookups with count-based deviations from `indices` applied
+    // at the given true count
+    Action getOptimalAction(const Player& player, const Dealer& dealer,
+                           const IndexTable& indices, double trueCount,
+                           bool canDouble = true, bool canSurrender = true,
+                           bool canSplit = true) const;
+    Action lookupAction(HandType handType, int value, int dealerUp,
+                        const IndexTable& indices, double trueCount,
+                        bool canDouble = true, bool canSurrender = true,
+                        bool canSplit = true) const;
     
+    // Replaces the compiled table with one written by bjstrat. Throws
+    // std::runtime_error if the file is unusable or for other rules.
+    void loadStrategyTables(const std::string& path);
+    const StrategyTable& getStrategyTable() const { return *table; }
+
+    // Replaces the built-in index plays with the ones written by bjindex,
+    // for every counting system in the file. Throws std::runtime_error
+    // like loadStrategyTables.
+    void loadIndexTables(const std::string& path);
+    // Indices for a counting system (a CountingSystem value): loaded ones
+    // if any, otherwise the built-in set for these rules
+    const IndexTable& getIndexTable(int system) const;
+
     // Player guidance
     std::string getActionString(Action action) const;
     void suggestAction(const Player& player, const Dealer& dealer,
                       bool canDouble = true, bool canSurrender = true) const;
     
-    // Statistics tracking
+    // Statistics tracking. A deviation is also graded by the EV it gives up,
+    // against the unseen composition when one is given and a full shoe
+    // minus the visible cards otherwise. With `indices` the correct play
+    // includes the index plays at `trueCount`. Double and surrender are only
+    // offered on two-card hands, and surrender only under late surrender.
     void recordPlayerAction(const std::string& playerName, const Player& player, 
                            const Dealer& dealer, Action takenAction,
-                           bool canDouble = true, bool canSurrender = true);
+                           bool canDouble = true, bool canSurrender = true, bool canSplit = true,
+                           const ShoeComposition* unseen = nullptr,
+                           const IndexTable* indices = nullptr, double trueCount = 0.0);
+    // The same for a player interned in the registry; throws
+    // std::out_of_range for an ID it never handed out
+    void recordPlayerAction(PlayerId id, const Player& player,
+                           const Dealer& dealer, Action takenAction,
+                           bool canDouble = true, bool canSurrender = true, bool canSplit = true,
+                           const ShoeComposition* unseen = nullptr,
+                           const IndexTable* indices = nullptr, double trueCount = 0.0);
+
+    // Player names are interned here; share the table's registry to record
+    // by PlayerId. Players already recorded keep their numbers.
+    void usePlayerRegistry(std::shared_ptr<PlayerRegistry> playerRegistry);
+    PlayerRegistry& getPlayerRegistry() const { return *registry; }
     
     // Display methods
     void displayStrategyTable(HandType handType) const;
@@ -63,6 +121,7 @@ public:
     // Analysis methods
     double getAccuracyRate(const std::string& playerName) const;
     int getDeviationCount(const std::string& playerName) const;
+    double getEVLost(const std::string& playerName) const;
     bool isPlayerFollowingStrategy(const std::string& playerName, double threshold = 0.8) const;
     
     // Configuration